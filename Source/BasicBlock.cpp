@@ -3,6 +3,10 @@
 #include "offsetof_def.h"
 #include "MipsJitter.h"
 #include "Jitter_CodeGenFactory.h"
+#include "Profiler.h"
+#include "BlockStats.h"
+#include <chrono>
+#include <memory>
 
 #if defined(AOT_BUILD_CACHE) || defined(AOT_USE_CACHE)
 #define AOT_ENABLED
@@ -74,22 +78,36 @@ void CBasicBlock::SetAotBlockOutputStream(Framework::CStdStream* outputStream)
 
 #endif
 
+//Blocks can be compiled from the EE and IOP threads concurrently, keep track of time per thread
+static thread_local uint64 g_threadCompileTime = 0;
+
+uint64 CBasicBlock::GetThreadCompileTime()
+{
+	return g_threadCompileTime;
+}
+
 void CBasicBlock::Compile()
 {
+#ifdef PROFILE
+	static const auto jitProfilerZone = CProfiler::GetInstance().RegisterZone("JIT");
+	CProfilerTraceZone profilerZone(jitProfilerZone);
+#endif
+
 #ifndef AOT_USE_CACHE
 
+	auto compileStartTime = std::chrono::steady_clock::now();
+
 	Framework::CMemStream stream;
 	{
-		static
-#ifdef AOT_BUILD_CACHE
-		    thread_local
-#endif
-		    CMipsJitter* jitter = nullptr;
-		if(jitter == nullptr)
+		//Blocks can be compiled from the EE and IOP threads concurrently
+		//Jitter is released when the thread exits
+		static thread_local std::unique_ptr<CMipsJitter> threadJitter;
+		if(!threadJitter)
 		{
 			Jitter::CCodeGen* codeGen = Jitter::CreateCodeGen();
-			jitter = new CMipsJitter(codeGen);
+			threadJitter = std::make_unique<CMipsJitter>(codeGen);
 		}
+		auto jitter = threadJitter.get();
 
 		jitter->GetCodeGen()->SetExternalSymbolReferencedHandler([&](auto symbol, auto offset, auto refType) { this->HandleExternalFunctionReference(symbol, offset, refType); });
 		jitter->SetStream(&stream);
@@ -100,6 +118,8 @@ void CBasicBlock::Compile()
 
 	m_function = CMemoryFunction(stream.GetBuffer(), stream.GetSize());
 
+	g_threadCompileTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - compileStartTime).count();
+
 #ifdef VTUNE_ENABLED
 	if(iJIT_IsProfilingActive() == iJIT_SAMPLING_ON)
 	{
@@ -215,6 +235,7 @@ void CBasicBlock::CompileRange(CMipsJitter* jitter)
 
 	CompileProlog(jitter);
 	jitter->MarkFirstBlockLabel();
+	CompileEntryCounter(jitter);
 
 	for(uint32 address = m_begin; address <= m_end; address += 4)
 	{
@@ -248,6 +269,14 @@ void CBasicBlock::CompileProlog(CMipsJitter* jitter)
 #endif
 }
 
+void CBasicBlock::CompileEntryCounter(CMipsJitter* jitter)
+{
+	//Placed after the first block label to also count iterations of blocks looping on themselves
+	if(!m_context.m_executor || !m_context.m_executor->GetBlockStats()) return;
+	jitter->PushCtx();
+	jitter->Call(reinterpret_cast<void*>(&CBlockStats::CountEntryHandler), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+}
+
 void CBasicBlock::CompileEpilog(CMipsJitter* jitter, bool loopsOnItself)
 {
 	//Update cycle quota
@@ -362,6 +391,26 @@ bool CBasicBlock::IsEmpty() const
 	       (m_end == MIPS_INVALID_PC);
 }
 
+uint32 CBasicBlock::GetCodeSize() const
+{
+#ifndef AOT_USE_CACHE
+	return static_cast<uint32>(m_function.GetSize());
+#else
+	return 0;
+#endif
+}
+
+BlockEntryPoint CBasicBlock::GetEntryPoint() const
+{
+#if defined(AOT_USE_CACHE)
+	return m_function;
+#elif defined(__EMSCRIPTEN__)
+	return nullptr;
+#else
+	return reinterpret_cast<BlockEntryPoint>(m_function.GetCodeRx());
+#endif
+}
+
 uint32 CBasicBlock::GetRecycleCount() const
 {
 	return m_recycleCount;
@@ -67,6 +67,14 @@ typedef std::multimap<uint32, BLOCK_OUT_LINK> BlockOutLinkMap;
 //to their outgoing link definitions inside the map
 typedef BlockOutLinkMap::iterator BlockOutLinkPointer;
 
+//Blocks can be entered through their native code pointer directly, without going through Execute.
+//Debug builds keep using Execute to check the state after each block.
+#if !defined(_DEBUG) && !defined(__EMSCRIPTEN__)
+#define BLOCK_DIRECT_DISPATCH
+#endif
+
+typedef void (*BlockEntryPoint)(void*);
+
 class CBasicBlock : public std::enable_shared_from_this<CBasicBlock>
 {
 public:
@@ -80,6 +88,8 @@ public:
 	uint32 GetEndAddress() const;
 	bool IsCompiled() const;
 	bool IsEmpty() const;
+	uint32 GetCodeSize() const;
+	BlockEntryPoint GetEntryPoint() const;
 
 	uint32 GetRecycleCount() const;
 	void SetRecycleCount(uint32);
@@ -97,6 +107,9 @@ public:
 
 	void CopyFunctionFrom(const std::shared_ptr<CBasicBlock>& basicBlock);
 
+	//Total time spent compiling blocks on the calling thread, in nanoseconds
+	static uint64 GetThreadCompileTime();
+
 protected:
 	uint32 m_begin;
 	uint32 m_end;
@@ -104,6 +117,7 @@ protected:
 	CMIPS& m_context;
 
 	virtual void CompileProlog(CMipsJitter*);
+	void CompileEntryCounter(CMipsJitter*);
 	virtual void CompileEpilog(CMipsJitter*, bool);
 
 private:
@@ -11,8 +11,9 @@ public:
 	BlockLookupOneWay(BlockType emptyBlock, uint32 maxAddress)
 	    : m_emptyBlock(emptyBlock)
 	{
+		assert(m_emptyBlock->IsCompiled());
 		m_tableSize = maxAddress / INSTRUCTION_SIZE;
-		m_blockTable = new BlockType[m_tableSize];
+		m_blockTable = new ENTRY[m_tableSize];
 	}
 
 	~BlockLookupOneWay()
@@ -24,28 +25,34 @@ public:
 	{
 		for(unsigned int i = 0; i < m_tableSize; i++)
 		{
-			m_blockTable[i] = m_emptyBlock;
+			m_blockTable[i] = {m_emptyBlock->GetEntryPoint(), m_emptyBlock};
 		}
 	}
 
 	void AddBlock(BlockType block)
 	{
 		uint32 address = block->GetBeginAddress();
-		assert(m_blockTable[address / INSTRUCTION_SIZE] == m_emptyBlock);
-		m_blockTable[address / INSTRUCTION_SIZE] = block;
+		assert(m_blockTable[address / INSTRUCTION_SIZE].block == m_emptyBlock);
+		m_blockTable[address / INSTRUCTION_SIZE] = {block->GetEntryPoint(), block};
 	}
 
 	void DeleteBlock(BlockType block)
 	{
 		uint32 address = block->GetBeginAddress();
-		assert(m_blockTable[address / INSTRUCTION_SIZE] != m_emptyBlock);
-		m_blockTable[address / INSTRUCTION_SIZE] = m_emptyBlock;
+		assert(m_blockTable[address / INSTRUCTION_SIZE].block != m_emptyBlock);
+		m_blockTable[address / INSTRUCTION_SIZE] = {m_emptyBlock->GetEntryPoint(), m_emptyBlock};
 	}
 
 	BlockType FindBlockAt(uint32 address) const
 	{
 		assert((address / INSTRUCTION_SIZE) < m_tableSize);
-		return m_blockTable[address / INSTRUCTION_SIZE];
+		return m_blockTable[address / INSTRUCTION_SIZE].block;
+	}
+
+	BlockEntryPoint FindEntryPointAt(uint32 address) const
+	{
+		assert((address / INSTRUCTION_SIZE) < m_tableSize);
+		return m_blockTable[address / INSTRUCTION_SIZE].entryPoint;
 	}
 
 private:
@@ -54,7 +61,14 @@ private:
 		INSTRUCTION_SIZE = 4,
 	};
 
+	//Entry point is stored alongside the block to dispatch with a single load
+	struct ENTRY
+	{
+		BlockEntryPoint entryPoint;
+		BlockType block;
+	};
+
 	BlockType m_emptyBlock = nullptr;
-	BlockType* m_blockTable = nullptr;
+	ENTRY* m_blockTable = nullptr;
 	uint32 m_tableSize = 0;
 };
@@ -12,10 +12,12 @@ public:
 	BlockLookupTwoWay(BlockType emptyBlock, uint32 maxAddress)
 	    : m_emptyBlock(emptyBlock)
 	{
+		assert(m_emptyBlock->IsCompiled());
+		m_emptyEntryPoint = m_emptyBlock->GetEntryPoint();
 		m_subTableCount = (maxAddress + SUBTABLE_MASK) / SUBTABLE_SIZE;
 		assert(m_subTableCount != 0);
-		m_blockTable = new BlockType*[m_subTableCount];
-		memset(m_blockTable, 0, sizeof(BlockType*) * m_subTableCount);
+		m_blockTable = new ENTRY*[m_subTableCount];
+		memset(m_blockTable, 0, sizeof(ENTRY*) * m_subTableCount);
 	}
 
 	~BlockLookupTwoWay()
@@ -54,14 +56,14 @@ public:
 		if(!subTable)
 		{
 			const uint32 subTableSize = SUBTABLE_SIZE / INSTRUCTION_SIZE;
-			subTable = new BlockType[subTableSize];
+			subTable = new ENTRY[subTableSize];
 			for(uint32 i = 0; i < subTableSize; i++)
 			{
-				subTable[i] = m_emptyBlock;
+				subTable[i] = {m_emptyEntryPoint, m_emptyBlock};
 			}
 		}
-		assert(subTable[loAddress / INSTRUCTION_SIZE] == m_emptyBlock);
-		subTable[loAddress / INSTRUCTION_SIZE] = block;
+		assert(subTable[loAddress / INSTRUCTION_SIZE].block == m_emptyBlock);
+		subTable[loAddress / INSTRUCTION_SIZE] = {block->GetEntryPoint(), block};
 	}
 
 	void DeleteBlock(BlockType block)
@@ -72,8 +74,8 @@ public:
 		assert(hiAddress < m_subTableCount);
 		auto& subTable = m_blockTable[hiAddress];
 		assert(subTable);
-		assert(subTable[loAddress / INSTRUCTION_SIZE] != m_emptyBlock);
-		subTable[loAddress / INSTRUCTION_SIZE] = m_emptyBlock;
+		assert(subTable[loAddress / INSTRUCTION_SIZE].block != m_emptyBlock);
+		subTable[loAddress / INSTRUCTION_SIZE] = {m_emptyEntryPoint, m_emptyBlock};
 	}
 
 	BlockType FindBlockAt(uint32 address) const
@@ -83,10 +85,20 @@ public:
 		assert(hiAddress < m_subTableCount);
 		auto& subTable = m_blockTable[hiAddress];
 		if(!subTable) return m_emptyBlock;
-		auto result = subTable[loAddress / INSTRUCTION_SIZE];
+		auto result = subTable[loAddress / INSTRUCTION_SIZE].block;
 		return result;
 	}
 
+	BlockEntryPoint FindEntryPointAt(uint32 address) const
+	{
+		uint32 hiAddress = address >> SUBTABLE_BITS;
+		uint32 loAddress = address & SUBTABLE_MASK;
+		assert(hiAddress < m_subTableCount);
+		auto& subTable = m_blockTable[hiAddress];
+		if(!subTable) return m_emptyEntryPoint;
+		return subTable[loAddress / INSTRUCTION_SIZE].entryPoint;
+	}
+
 private:
 	enum
 	{
@@ -96,7 +108,15 @@ private:
 		INSTRUCTION_SIZE = 4,
 	};
 
+	//Entry point is stored alongside the block to dispatch with a single load
+	struct ENTRY
+	{
+		BlockEntryPoint entryPoint;
+		BlockType block;
+	};
+
 	BlockType m_emptyBlock = nullptr;
-	BlockType** m_blockTable = nullptr;
+	BlockEntryPoint m_emptyEntryPoint = nullptr;
+	ENTRY** m_blockTable = nullptr;
 	uint32 m_subTableCount = 0;
 };
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <vector>
+#include "BlockStats.h"
+#include "MIPS.h"
+#include "MipsExecutor.h"
+#include "string_format.h"
+
+CBlockStats::CBlockStats(uint32 addressMask, uint32 recycleNoLinkThreshold)
+    : m_addressMask(addressMask)
+    , m_recycleNoLinkThreshold(recycleNoLinkThreshold)
+{
+}
+
+void CBlockStats::CountEntryHandler(CMIPS* context)
+{
+	//Blocks might outlive the stats if they were disabled after being compiled
+	auto blockStats = context->m_executor->GetBlockStats();
+	if(!blockStats) return;
+	blockStats->CountEntry(context->m_State.nPC);
+}
+
+void CBlockStats::CountEntry(uint32 address)
+{
+	address &= m_addressMask;
+	auto& block = m_blocks[address];
+	block.begin = address;
+	block.entryCount++;
+}
+
+void CBlockStats::RecordBlockCreation(uint32 begin, uint32 end, uint64 compileTime, uint32 codeSize, uint32 recycleCount)
+{
+	auto& block = m_blocks[begin];
+	block.begin = begin;
+	block.end = end;
+	block.createCount++;
+	//Blocks reused from an executor's cache don't need to be compiled
+	if(compileTime != 0)
+	{
+		block.compileCount++;
+		block.compileTime += compileTime;
+	}
+	block.codeSize = codeSize;
+	block.recycleCount = std::max(block.recycleCount, recycleCount);
+}
+
+void CBlockStats::RecordInvalidation(uint32 start, uint32 end, uint32 clearedBlockCount)
+{
+	uint32 page = start & ~(INVALIDATION_PAGE_SIZE - 1);
+	auto& invalidation = m_invalidations[page];
+	invalidation.eventCount++;
+	invalidation.clearedBlockCount += clearedBlockCount;
+}
+
+void CBlockStats::WriteReport(Framework::CStream& stream, CMIPS& context, const char* name, uint32 hotBlockCount) const
+{
+	auto writeLine =
+	    [&stream](const std::string& line) {
+		    stream.Write(line.c_str(), line.size());
+		    stream.Write("\n", 1);
+	    };
+
+	std::vector<const BLOCK*> blocks;
+	blocks.reserve(m_blocks.size());
+	uint64 totalEntryCount = 0;
+	uint64 totalCompileTime = 0;
+	uint64 totalCodeSize = 0;
+	uint32 totalCompileCount = 0;
+	uint32 noLinkBlockCount = 0;
+	for(const auto& blockPair : m_blocks)
+	{
+		const auto& block = blockPair.second;
+		blocks.push_back(&block);
+		totalEntryCount += block.entryCount;
+		totalCompileTime += block.compileTime;
+		totalCompileCount += block.compileCount;
+		totalCodeSize += block.codeSize;
+		if(block.recycleCount >= m_recycleNoLinkThreshold) noLinkBlockCount++;
+	}
+
+	std::sort(blocks.begin(), blocks.end(),
+	          [](const BLOCK* block1, const BLOCK* block2) { return block1->entryCount > block2->entryCount; });
+
+	writeLine(string_format("== %s ==", name));
+	writeLine(string_format("Blocks: %d, compiles: %d, compile time: %0.3fms, code size: %llu bytes, unlinked (recycled): %d, entries: %llu",
+	                        static_cast<uint32>(m_blocks.size()), totalCompileCount, static_cast<double>(totalCompileTime) / 1000000.0,
+	                        static_cast<unsigned long long>(totalCodeSize), noLinkBlockCount, static_cast<unsigned long long>(totalEntryCount)));
+	writeLine("");
+
+	writeLine("Hot blocks:");
+	uint32 reportedBlockCount = std::min<uint32>(hotBlockCount, static_cast<uint32>(blocks.size()));
+	for(uint32 i = 0; i < reportedBlockCount; i++)
+	{
+		const auto& block = *blocks[i];
+		double entryShare = (totalEntryCount != 0) ? (static_cast<double>(block.entryCount) * 100.0 / static_cast<double>(totalEntryCount)) : 0;
+		writeLine(string_format("#%d 0x%08X-0x%08X entries: %llu (%0.2f%%), creates: %d, compiles: %d, compile time: %0.3fms, code size: %d, recycles: %d%s",
+		                        i + 1, block.begin, block.end, static_cast<unsigned long long>(block.entryCount), entryShare,
+		                        block.createCount, block.compileCount, static_cast<double>(block.compileTime) / 1000000.0,
+		                        block.codeSize, block.recycleCount, (block.recycleCount >= m_recycleNoLinkThreshold) ? " (unlinked)" : ""));
+		//Disassembly reflects current memory contents, it might differ from what was compiled
+		if(block.end < block.begin) continue;
+		for(uint32 address = block.begin; address <= block.end; address += 4)
+		{
+			uint32 opcode = context.m_pMemoryMap->GetInstruction(address);
+			char mnemonic[256];
+			char operands[256];
+			context.m_pArch->GetInstructionMnemonic(&context, address, opcode, mnemonic, sizeof(mnemonic));
+			context.m_pArch->GetInstructionOperands(&context, address, opcode, operands, sizeof(operands));
+			writeLine(string_format("\t0x%08X: %08X %-12s %s", address, opcode, mnemonic, operands));
+		}
+	}
+	writeLine("");
+
+	std::vector<std::pair<uint32, INVALIDATION>> invalidations(m_invalidations.begin(), m_invalidations.end());
+	std::sort(invalidations.begin(), invalidations.end(),
+	          [](const auto& item1, const auto& item2) { return item1.second.eventCount > item2.second.eventCount; });
+
+	writeLine(string_format("Invalidations (per 0x%X bytes range):", INVALIDATION_PAGE_SIZE));
+	for(const auto& invalidationPair : invalidations)
+	{
+		const auto& invalidation = invalidationPair.second;
+		writeLine(string_format("0x%08X-0x%08X: %d invalidations, %d blocks cleared",
+		                        invalidationPair.first, invalidationPair.first + INVALIDATION_PAGE_SIZE - 1,
+		                        invalidation.eventCount, invalidation.clearedBlockCount));
+	}
+	writeLine("");
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include "Types.h"
+#include "Stream.h"
+
+class CMIPS;
+
+//Opt-in instrumentation of an executor's blocks: counts block entries and records compilation
+//and invalidation activity. Only accessed from the thread running the executor.
+class CBlockStats
+{
+public:
+	struct BLOCK
+	{
+		uint32 begin = 0;
+		uint32 end = 0;
+		uint64 entryCount = 0;
+		uint32 createCount = 0;
+		uint32 compileCount = 0;
+		uint64 compileTime = 0;
+		uint32 codeSize = 0;
+		uint32 recycleCount = 0;
+	};
+
+	struct INVALIDATION
+	{
+		uint32 eventCount = 0;
+		uint32 clearedBlockCount = 0;
+	};
+
+	enum
+	{
+		INVALIDATION_PAGE_SIZE = 0x1000,
+		DEFAULT_HOT_BLOCK_COUNT = 100,
+	};
+
+	CBlockStats(uint32, uint32);
+
+	//Called from generated code on every block entry
+	static void CountEntryHandler(CMIPS*);
+
+	void CountEntry(uint32);
+	void RecordBlockCreation(uint32, uint32, uint64, uint32, uint32);
+	void RecordInvalidation(uint32, uint32, uint32);
+
+	void WriteReport(Framework::CStream&, CMIPS&, const char*, uint32 = DEFAULT_HOT_BLOCK_COUNT) const;
+
+private:
+	typedef std::unordered_map<uint32, BLOCK> BlockMap;
+	typedef std::map<uint32, INVALIDATION> InvalidationMap;
+
+	uint32 m_addressMask = 0;
+	uint32 m_recycleNoLinkThreshold = 0;
+	BlockMap m_blocks;
+	InvalidationMap m_invalidations;
+};
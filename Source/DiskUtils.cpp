@@ -11,6 +11,7 @@
 #include "discimages/MdsDiscImage.h"
 #include "StdStream.h"
 #include "StdStreamUtils.h"
+#include "PtrStream.h"
 #include "StringUtils.h"
 #ifdef HAS_AMAZON_S3
 #include "s3stream/S3ObjectStream.h"
@@ -134,10 +135,17 @@ const DiskUtils::ExtensionList& DiskUtils::GetSupportedExtensions()
 	return extensionList;
 }
 
-DiskUtils::OpticalMediaPtr DiskUtils::CreateOpticalMediaFromPath(const fs::path& imagePath, uint32 opticalMediaCreateFlags)
+static bool IsTrackImagePath(const fs::path& imagePath)
 {
-	assert(!imagePath.empty());
+	//These formats describe their tracks and need to be handled by CreateOpticalMediaFrom*
+	auto extension = imagePath.extension().string();
+	return !stricmp(extension.c_str(), ".chd") ||
+	       !stricmp(extension.c_str(), ".cue") ||
+	       !stricmp(extension.c_str(), ".mds");
+}
 
+static std::shared_ptr<Framework::CStream> CreateDiscImageStream(const fs::path& imagePath)
+{
 	std::shared_ptr<Framework::CStream> stream;
 	auto extension = imagePath.extension().string();
 
@@ -146,22 +154,10 @@ DiskUtils::OpticalMediaPtr DiskUtils::CreateOpticalMediaFromPath(const fs::path&
 	{
 		stream = std::make_shared<CIszImageStream>(CreateImageStream(imagePath));
 	}
-	else if(!stricmp(extension.c_str(), ".chd"))
-	{
-		return CreateOpticalMediaFromChd(imagePath);
-	}
 	else if(!stricmp(extension.c_str(), ".cso"))
 	{
 		stream = std::make_shared<CCsoImageStream>(CreateImageStream(imagePath));
 	}
-	else if(!stricmp(extension.c_str(), ".cue"))
-	{
-		return CreateOpticalMediaFromCueSheet(imagePath);
-	}
-	else if(!stricmp(extension.c_str(), ".mds"))
-	{
-		return CreateOpticalMediaFromMds(imagePath);
-	}
 #ifdef _WIN32
 	else if(imagePath.string()[0] == '\\')
 	{
@@ -188,6 +184,94 @@ DiskUtils::OpticalMediaPtr DiskUtils::CreateOpticalMediaFromPath(const fs::path&
 		stream = std::shared_ptr<Framework::CStream>(CreateImageStream(imagePath));
 	}
 
+	return stream;
+}
+
+//Reads SYSTEM.CNF from the root directory, only touching the volume descriptor,
+//root directory and file sectors. Returns false if no ISO9660 volume was found.
+static bool TryReadSystemConfigData(ISO9660::CBlockProvider& blockProvider, std::string& systemConfigData)
+{
+	static const uint32 volumeDescriptorAddress = 0x10;
+	static const uint32 rootDirectoryRecordOffset = 156;
+	static const uint32 maxRootDirectoryBlockCount = 0x20;
+	static const uint32 maxSystemConfigSize = 0x1000;
+	static const char* systemConfigFileName = "SYSTEM.CNF";
+
+	uint8 block[ISO9660::CBlockProvider::BLOCKSIZE] = {};
+	auto read32 = [&block](uint32 offset) {
+		uint32 value = 0;
+		memcpy(&value, block + offset, sizeof(uint32));
+		return value;
+	};
+
+	blockProvider.ReadBlock(volumeDescriptorAddress, block);
+	if((block[0] != 0x01) || strncmp(reinterpret_cast<const char*>(block + 1), "CD001", 5))
+	{
+		return false;
+	}
+
+	uint32 rootDirectoryAddress = read32(rootDirectoryRecordOffset + 2);
+	uint32 rootDirectorySize = read32(rootDirectoryRecordOffset + 10);
+	uint32 rootDirectoryBlockCount = (rootDirectorySize + ISO9660::CBlockProvider::BLOCKSIZE - 1) / ISO9660::CBlockProvider::BLOCKSIZE;
+	rootDirectoryBlockCount = std::min(rootDirectoryBlockCount, maxRootDirectoryBlockCount);
+
+	size_t fileNameLength = strlen(systemConfigFileName);
+	for(uint32 blockIndex = 0; blockIndex < rootDirectoryBlockCount; blockIndex++)
+	{
+		blockProvider.ReadBlock(rootDirectoryAddress + blockIndex, block);
+		uint32 recordOffset = 0;
+		while(recordOffset < ISO9660::CBlockProvider::BLOCKSIZE)
+		{
+			//Records don't cross block boundaries, a 0 length means the rest of the block is padding
+			uint8 recordLength = block[recordOffset];
+			if(recordLength < 34) break;
+			if((recordOffset + recordLength) > ISO9660::CBlockProvider::BLOCKSIZE) break;
+
+			uint8 nameLength = block[recordOffset + 32];
+			auto name = reinterpret_cast<const char*>(block + recordOffset + 33);
+			if(
+			    (nameLength >= fileNameLength) && ((33U + nameLength) <= recordLength) &&
+			    !strnicmp(name, systemConfigFileName, fileNameLength) &&
+			    ((nameLength == fileNameLength) || (name[fileNameLength] == ';')))
+			{
+				uint32 fileAddress = read32(recordOffset + 2);
+				uint32 fileSize = std::min(read32(recordOffset + 10), maxSystemConfigSize);
+				systemConfigData.clear();
+				for(uint32 fileOffset = 0; fileOffset < fileSize; fileOffset += ISO9660::CBlockProvider::BLOCKSIZE)
+				{
+					blockProvider.ReadBlock(fileAddress + (fileOffset / ISO9660::CBlockProvider::BLOCKSIZE), block);
+					uint32 copySize = std::min<uint32>(fileSize - fileOffset, ISO9660::CBlockProvider::BLOCKSIZE);
+					systemConfigData.append(reinterpret_cast<const char*>(block), copySize);
+				}
+				return true;
+			}
+			recordOffset += recordLength;
+		}
+	}
+
+	systemConfigData.clear();
+	return true;
+}
+
+DiskUtils::OpticalMediaPtr DiskUtils::CreateOpticalMediaFromPath(const fs::path& imagePath, uint32 opticalMediaCreateFlags)
+{
+	assert(!imagePath.empty());
+
+	auto extension = imagePath.extension().string();
+	if(!stricmp(extension.c_str(), ".chd"))
+	{
+		return CreateOpticalMediaFromChd(imagePath);
+	}
+	else if(!stricmp(extension.c_str(), ".cue"))
+	{
+		return CreateOpticalMediaFromCueSheet(imagePath);
+	}
+	else if(!stricmp(extension.c_str(), ".mds"))
+	{
+		return CreateOpticalMediaFromMds(imagePath);
+	}
+
+	auto stream = CreateDiscImageStream(imagePath);
 	return COpticalMedia::CreateAuto(stream, opticalMediaCreateFlags);
 }
 
@@ -224,16 +308,52 @@ static std::string GetDiskIdFromPath(const std::string& filePath)
 	return regionCode + "-" + serial1 + serial2;
 }
 
+bool DiskUtils::TryGetSystemConfig(const fs::path& imagePath, SystemConfigMap* systemConfigPtr)
+{
+	try
+	{
+		std::string systemConfigData;
+		bool found = false;
+		if(IsTrackImagePath(imagePath))
+		{
+			auto opticalMedia = CreateOpticalMediaFromPath(imagePath, COpticalMedia::CREATE_AUTO_DISABLE_DL_DETECT);
+			found = TryReadSystemConfigData(*opticalMedia->GetTrackBlockProvider(0), systemConfigData);
+		}
+		else
+		{
+			//Avoid building a full COpticalMedia, we only need a few sectors
+			auto stream = CreateDiscImageStream(imagePath);
+			ISO9660::CBlockProvider2048 blockProvider(stream);
+			found = TryReadSystemConfigData(blockProvider, systemConfigData);
+			if(!found)
+			{
+				ISO9660::CBlockProviderCDROMXA blockProviderXa(stream);
+				found = TryReadSystemConfigData(blockProviderXa, systemConfigData);
+			}
+		}
+		if(!found || systemConfigData.empty()) return false;
+
+		Framework::CPtrStream systemConfigStream(systemConfigData.data(), systemConfigData.size());
+		auto systemConfig = ParseSystemConfigFile(&systemConfigStream);
+		if(systemConfigPtr)
+		{
+			(*systemConfigPtr) = std::move(systemConfig);
+		}
+		return true;
+	}
+	catch(const std::exception&)
+	{
+		return false;
+	}
+}
+
 bool DiskUtils::TryGetDiskId(const fs::path& imagePath, std::string* diskIdPtr)
 {
 	try
 	{
-		auto opticalMedia = CreateOpticalMediaFromPath(imagePath, COpticalMedia::CREATE_AUTO_DISABLE_DL_DETECT);
-		auto fileSystem = opticalMedia->GetFileSystem();
-		auto systemConfigFile = std::unique_ptr<Framework::CStream>(fileSystem->Open("SYSTEM.CNF;1"));
-		if(!systemConfigFile) return false;
+		SystemConfigMap systemConfig;
+		if(!TryGetSystemConfig(imagePath, &systemConfig)) return false;
 
-		auto systemConfig = ParseSystemConfigFile(systemConfigFile.get());
 		auto bootItemIterator = systemConfig.find("BOOT2");
 		if(bootItemIterator == std::end(systemConfig)) return false;
 
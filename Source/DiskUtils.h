@@ -17,5 +17,7 @@ namespace DiskUtils
 	OpticalMediaPtr CreateOpticalMediaFromPath(const fs::path&, uint32 = 0);
 	SystemConfigMap ParseSystemConfigFile(Framework::CStream*);
 
+	//Only reads the sectors needed to get SYSTEM.CNF
+	bool TryGetSystemConfig(const fs::path&, SystemConfigMap*);
 	bool TryGetDiskId(const fs::path&, std::string*);
 }
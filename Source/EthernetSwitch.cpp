@@ -0,0 +1,462 @@
+#include "EthernetSwitch.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include "StdStreamUtils.h"
+#include "string_format.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <Windows.h>
+#define ETHERNETSWITCH_SHARED_MEMORY_SUPPORTED 1
+#elif defined(__APPLE__)
+#include "TargetConditionals.h"
+#if !TARGET_OS_IPHONE
+#define ETHERNETSWITCH_SHARED_MEMORY_SUPPORTED 1
+#endif
+#elif !defined(__ANDROID__) && !defined(__SWITCH__) && !defined(__EMSCRIPTEN__)
+#define ETHERNETSWITCH_SHARED_MEMORY_SUPPORTED 1
+#endif
+
+#if defined(ETHERNETSWITCH_SHARED_MEMORY_SUPPORTED) && !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define STATE_MAGIC 0x48435753 //'SWCH'
+#define STATE_VERSION 1
+
+#define PCAP_MAGIC 0xA1B2C3D4
+#define PCAP_LINKTYPE_ETHERNET 1
+
+//All members must stay valid when mapped at different addresses in different processes
+struct CEthernetSwitch::SHARED_STATE
+{
+	struct FRAME
+	{
+		uint64 deliveryTime;
+		uint32 size;
+		uint8 data[MAX_FRAME_SIZE];
+	};
+
+	struct QUEUE_CELL
+	{
+		std::atomic<uint32> sequence;
+		FRAME frame;
+	};
+
+	struct PORT
+	{
+		std::atomic<uint32> attached;
+		std::atomic<uint32> enqueuePosition;
+		std::atomic<uint32> dequeuePosition;
+		std::atomic<uint64> droppedFrameCount;
+		QUEUE_CELL cells[PORT_QUEUE_SIZE];
+	};
+
+	uint32 magic;
+	uint32 version;
+	std::atomic<uint32> initialized;
+	std::atomic<uint32> latency;
+	std::atomic<uint64> bandwidth;
+	PORT ports[MAX_PORT_COUNT];
+};
+
+static_assert((CEthernetSwitch::PORT_QUEUE_SIZE & (CEthernetSwitch::PORT_QUEUE_SIZE - 1)) == 0, "Port queue size must be a power of 2.");
+
+CEthernetSwitch::CEthernetSwitch()
+    : m_localState(std::make_unique<SHARED_STATE>())
+{
+	m_state = m_localState.get();
+	InitializeState();
+}
+
+CEthernetSwitch::CEthernetSwitch(const std::string& name)
+{
+	OpenSharedMemory(name);
+}
+
+CEthernetSwitch::~CEthernetSwitch()
+{
+	StopCapture();
+	CloseSharedMemory();
+}
+
+bool CEthernetSwitch::IsSharedMemorySupported()
+{
+#ifdef ETHERNETSWITCH_SHARED_MEMORY_SUPPORTED
+	return true;
+#else
+	return false;
+#endif
+}
+
+CEthernetSwitch::PortPtr CEthernetSwitch::AttachPort()
+{
+	for(uint32 i = 0; i < MAX_PORT_COUNT; i++)
+	{
+		uint32 attached = 0;
+		if(m_state->ports[i].attached.compare_exchange_strong(attached, 1))
+		{
+			return std::make_unique<CPort>(shared_from_this(), i);
+		}
+	}
+	return PortPtr();
+}
+
+void CEthernetSwitch::SetLatency(uint32 latency)
+{
+	m_state->latency = latency;
+}
+
+void CEthernetSwitch::SetBandwidth(uint64 bandwidth)
+{
+	m_state->bandwidth = bandwidth;
+}
+
+void CEthernetSwitch::StartCapture(const fs::path& capturePath)
+{
+	std::lock_guard<std::mutex> captureLock(m_captureMutex);
+
+	auto captureStream = std::make_unique<Framework::CStdStream>(Framework::CreateOutputStdStream(capturePath.native()));
+	captureStream->Write32(PCAP_MAGIC);
+	captureStream->Write16(2); //Version major
+	captureStream->Write16(4); //Version minor
+	captureStream->Write32(0); //Time zone
+	captureStream->Write32(0); //Timestamp accuracy
+	captureStream->Write32(MAX_FRAME_SIZE);
+	captureStream->Write32(PCAP_LINKTYPE_ETHERNET);
+
+	m_captureStream = std::move(captureStream);
+	m_captureEnabled = true;
+}
+
+void CEthernetSwitch::StopCapture()
+{
+	std::lock_guard<std::mutex> captureLock(m_captureMutex);
+	m_captureEnabled = false;
+	m_captureStream.reset();
+}
+
+uint64 CEthernetSwitch::GetTimestamp()
+{
+	//steady_clock is system-wide, frame delivery times can be compared across processes
+	auto currentTime = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(currentTime).count();
+}
+
+CEthernetSwitch::MacAddress CEthernetSwitch::GetPortMacAddress(uint32 portIndex)
+{
+	//Locally administered addresses, based on the one in the default SMAP EEPROM
+	return {0x22, 0x11, 0x22, 0x11, 0x66, static_cast<uint8>(0x44 + portIndex)};
+}
+
+void CEthernetSwitch::InitializeState()
+{
+	m_state->magic = STATE_MAGIC;
+	m_state->version = STATE_VERSION;
+	for(auto& port : m_state->ports)
+	{
+		for(uint32 i = 0; i < PORT_QUEUE_SIZE; i++)
+		{
+			port.cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	m_state->initialized.store(1, std::memory_order_release);
+}
+
+void CEthernetSwitch::Forward(uint32 srcPortIndex, const uint8* frameData, uint32 frameSize, uint64 deliveryTime)
+{
+	if(m_captureEnabled.load(std::memory_order_relaxed))
+	{
+		CaptureFrame(frameData, frameSize);
+	}
+
+	if(frameSize < 6)
+	{
+		return;
+	}
+
+	//Unicast frames go to the port owning the destination address, others are flooded
+	bool isMulticast = (frameData[0] & 1) != 0;
+	if(!isMulticast)
+	{
+		for(uint32 i = 0; i < MAX_PORT_COUNT; i++)
+		{
+			if(i == srcPortIndex) continue;
+			auto macAddress = GetPortMacAddress(i);
+			if(memcmp(macAddress.data(), frameData, macAddress.size()) != 0) continue;
+			if(m_state->ports[i].attached.load(std::memory_order_relaxed) != 0)
+			{
+				EnqueueFrame(i, frameData, frameSize, deliveryTime);
+			}
+			return;
+		}
+	}
+
+	for(uint32 i = 0; i < MAX_PORT_COUNT; i++)
+	{
+		if(i == srcPortIndex) continue;
+		if(m_state->ports[i].attached.load(std::memory_order_relaxed) == 0) continue;
+		EnqueueFrame(i, frameData, frameSize, deliveryTime);
+	}
+}
+
+bool CEthernetSwitch::EnqueueFrame(uint32 dstPortIndex, const uint8* frameData, uint32 frameSize, uint64 deliveryTime)
+{
+	auto& port = m_state->ports[dstPortIndex];
+	uint32 position = port.enqueuePosition.load(std::memory_order_relaxed);
+	SHARED_STATE::QUEUE_CELL* cell = nullptr;
+	while(1)
+	{
+		cell = &port.cells[position & (PORT_QUEUE_SIZE - 1)];
+		uint32 sequence = cell->sequence.load(std::memory_order_acquire);
+		int32 difference = static_cast<int32>(sequence - position);
+		if(difference == 0)
+		{
+			if(port.enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if(difference < 0)
+		{
+			//Queue is full, receiver isn't keeping up
+			port.droppedFrameCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			position = port.enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+	cell->frame.deliveryTime = deliveryTime;
+	cell->frame.size = frameSize;
+	memcpy(cell->frame.data, frameData, frameSize);
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+void CEthernetSwitch::CaptureFrame(const uint8* frameData, uint32 frameSize)
+{
+	auto currentTime = std::chrono::system_clock::now().time_since_epoch();
+	auto currentTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(currentTime).count();
+
+	std::lock_guard<std::mutex> captureLock(m_captureMutex);
+	if(!m_captureStream) return;
+	m_captureStream->Write32(static_cast<uint32>(currentTimeUs / 1000000));
+	m_captureStream->Write32(static_cast<uint32>(currentTimeUs % 1000000));
+	m_captureStream->Write32(frameSize);
+	m_captureStream->Write32(frameSize);
+	m_captureStream->Write(frameData, frameSize);
+}
+
+#ifdef ETHERNETSWITCH_SHARED_MEMORY_SUPPORTED
+
+static_assert(std::atomic<uint64>::is_always_lock_free, "Shared memory Ethernet switches require lock-free 64-bit atomics.");
+
+void CEthernetSwitch::OpenSharedMemory(const std::string& name)
+{
+	size_t stateSize = sizeof(SHARED_STATE);
+	void* memory = nullptr;
+#ifdef _WIN32
+	auto mappingName = "Local\\Play_EthernetSwitch_" + name;
+	HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, static_cast<DWORD>(stateSize), mappingName.c_str());
+	if(mapping == NULL)
+	{
+		throw std::runtime_error(string_format("Failed to create shared memory for Ethernet switch '%s'.", name.c_str()));
+	}
+	m_sharedMemoryOwner = (GetLastError() != ERROR_ALREADY_EXISTS);
+	memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, stateSize);
+	if(memory == NULL)
+	{
+		CloseHandle(mapping);
+		throw std::runtime_error(string_format("Failed to map shared memory for Ethernet switch '%s'.", name.c_str()));
+	}
+	m_sharedMemoryHandle = mapping;
+#else
+	//Keep the name short, macOS limits shared memory names to 31 characters
+	auto mappingName = "/PlayEth_" + name;
+	int fd = shm_open(mappingName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	m_sharedMemoryOwner = (fd != -1);
+	if(fd == -1)
+	{
+		fd = shm_open(mappingName.c_str(), O_RDWR, 0600);
+	}
+	if(fd == -1)
+	{
+		throw std::runtime_error(string_format("Failed to open shared memory for Ethernet switch '%s'.", name.c_str()));
+	}
+	if(m_sharedMemoryOwner)
+	{
+		if(ftruncate(fd, stateSize) == -1)
+		{
+			close(fd);
+			shm_unlink(mappingName.c_str());
+			throw std::runtime_error(string_format("Failed to size shared memory for Ethernet switch '%s'.", name.c_str()));
+		}
+	}
+	else
+	{
+		//Owner might not have sized the segment yet
+		struct stat fileStat = {};
+		for(uint32 i = 0; (fstat(fd, &fileStat) == 0) && (static_cast<size_t>(fileStat.st_size) < stateSize) && (i < 1000); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		if(static_cast<size_t>(fileStat.st_size) < stateSize)
+		{
+			close(fd);
+			throw std::runtime_error(string_format("Shared memory for Ethernet switch '%s' has an unexpected size.", name.c_str()));
+		}
+	}
+	memory = mmap(nullptr, stateSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(memory == MAP_FAILED)
+	{
+		if(m_sharedMemoryOwner) shm_unlink(mappingName.c_str());
+		throw std::runtime_error(string_format("Failed to map shared memory for Ethernet switch '%s'.", name.c_str()));
+	}
+#endif
+	m_sharedMemoryName = mappingName;
+	m_state = reinterpret_cast<SHARED_STATE*>(memory);
+
+	if(m_sharedMemoryOwner)
+	{
+		new(m_state) SHARED_STATE();
+		InitializeState();
+	}
+	else
+	{
+		for(uint32 i = 0; (m_state->initialized.load(std::memory_order_acquire) == 0) && (i < 1000); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		if((m_state->initialized.load(std::memory_order_acquire) == 0) ||
+		   (m_state->magic != STATE_MAGIC) || (m_state->version != STATE_VERSION))
+		{
+			CloseSharedMemory();
+			throw std::runtime_error(string_format("Shared memory for Ethernet switch '%s' is not valid.", name.c_str()));
+		}
+	}
+}
+
+void CEthernetSwitch::CloseSharedMemory()
+{
+	if(m_sharedMemoryName.empty()) return;
+#ifdef _WIN32
+	UnmapViewOfFile(m_state);
+	CloseHandle(m_sharedMemoryHandle);
+	m_sharedMemoryHandle = nullptr;
+#else
+	munmap(m_state, sizeof(SHARED_STATE));
+	if(m_sharedMemoryOwner)
+	{
+		//Other processes keep their mapping, new ones will create a fresh switch
+		shm_unlink(m_sharedMemoryName.c_str());
+	}
+#endif
+	m_state = nullptr;
+	m_sharedMemoryName.clear();
+}
+
+#else
+
+void CEthernetSwitch::OpenSharedMemory(const std::string&)
+{
+	throw std::runtime_error("Shared memory Ethernet switches are not supported on this platform.");
+}
+
+void CEthernetSwitch::CloseSharedMemory()
+{
+}
+
+#endif
+
+CEthernetSwitch::CPort::CPort(std::shared_ptr<CEthernetSwitch> ethernetSwitch, uint32 index)
+    : m_switch(std::move(ethernetSwitch))
+    , m_index(index)
+{
+	//Discard anything left over from a previous owner of this port
+	std::vector<uint8> frame;
+	while(TryReceive(frame))
+	{
+	}
+}
+
+CEthernetSwitch::CPort::~CPort()
+{
+	m_switch->m_state->ports[m_index].attached.store(0, std::memory_order_release);
+}
+
+uint32 CEthernetSwitch::CPort::GetIndex() const
+{
+	return m_index;
+}
+
+CEthernetSwitch::MacAddress CEthernetSwitch::CPort::GetMacAddress() const
+{
+	return GetPortMacAddress(m_index);
+}
+
+uint64 CEthernetSwitch::CPort::GetDroppedFrameCount() const
+{
+	return m_switch->m_state->ports[m_index].droppedFrameCount.load(std::memory_order_relaxed);
+}
+
+void CEthernetSwitch::CPort::Send(const uint8* frameData, uint32 frameSize)
+{
+	auto state = m_switch->m_state;
+	if(frameSize > MAX_FRAME_SIZE)
+	{
+		state->ports[m_index].droppedFrameCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	uint64 latency = state->latency.load(std::memory_order_relaxed);
+	uint64 bandwidth = state->bandwidth.load(std::memory_order_relaxed);
+	uint64 deliveryTime = 0;
+	if((latency != 0) || (bandwidth != 0))
+	{
+		//Frames leave this port one after the other at the configured rate
+		//Send can be called concurrently, the transmission slot is reserved atomically
+		uint64 currentTime = GetTimestamp();
+		uint64 txDuration = (bandwidth != 0) ? (static_cast<uint64>(frameSize) * 8 * 1000000) / bandwidth : 0;
+		uint64 nextTxTime = m_nextTxTime.load(std::memory_order_relaxed);
+		uint64 txEndTime = 0;
+		do
+		{
+			uint64 txStartTime = std::max(currentTime, nextTxTime);
+			txEndTime = txStartTime + txDuration;
+		} while(!m_nextTxTime.compare_exchange_weak(nextTxTime, txEndTime, std::memory_order_relaxed));
+		deliveryTime = txEndTime + latency;
+	}
+
+	m_switch->Forward(m_index, frameData, frameSize, deliveryTime);
+}
+
+bool CEthernetSwitch::CPort::TryReceive(std::vector<uint8>& frame)
+{
+	auto& port = m_switch->m_state->ports[m_index];
+	uint32 position = port.dequeuePosition.load(std::memory_order_relaxed);
+	auto& cell = port.cells[position & (PORT_QUEUE_SIZE - 1)];
+	uint32 sequence = cell.sequence.load(std::memory_order_acquire);
+	if(sequence != (position + 1))
+	{
+		return false;
+	}
+	if((cell.frame.deliveryTime != 0) && (cell.frame.deliveryTime > GetTimestamp()))
+	{
+		return false;
+	}
+	frame.assign(cell.frame.data, cell.frame.data + cell.frame.size);
+	port.dequeuePosition.store(position + 1, std::memory_order_relaxed);
+	cell.sequence.store(position + PORT_QUEUE_SIZE, std::memory_order_release);
+	return true;
+}
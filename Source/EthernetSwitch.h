@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "filesystem_def.h"
+#include "Types.h"
+#include "StdStream.h"
+
+//Virtual Ethernet switch linking the SMAP adapters of several VM instances.
+//Frames travel through lock-free queues that either live in process memory
+//or in a named shared memory segment for instances running in other processes.
+class CEthernetSwitch : public std::enable_shared_from_this<CEthernetSwitch>
+{
+public:
+	enum
+	{
+		MAX_PORT_COUNT = 8,
+		MAX_FRAME_SIZE = 0x600,
+		PORT_QUEUE_SIZE = 64,
+	};
+
+	typedef std::array<uint8, 6> MacAddress;
+
+	class CPort
+	{
+	public:
+		CPort(std::shared_ptr<CEthernetSwitch>, uint32);
+		~CPort();
+
+		uint32 GetIndex() const;
+		MacAddress GetMacAddress() const;
+		uint64 GetDroppedFrameCount() const;
+
+		//Can be called from any thread
+		void Send(const uint8*, uint32);
+
+		//Must only be called by the thread owning this port
+		bool TryReceive(std::vector<uint8>&);
+
+	private:
+		std::shared_ptr<CEthernetSwitch> m_switch;
+		uint32 m_index = 0;
+		std::atomic<uint64> m_nextTxTime = 0;
+	};
+	typedef std::unique_ptr<CPort> PortPtr;
+
+	//Creates a switch only visible to this process
+	CEthernetSwitch();
+
+	//Creates or opens a switch shared with other processes using the same name
+	CEthernetSwitch(const std::string&);
+
+	virtual ~CEthernetSwitch();
+
+	static bool IsSharedMemorySupported();
+
+	PortPtr AttachPort();
+
+	void SetLatency(uint32);
+	void SetBandwidth(uint64);
+
+	void StartCapture(const fs::path&);
+	void StopCapture();
+
+private:
+	struct SHARED_STATE;
+
+	static uint64 GetTimestamp();
+	static MacAddress GetPortMacAddress(uint32);
+
+	void InitializeState();
+	void Forward(uint32, const uint8*, uint32, uint64);
+	bool EnqueueFrame(uint32, const uint8*, uint32, uint64);
+	void CaptureFrame(const uint8*, uint32);
+
+	void OpenSharedMemory(const std::string&);
+	void CloseSharedMemory();
+
+	SHARED_STATE* m_state = nullptr;
+	std::unique_ptr<SHARED_STATE> m_localState;
+
+	std::string m_sharedMemoryName;
+	bool m_sharedMemoryOwner = false;
+#ifdef _WIN32
+	void* m_sharedMemoryHandle = nullptr;
+#endif
+
+	std::atomic<bool> m_captureEnabled = false;
+	std::mutex m_captureMutex;
+	std::unique_ptr<Framework::CStdStream> m_captureStream;
+};
@@ -1,11 +1,20 @@
 #include "FrameLimiter.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
 #endif
 
+//Margin kept between the estimated end of a late latched frame and its deadline
+static const auto g_lateLatchMargin = std::chrono::microseconds(1000);
+//Frames ending later than this past their deadline are counted as late
+static const auto g_lateFrameThreshold = std::chrono::microseconds(1000);
+static const auto g_minSpinThreshold = std::chrono::microseconds(100);
+static const auto g_maxSpinThreshold = std::chrono::microseconds(4000);
+
 CFrameLimiter::CFrameLimiter()
 {
 #ifdef _WIN32
@@ -27,7 +36,13 @@ CFrameLimiter::~CFrameLimiter()
 void CFrameLimiter::BeginFrame()
 {
 	assert(!m_frameStarted);
-	m_lastFrameTime = std::chrono::high_resolution_clock::now();
+	if(m_lateLatchEnabled && m_hasDeadline)
+	{
+		//Use the longest recent frame as an estimate of how long this one will take
+		auto estimatedFrameDuration = *std::max_element(std::begin(m_frameTimes), std::end(m_frameTimes));
+		Wait(m_nextDeadline - estimatedFrameDuration - g_lateLatchMargin);
+	}
+	m_frameStartTime = GetTime();
 	m_frameStarted = true;
 }
 
@@ -37,57 +52,167 @@ void CFrameLimiter::EndFrame()
 
 	//Add current frame time to array
 	{
-		auto currentFrameTime = std::chrono::high_resolution_clock::now();
-		auto frameDuration = std::chrono::duration_cast<std::chrono::microseconds>(currentFrameTime - m_lastFrameTime);
+		auto currentFrameTime = GetTime();
+		auto frameDuration = std::chrono::duration_cast<std::chrono::microseconds>(currentFrameTime - m_frameStartTime);
 		m_frameTimes[m_frameTimeIndex++] = frameDuration;
 		m_frameTimeIndex %= MAX_FRAMETIMES;
+		m_lastFrameDuration = frameDuration;
 	}
 
-	//Compute average frame time
-	std::chrono::microseconds averageFrameTime = std::chrono::microseconds(0);
-	for(uint32 i = 0; i < MAX_FRAMETIMES; i++)
+	m_frameStarted = false;
+
+	if(m_minFrameDuration == Clock::duration::zero())
 	{
-		averageFrameTime += m_frameTimes[i];
+		m_hasDeadline = false;
+		return;
 	}
-	averageFrameTime /= MAX_FRAMETIMES;
 
-	if(averageFrameTime < m_minFrameDuration)
+	if(!m_hasDeadline)
 	{
-		auto delay = m_minFrameDuration - averageFrameTime;
-#ifdef _WIN32
-		{
-			LARGE_INTEGER ft = {};
-			ft.QuadPart = -static_cast<int64>(delay.count() * 10);
+		m_nextDeadline = m_frameStartTime + m_minFrameDuration;
+		m_lastFrameEndTime = m_frameStartTime;
+		m_hasDeadline = true;
+	}
 
-			HANDLE timer = CreateWaitableTimer(NULL, TRUE, NULL);
-			SetWaitableTimer(timer, &ft, 0, NULL, NULL, 0);
-			WaitForSingleObject(timer, INFINITE);
-			CloseHandle(timer);
-		}
-#elif defined(__APPLE__)
-		//Sleeping for the whole delay on macOS/iOS doesn't provide a good enough resolution
-		auto currentTime = std::chrono::high_resolution_clock::now();
-		auto targetTime = currentTime + delay;
-		while(currentTime < targetTime)
-		{
-			std::this_thread::sleep_for(std::chrono::microseconds(250));
-			currentTime = std::chrono::high_resolution_clock::now();
-		}
-#else
-		std::this_thread::sleep_for(delay);
-#endif
+	auto deadline = m_nextDeadline;
+	Wait(deadline);
+	auto frameEndTime = GetTime();
+
+	UpdatePacingStats(deadline, frameEndTime);
+	if(m_frameEndHandler)
+	{
+		m_frameEndHandler(deadline, frameEndTime);
 	}
-	m_frameStarted = false;
+
+	//Keep following the same schedule, unless we're too late to catch up without
+	//running a burst of unpaced frames
+	m_nextDeadline += m_minFrameDuration;
+	if((frameEndTime - m_nextDeadline) > (m_minFrameDuration * MAX_LATE_FRAMES))
+	{
+		m_nextDeadline = frameEndTime + m_minFrameDuration;
+	}
+	m_lastFrameEndTime = frameEndTime;
 }
 
 void CFrameLimiter::SetFrameRate(uint32 fps)
 {
 	if(fps == 0)
 	{
-		m_minFrameDuration = std::chrono::microseconds(0);
+		m_minFrameDuration = Clock::duration::zero();
+	}
+	else
+	{
+		m_minFrameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1000000000 / fps));
+	}
+	m_hasDeadline = false;
+}
+
+void CFrameLimiter::SetLateLatchEnabled(bool lateLatchEnabled)
+{
+	m_lateLatchEnabled = lateLatchEnabled;
+}
+
+void CFrameLimiter::SetFrameEndHandler(const FrameEndHandler& frameEndHandler)
+{
+	m_frameEndHandler = frameEndHandler;
+}
+
+void CFrameLimiter::SetTimeFunctions(const TimeFunction& timeFunction, const WaitFunction& waitFunction)
+{
+	m_timeFunction = timeFunction;
+	m_waitFunction = waitFunction;
+	m_hasDeadline = false;
+}
+
+std::chrono::microseconds CFrameLimiter::GetLastFrameDuration() const
+{
+	return m_lastFrameDuration;
+}
+
+std::chrono::microseconds CFrameLimiter::GetMinFrameDuration() const
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(m_minFrameDuration);
+}
+
+CFrameLimiter::PACING_STATS CFrameLimiter::GetPacingStats() const
+{
+	return m_pacingStats;
+}
+
+void CFrameLimiter::ResetPacingStats()
+{
+	m_pacingStats = PACING_STATS();
+}
+
+CFrameLimiter::TimePoint CFrameLimiter::GetTime() const
+{
+	return m_timeFunction ? m_timeFunction() : Clock::now();
+}
+
+void CFrameLimiter::Wait(TimePoint targetTime)
+{
+	if(m_waitFunction)
+	{
+		m_waitFunction(targetTime);
 	}
 	else
 	{
-		m_minFrameDuration = std::chrono::microseconds(1000000 / fps);
+		WaitUntil(targetTime);
+	}
+}
+
+void CFrameLimiter::WaitUntil(TimePoint targetTime)
+{
+	while(1)
+	{
+		auto currentTime = Clock::now();
+		if(currentTime >= targetTime) break;
+		auto remainingTime = targetTime - currentTime;
+		if(remainingTime > m_spinThreshold)
+		{
+			auto sleepTime = remainingTime - m_spinThreshold;
+			SleepFor(sleepTime);
+			//Adjust spin threshold to the sleep accuracy we get, slowly forget large oversleeps
+			auto oversleepTime = (Clock::now() - currentTime) - sleepTime;
+			m_spinThreshold = std::max<Clock::duration>(oversleepTime + g_minSpinThreshold, (m_spinThreshold * 7) / 8);
+			m_spinThreshold = std::clamp<Clock::duration>(m_spinThreshold, g_minSpinThreshold, g_maxSpinThreshold);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void CFrameLimiter::SleepFor(Clock::duration delay)
+{
+#ifdef _WIN32
+	LARGE_INTEGER ft = {};
+	ft.QuadPart = -static_cast<int64>(std::chrono::duration_cast<std::chrono::microseconds>(delay).count() * 10);
+
+	HANDLE timer = CreateWaitableTimer(NULL, TRUE, NULL);
+	SetWaitableTimer(timer, &ft, 0, NULL, NULL, 0);
+	WaitForSingleObject(timer, INFINITE);
+	CloseHandle(timer);
+#else
+	std::this_thread::sleep_for(delay);
+#endif
+}
+
+void CFrameLimiter::UpdatePacingStats(TimePoint deadline, TimePoint frameEndTime)
+{
+	auto deadlineError = std::chrono::duration_cast<std::chrono::microseconds>(frameEndTime - deadline).count();
+	auto interval = frameEndTime - m_lastFrameEndTime;
+	auto intervalError = std::chrono::duration_cast<std::chrono::microseconds>(interval - m_minFrameDuration).count();
+
+	auto& stats = m_pacingStats;
+	stats.frameCount++;
+	if(frameEndTime >= (deadline + g_lateFrameThreshold))
+	{
+		stats.lateFrameCount++;
 	}
+	stats.intervalErrorSum += intervalError;
+	stats.intervalErrorSquaredSum += intervalError * intervalError;
+	stats.maxIntervalError = std::max<int64>(stats.maxIntervalError, std::abs(intervalError));
+	stats.maxDeadlineError = std::max<int64>(stats.maxDeadlineError, deadlineError);
 }
@@ -1,11 +1,35 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include "Types.h"
 
+//Paces frames against a fixed schedule of deadlines derived from the emulated frame rate.
+//Deadlines are advanced by exactly one frame duration each frame, which keeps the average
+//frame rate locked to the emulated vblank rate instead of drifting with wait inaccuracies.
 class CFrameLimiter
 {
 public:
+	typedef std::chrono::steady_clock Clock;
+	typedef Clock::time_point TimePoint;
+
+	//Called with the deadline and the actual end time of every paced frame
+	typedef std::function<void(TimePoint, TimePoint)> FrameEndHandler;
+
+	typedef std::function<TimePoint()> TimeFunction;
+	typedef std::function<void(TimePoint)> WaitFunction;
+
+	//All times are in microseconds. Intervals are measured between the end of consecutive frames.
+	struct PACING_STATS
+	{
+		uint32 frameCount = 0;
+		uint32 lateFrameCount = 0;
+		int64 intervalErrorSum = 0;
+		int64 intervalErrorSquaredSum = 0;
+		int64 maxIntervalError = 0;
+		int64 maxDeadlineError = 0;
+	};
+
 	CFrameLimiter();
 	~CFrameLimiter();
 
@@ -14,18 +38,58 @@ public:
 
 	void SetFrameRate(uint32);
 
-private:
-	typedef std::chrono::high_resolution_clock::time_point TimePoint;
+	//Delays the start of a frame so that it ends just before its deadline, this
+	//reduces the time between the moment inputs are read and the moment the frame is presented.
+	//Only inputs read during the frame benefit from this, not the ones sampled before BeginFrame.
+	void SetLateLatchEnabled(bool);
+
+	void SetFrameEndHandler(const FrameEndHandler&);
+
+	//Replaces the clock and the wait used for pacing (ie.: to run on a simulated clock).
+	//Wait functions must return once the time function reaches the requested time.
+	void SetTimeFunctions(const TimeFunction&, const WaitFunction&);
 
+	std::chrono::microseconds GetLastFrameDuration() const;
+	std::chrono::microseconds GetMinFrameDuration() const;
+
+	PACING_STATS GetPacingStats() const;
+	void ResetPacingStats();
+
+private:
 	enum
 	{
 		MAX_FRAMETIMES = 4,
+
+		//If we're this many frames late, give up catching up and restart the schedule from the current time
+		MAX_LATE_FRAMES = 2,
 	};
 
+	TimePoint GetTime() const;
+	void Wait(TimePoint);
+	void WaitUntil(TimePoint);
+	void SleepFor(Clock::duration);
+	void UpdatePacingStats(TimePoint, TimePoint);
+
 	std::chrono::microseconds m_frameTimes[MAX_FRAMETIMES];
 	uint32 m_frameTimeIndex = 0;
+	std::chrono::microseconds m_lastFrameDuration = std::chrono::microseconds(0);
 
-	std::chrono::microseconds m_minFrameDuration = std::chrono::microseconds(0);
+	Clock::duration m_minFrameDuration = Clock::duration::zero();
 	bool m_frameStarted = false;
-	TimePoint m_lastFrameTime;
+	TimePoint m_frameStartTime;
+
+	bool m_hasDeadline = false;
+	TimePoint m_nextDeadline;
+	TimePoint m_lastFrameEndTime;
+
+	bool m_lateLatchEnabled = false;
+
+	//Sleeping is only used until we get close enough to the target time, the rest is
+	//spent spinning. The threshold follows the largest oversleep we've seen recently.
+	Clock::duration m_spinThreshold = std::chrono::milliseconds(1);
+
+	FrameEndHandler m_frameEndHandler;
+	TimeFunction m_timeFunction;
+	WaitFunction m_waitFunction;
+	PACING_STATS m_pacingStats;
 };
@@ -0,0 +1,37 @@
+#include <algorithm>
+#include "FrameSkipper.h"
+
+void CFrameSkipper::Reset()
+{
+	m_lag = std::chrono::microseconds(0);
+	m_consecutiveSkips = 0;
+}
+
+void CFrameSkipper::SetMaxConsecutiveSkips(uint32 maxConsecutiveSkips)
+{
+	m_maxConsecutiveSkips = maxConsecutiveSkips;
+}
+
+bool CFrameSkipper::ProcessFrame(std::chrono::microseconds frameDuration, std::chrono::microseconds targetFrameDuration)
+{
+	//Frame rate isn't limited, we can never fall behind
+	if(targetFrameDuration.count() == 0)
+	{
+		Reset();
+		return true;
+	}
+
+	//Don't let lag accumulate indefinitely, otherwise we would keep skipping frames long after
+	//a heavy scene is over
+	m_lag += frameDuration - targetFrameDuration;
+	m_lag = std::clamp(m_lag, std::chrono::microseconds(0), targetFrameDuration * MAX_LAG_FRAMES);
+
+	if((m_lag >= targetFrameDuration) && (m_consecutiveSkips < m_maxConsecutiveSkips))
+	{
+		m_consecutiveSkips++;
+		return false;
+	}
+
+	m_consecutiveSkips = 0;
+	return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include "Types.h"
+
+//Decides which frames can be skipped when the host can't keep up with the emulated frame rate.
+//Time spent over the target frame duration is accumulated and frames are skipped while the
+//accumulated lag is larger than a whole frame.
+class CFrameSkipper
+{
+public:
+	enum
+	{
+		DEFAULT_MAX_CONSECUTIVE_SKIPS = 3,
+	};
+
+	void Reset();
+
+	void SetMaxConsecutiveSkips(uint32);
+
+	//Returns true if the next frame needs to be rendered
+	bool ProcessFrame(std::chrono::microseconds, std::chrono::microseconds);
+
+private:
+	enum
+	{
+		MAX_LAG_FRAMES = 4,
+	};
+
+	std::chrono::microseconds m_lag = std::chrono::microseconds(0);
+	uint32 m_consecutiveSkips = 0;
+	uint32 m_maxConsecutiveSkips = DEFAULT_MAX_CONSECUTIVE_SKIPS;
+};
@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include "MIPS.h"
 #include "BasicBlock.h"
+#include "BlockStats.h"
 
 #include "BlockLookupOneWay.h"
 #include "BlockLookupTwoWay.h"
@@ -33,14 +34,13 @@ public:
 	};
 
 	CGenericMipsExecutor(CMIPS& context, uint32 maxAddress, BLOCK_CATEGORY blockCategory)
-	    : m_emptyBlock(std::make_shared<CBasicBlock>(context, MIPS_INVALID_PC, MIPS_INVALID_PC, blockCategory))
+	    : m_emptyBlock(CreateEmptyBlock(context, blockCategory))
 	    , m_context(context)
 	    , m_maxAddress(maxAddress)
 	    , m_addressMask(maxAddress - 1)
 	    , m_blockCategory(blockCategory)
 	    , m_blockLookup(m_emptyBlock.get(), maxAddress)
 	{
-		m_emptyBlock->Compile();
 		ResetBlockOutLinks(m_emptyBlock.get());
 
 		assert(!context.m_emptyBlockHandler);
@@ -66,8 +66,13 @@ public:
 		while(m_context.m_State.nHasException == 0)
 		{
 			uint32 address = m_context.m_State.nPC & m_addressMask;
+#ifdef BLOCK_DIRECT_DISPATCH
+			auto entryPoint = m_blockLookup.FindEntryPointAt(address);
+			entryPoint(&m_context);
+#else
 			auto block = m_blockLookup.FindBlockAt(address);
 			block->Execute();
+#endif
 		}
 		m_context.m_State.nHasException &= ~MIPS_EXCEPTION_STATUS_QUOTADONE;
 #ifdef DEBUGGER_INCLUDED
@@ -107,6 +112,16 @@ public:
 		ClearActiveBlocksInRangeInternal(start, end, currentBlock);
 	}
 
+	void SetBlockStatsEnabled(bool enabled) override
+	{
+		m_blockStats = enabled ? std::make_unique<CBlockStats>(m_addressMask, RECYCLE_NOLINK_THRESHOLD) : std::unique_ptr<CBlockStats>();
+	}
+
+	CBlockStats* GetBlockStats() const override
+	{
+		return m_blockStats.get();
+	}
+
 #ifdef DEBUGGER_INCLUDED
 	bool MustBreak() const override
 	{
@@ -127,6 +142,14 @@ public:
 protected:
 	typedef std::unordered_set<BasicBlockPtr> BlockStore;
 
+	//Lookup tables need the empty block to be compiled when they are created
+	static BasicBlockPtr CreateEmptyBlock(CMIPS& context, BLOCK_CATEGORY blockCategory)
+	{
+		auto result = std::make_shared<CBasicBlock>(context, MIPS_INVALID_PC, MIPS_INVALID_PC, blockCategory);
+		result->Compile();
+		return result;
+	}
+
 	bool HasBlockAt(uint32 address) const
 	{
 		auto block = m_blockLookup.FindBlockAt(address);
@@ -136,7 +159,19 @@ protected:
 	void CreateBlock(uint32 start, uint32 end)
 	{
 		assert(!HasBlockAt(start));
+		uint64 compileTimeBase = m_blockStats ? CBasicBlock::GetThreadCompileTime() : 0;
 		auto block = BlockFactory(m_context, start, end);
+		if(m_blockStats)
+		{
+			uint64 compileTime = CBasicBlock::GetThreadCompileTime() - compileTimeBase;
+			m_blockStats->RecordBlockCreation(start, end, compileTime, block->GetCodeSize(), block->GetRecycleCount());
+		}
+		InsertBlock(std::move(block));
+	}
+
+	void InsertBlock(BasicBlockPtr block)
+	{
+		assert(!HasBlockAt(block->GetBeginAddress()));
 		ResetBlockOutLinks(block.get());
 		m_blockLookup.AddBlock(block.get());
 		m_blocks.insert(std::move(block));
@@ -315,6 +350,11 @@ protected:
 		{
 			m_blocks.erase(clearedBlock->shared_from_this());
 		}
+
+		if(m_blockStats)
+		{
+			m_blockStats->RecordInvalidation(start, end, static_cast<uint32>(clearedBlocks.size()));
+		}
 	}
 
 	BlockStore m_blocks;
@@ -327,6 +367,8 @@ protected:
 
 	BlockLookupType m_blockLookup;
 
+	std::unique_ptr<CBlockStats> m_blockStats;
+
 #ifdef DEBUGGER_INCLUDED
 	bool m_mustBreak = false;
 	bool m_breakpointsDisabledOnce = false;
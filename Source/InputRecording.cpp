@@ -0,0 +1,110 @@
+#include <cassert>
+#include <stdexcept>
+#include "InputRecording.h"
+
+CInputRecording::FrameState CInputRecording::GetNeutralFrameState()
+{
+	FrameState frameState;
+	for(auto& padState : frameState)
+	{
+		for(unsigned int i = 0; i < PS2::CControllerInfo::MAX_BUTTONS; i++)
+		{
+			auto button = static_cast<PS2::CControllerInfo::BUTTON>(i);
+			padState[i] = PS2::CControllerInfo::IsAxis(button) ? 0x7F : 0;
+		}
+	}
+	return frameState;
+}
+
+void CInputRecording::Read(Framework::CStream& stream)
+{
+	uint32 signature = stream.Read32();
+	uint32 version = stream.Read32();
+	if((signature != SIGNATURE) || (version != VERSION))
+	{
+		throw std::runtime_error("Invalid input recording file.");
+	}
+	uint32 padCount = stream.Read32();
+	uint32 buttonCount = stream.Read32();
+	if((padCount != MAX_PADS) || (buttonCount != PS2::CControllerInfo::MAX_BUTTONS))
+	{
+		throw std::runtime_error("Unsupported input recording layout.");
+	}
+	uint32 frameCount = stream.Read32();
+	m_frames.resize(frameCount);
+	for(auto& frame : m_frames)
+	{
+		for(auto& padState : frame)
+		{
+			if(stream.Read(padState.data(), padState.size()) != padState.size())
+			{
+				throw std::runtime_error("Input recording file is truncated.");
+			}
+		}
+	}
+}
+
+void CInputRecording::Write(Framework::CStream& stream) const
+{
+	stream.Write32(SIGNATURE);
+	stream.Write32(VERSION);
+	stream.Write32(MAX_PADS);
+	stream.Write32(PS2::CControllerInfo::MAX_BUTTONS);
+	stream.Write32(static_cast<uint32>(m_frames.size()));
+	for(const auto& frame : m_frames)
+	{
+		for(const auto& padState : frame)
+		{
+			stream.Write(padState.data(), padState.size());
+		}
+	}
+}
+
+uint32 CInputRecording::GetFrameCount() const
+{
+	return static_cast<uint32>(m_frames.size());
+}
+
+const CInputRecording::FrameState& CInputRecording::GetFrame(uint32 frameIndex) const
+{
+	assert(frameIndex < m_frames.size());
+	return m_frames[frameIndex];
+}
+
+void CInputRecording::AddFrame(const FrameState& frameState)
+{
+	m_frames.push_back(frameState);
+}
+
+CInputRecorder::CInputRecorder()
+    : m_currentFrame(CInputRecording::GetNeutralFrameState())
+{
+}
+
+void CInputRecorder::SetButtonState(unsigned int padNumber, PS2::CControllerInfo::BUTTON button, bool pressed, uint8*)
+{
+	if(padNumber >= CInputRecording::MAX_PADS) return;
+	m_currentFrame[padNumber][button] = pressed ? 1 : 0;
+}
+
+void CInputRecorder::SetAxisState(unsigned int padNumber, PS2::CControllerInfo::BUTTON button, uint8 axisValue, uint8*)
+{
+	if(padNumber >= CInputRecording::MAX_PADS) return;
+	m_currentFrame[padNumber][button] = axisValue;
+}
+
+void CInputRecorder::GetVibration(unsigned int, uint8& largeMotor, uint8& smallMotor)
+{
+	largeMotor = 0;
+	smallMotor = 0;
+}
+
+void CInputRecorder::EndFrame()
+{
+	m_recording.AddFrame(m_currentFrame);
+}
+
+const CInputRecording& CInputRecorder::GetRecording() const
+{
+	return m_recording;
+}
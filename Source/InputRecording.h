@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "PadInterface.h"
+#include "Stream.h"
+
+//Pad states captured once per frame, allows a play session started from a saved state to be replayed frame-exactly
+class CInputRecording
+{
+public:
+	enum
+	{
+		MAX_PADS = 2,
+	};
+
+	typedef std::array<uint8, PS2::CControllerInfo::MAX_BUTTONS> PadState;
+	typedef std::array<PadState, MAX_PADS> FrameState;
+
+	static FrameState GetNeutralFrameState();
+
+	void Read(Framework::CStream&);
+	void Write(Framework::CStream&) const;
+
+	uint32 GetFrameCount() const;
+	const FrameState& GetFrame(uint32) const;
+	void AddFrame(const FrameState&);
+
+private:
+	enum
+	{
+		SIGNATURE = 0x43455249, //'IREC'
+		VERSION = 1,
+	};
+
+	std::vector<FrameState> m_frames;
+};
+
+//Listens to a pad handler and records the states it reports every frame
+class CInputRecorder : public CPadInterface
+{
+public:
+	CInputRecorder();
+	virtual ~CInputRecorder() = default;
+
+	void SetButtonState(unsigned int, PS2::CControllerInfo::BUTTON, bool, uint8*) override;
+	void SetAxisState(unsigned int, PS2::CControllerInfo::BUTTON, uint8, uint8*) override;
+	void GetVibration(unsigned int, uint8& largeMotor, uint8& smallMotor) override;
+
+	void EndFrame();
+	const CInputRecording& GetRecording() const;
+
+private:
+	CInputRecording m_recording;
+	CInputRecording::FrameState m_currentFrame;
+};
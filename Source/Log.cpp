@@ -1,13 +1,18 @@
 #include "Log.h"
 #include <set>
-#include <cstdarg>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
 #include "AppConfig.h"
 #include "PathUtils.h"
 #include "StdStreamUtils.h"
+#include "string_format.h"
 
 #define LOG_PATH "logs"
 
 #define PREF_LOG_SHOWPRINTS "log.showprints"
+#define PREF_LOG_CHANNELS "log.channels"
 
 // clang-format off
 static const std::set<std::string, std::less<>> g_allowedLogs =
@@ -22,44 +27,258 @@ CLog::CLog()
 	m_logBasePath = CAppConfig::GetInstance().GetBasePath() / LOG_PATH;
 	Framework::PathUtils::EnsurePathExists(m_logBasePath);
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_LOG_SHOWPRINTS, false);
+	CAppConfig::GetInstance().RegisterPreferenceString(PREF_LOG_CHANNELS, "");
 	m_showPrints = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_LOG_SHOWPRINTS);
+
+	//Comma separated list of channels for which prints are enabled
+	std::string channelNames = CAppConfig::GetInstance().GetPreferenceString(PREF_LOG_CHANNELS);
+	size_t position = 0;
+	while(position <= channelNames.size())
+	{
+		size_t separator = channelNames.find(',', position);
+		if(separator == std::string::npos) separator = channelNames.size();
+		auto channelName = channelNames.substr(position, separator - position);
+		if(!channelName.empty())
+		{
+			SetChannelEnabled(channelName.c_str(), true);
+		}
+		position = separator + 1;
+	}
+#endif
+#if defined(_DEBUG) && !defined(DISABLE_LOGGING)
+	m_writerThread = std::thread([this]() { WriterThreadProc(); });
 #endif
 }
 
+CLog::~CLog()
+{
+	if(m_writerThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> writerLock(m_writerMutex);
+			m_writerEnd = true;
+		}
+		m_writerCondVar.notify_one();
+		m_writerThread.join();
+	}
+}
+
 void CLog::Print(const char* logName, const char* format, ...)
 {
 #if defined(_DEBUG) && !defined(DISABLE_LOGGING)
-	if(!m_showPrints && !g_allowedLogs.count(logName)) return;
-	auto& logStream(GetLog(logName));
+	auto channel = GetChannel(logName);
+	if(!channel->enabled.load(std::memory_order_relaxed)) return;
 	va_list args;
 	va_start(args, format);
-	vfprintf(logStream, format, args);
+	WriteRecord(channel, format, args);
 	va_end(args);
-	logStream.Flush();
 #endif
 }
 
 void CLog::Warn(const char* logName, const char* format, ...)
 {
 #if defined(_DEBUG) && !defined(DISABLE_LOGGING)
-	auto& logStream(GetLog(logName));
+	auto channel = GetChannel(logName);
 	va_list args;
 	va_start(args, format);
-	vfprintf(logStream, format, args);
+	WriteRecord(channel, format, args);
 	va_end(args);
-	logStream.Flush();
 #endif
 }
 
-Framework::CStdStream& CLog::GetLog(const char* logName)
+void CLog::SetChannelEnabled(const char* logName, bool enabled)
+{
+	GetChannel(logName)->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool CLog::IsChannelEnabled(const char* logName)
+{
+	return GetChannel(logName)->enabled.load(std::memory_order_relaxed);
+}
+
+uint64 CLog::GetDroppedRecordCount() const
+{
+	return m_droppedRecordCount.load(std::memory_order_relaxed);
+}
+
+CLog::CHANNEL* CLog::GetChannel(const char* logName)
+{
+	//Log names are mostly string literals, cache lookups by pointer to avoid locking on every record
+	struct CHANNEL_CACHE_ENTRY
+	{
+		const char* name = nullptr;
+		CHANNEL* channel = nullptr;
+	};
+	thread_local CHANNEL_CACHE_ENTRY channelCache[CHANNEL_CACHE_SIZE];
+
+	auto& cacheEntry = channelCache[(reinterpret_cast<uintptr_t>(logName) >> 3) % CHANNEL_CACHE_SIZE];
+	if((cacheEntry.name == logName) && !strcmp(cacheEntry.channel->name.c_str(), logName))
+	{
+		return cacheEntry.channel;
+	}
+
+	CHANNEL* channel = nullptr;
+	{
+		std::lock_guard<std::mutex> channelsLock(m_channelsMutex);
+		auto channelIterator = m_channels.find(logName);
+		if(channelIterator == std::end(m_channels))
+		{
+			auto newChannel = std::make_unique<CHANNEL>();
+			newChannel->name = logName;
+			newChannel->enabled = m_showPrints || (g_allowedLogs.count(logName) != 0);
+			channelIterator = m_channels.emplace(logName, std::move(newChannel)).first;
+		}
+		channel = channelIterator->second.get();
+	}
+
+	cacheEntry.name = logName;
+	cacheEntry.channel = channel;
+	return channel;
+}
+
+CLog::RING* CLog::GetThreadRing()
+{
+	//Lets the writer thread know that the ring won't be written to anymore when the thread exits
+	struct THREAD_RING
+	{
+		~THREAD_RING()
+		{
+			if(ring) ring->released.store(true, std::memory_order_release);
+		}
+		std::shared_ptr<RING> ring;
+	};
+	thread_local THREAD_RING threadRing;
+	if(threadRing.ring) return threadRing.ring.get();
+
+	threadRing.ring = std::make_shared<RING>();
+
+	std::lock_guard<std::mutex> ringsLock(m_ringsMutex);
+	m_rings.push_back(threadRing.ring);
+	return threadRing.ring.get();
+}
+
+void CLog::WriteRecord(CHANNEL* channel, const char* format, va_list args)
+{
+	auto ring = GetThreadRing();
+	uint32 writeIndex = ring->writeIndex.load(std::memory_order_relaxed);
+	uint32 readIndex = ring->readIndex.load(std::memory_order_acquire);
+	uint32 pendingCount = writeIndex - readIndex;
+	if(pendingCount == RING_SIZE)
+	{
+		channel->droppedRecordCount.fetch_add(1, std::memory_order_relaxed);
+		m_droppedRecordCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& record = ring->records[writeIndex % RING_SIZE];
+	record.channel = channel;
+	int textSize = vsnprintf(record.text, RECORD_TEXT_SIZE, format, args);
+	if(textSize < 0)
+	{
+		textSize = 0;
+	}
+	else if(textSize >= RECORD_TEXT_SIZE)
+	{
+		//Text got truncated, make sure the line is still terminated
+		static const char truncatedEnd[] = "...\r\n";
+		memcpy(record.text + RECORD_TEXT_SIZE - sizeof(truncatedEnd), truncatedEnd, sizeof(truncatedEnd));
+		textSize = RECORD_TEXT_SIZE - 1;
+	}
+	record.textSize = textSize;
+	ring->writeIndex.store(writeIndex + 1, std::memory_order_release);
+
+	//Wake up writer early if ring is getting full
+	if((pendingCount + 1) == (RING_SIZE / 2))
+	{
+		m_writerCondVar.notify_one();
+	}
+}
+
+void CLog::WriterThreadProc()
+{
+	while(1)
+	{
+		bool writerEnd = false;
+		{
+			std::unique_lock<std::mutex> writerLock(m_writerMutex);
+			m_writerCondVar.wait_for(writerLock, std::chrono::milliseconds(WRITER_INTERVAL_MS), [this]() { return m_writerEnd; });
+			writerEnd = m_writerEnd;
+		}
+		DrainRings();
+		if(writerEnd) break;
+	}
+}
+
+void CLog::DrainRings()
+{
+	RingList rings;
+	{
+		std::lock_guard<std::mutex> ringsLock(m_ringsMutex);
+		rings = m_rings;
+	}
+
+	std::set<CHANNEL*> writtenChannels;
+	std::set<RING*> drainedReleasedRings;
+	for(const auto& ring : rings)
+	{
+		//Check this before draining, records written before release are guaranteed to be visible
+		bool released = ring->released.load(std::memory_order_acquire);
+		uint32 readIndex = ring->readIndex.load(std::memory_order_relaxed);
+		uint32 writeIndex = ring->writeIndex.load(std::memory_order_acquire);
+		for(; readIndex != writeIndex; readIndex++)
+		{
+			const auto& record = ring->records[readIndex % RING_SIZE];
+			WriteToChannel(record.channel, record.text, record.textSize);
+			writtenChannels.insert(record.channel);
+			ring->readIndex.store(readIndex + 1, std::memory_order_release);
+		}
+		if(released)
+		{
+			drainedReleasedRings.insert(ring.get());
+		}
+	}
+
+	if(!drainedReleasedRings.empty())
+	{
+		std::lock_guard<std::mutex> ringsLock(m_ringsMutex);
+		m_rings.erase(std::remove_if(std::begin(m_rings), std::end(m_rings),
+		                             [&](const auto& ring) { return drainedReleasedRings.count(ring.get()) != 0; }),
+		              std::end(m_rings));
+	}
+
+	{
+		std::vector<CHANNEL*> channels;
+		{
+			std::lock_guard<std::mutex> channelsLock(m_channelsMutex);
+			for(const auto& channelPair : m_channels)
+			{
+				channels.push_back(channelPair.second.get());
+			}
+		}
+		for(auto channel : channels)
+		{
+			uint32 droppedRecordCount = channel->droppedRecordCount.exchange(0, std::memory_order_relaxed);
+			if(droppedRecordCount == 0) continue;
+			auto text = string_format("%u log records dropped.\r\n", droppedRecordCount);
+			WriteToChannel(channel, text.data(), text.size());
+			writtenChannels.insert(channel);
+		}
+	}
+
+	for(auto channel : writtenChannels)
+	{
+		channel->stream.Flush();
+	}
+}
+
+void CLog::WriteToChannel(CHANNEL* channel, const char* text, size_t textSize)
 {
-	auto logIterator(m_logs.find(logName));
-	if(logIterator == std::end(m_logs))
+	//Streams are only accessed from the writer thread
+	if(!channel->hasStream)
 	{
-		auto logPath = m_logBasePath / (std::string(logName) + ".log");
-		auto logStream = Framework::CreateOutputStdStream(logPath.native());
-		m_logs[logName] = std::move(logStream);
-		logIterator = m_logs.find(logName);
+		auto logPath = m_logBasePath / (channel->name + ".log");
+		channel->stream = Framework::CreateOutputStdStream(logPath.native());
+		channel->hasStream = true;
 	}
-	return logIterator->second;
+	channel->stream.Write(text, textSize);
 }
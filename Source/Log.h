@@ -2,25 +2,93 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdarg>
 #include "filesystem_def.h"
 #include "StdStream.h"
 #include "Singleton.h"
 
+//Log records are formatted by the calling thread into per thread ring buffers
+//and are written to disk by a background writer thread.
 class CLog : public CSingleton<CLog>
 {
 public:
 	CLog();
-	virtual ~CLog() = default;
+	virtual ~CLog();
 
 	void Print(const char*, const char*, ...);
 	void Warn(const char*, const char*, ...);
 
+	//Enables or disables prints for a channel. Warnings are always logged.
+	void SetChannelEnabled(const char*, bool);
+	bool IsChannelEnabled(const char*);
+
+	uint64 GetDroppedRecordCount() const;
+
 private:
-	typedef std::map<std::string, Framework::CStdStream> LogMapType;
+	enum
+	{
+		RECORD_TEXT_SIZE = 0xF0,
+		RING_SIZE = 0x400,
+		CHANNEL_CACHE_SIZE = 0x10,
+		WRITER_INTERVAL_MS = 10,
+	};
+
+	struct CHANNEL
+	{
+		std::string name;
+		std::atomic<bool> enabled = false;
+		std::atomic<uint32> droppedRecordCount = 0;
+		Framework::CStdStream stream;
+		bool hasStream = false;
+	};
+
+	struct RECORD
+	{
+		CHANNEL* channel = nullptr;
+		uint32 textSize = 0;
+		char text[RECORD_TEXT_SIZE];
+	};
+
+	//Written by its owner thread only, read by the writer thread only.
+	//Released when its owner thread exits, the writer thread frees it once it's drained.
+	struct RING
+	{
+		std::atomic<uint32> readIndex = 0;
+		std::atomic<uint32> writeIndex = 0;
+		std::atomic<bool> released = false;
+		RECORD records[RING_SIZE];
+	};
+
+	typedef std::map<std::string, std::unique_ptr<CHANNEL>, std::less<>> ChannelMap;
+	typedef std::vector<std::shared_ptr<RING>> RingList;
 
-	Framework::CStdStream& GetLog(const char*);
+	CHANNEL* GetChannel(const char*);
+	RING* GetThreadRing();
+	void WriteRecord(CHANNEL*, const char*, va_list);
+
+	void WriterThreadProc();
+	void DrainRings();
+	void WriteToChannel(CHANNEL*, const char*, size_t);
 
 	fs::path m_logBasePath;
-	LogMapType m_logs;
 	bool m_showPrints = false;
+
+	std::mutex m_channelsMutex;
+	ChannelMap m_channels;
+
+	std::mutex m_ringsMutex;
+	RingList m_rings;
+
+	std::atomic<uint64> m_droppedRecordCount = 0;
+
+	std::mutex m_writerMutex;
+	std::condition_variable m_writerCondVar;
+	std::thread m_writerThread;
+	bool m_writerEnd = false;
 };
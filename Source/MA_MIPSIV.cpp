@@ -1,4 +1,6 @@
 #include <stddef.h>
+#include <algorithm>
+#include <cassert>
 #include "MA_MIPSIV.h"
 #include "MIPS.h"
 #include "Jitter.h"
@@ -255,6 +257,11 @@ void CMA_MIPSIV::CompileInstruction(uint32 address, CMipsJitter* codeGen, CMIPS*
 {
 	SetupQuickVariables(address, codeGen, ctx, instrPosition);
 
+	if(instrPosition == 0)
+	{
+		ResetBlockAnalysis();
+	}
+
 	m_nRS = (uint8)((m_nOpcode >> 21) & 0x1F);
 	m_nRT = (uint8)((m_nOpcode >> 16) & 0x1F);
 	m_nRD = (uint8)((m_nOpcode >> 11) & 0x1F);
@@ -265,6 +272,209 @@ void CMA_MIPSIV::CompileInstruction(uint32 address, CMipsJitter* codeGen, CMIPS*
 	{
 		m_pOpGeneral[(m_nOpcode >> 26)]();
 	}
+
+	UpdateBlockAnalysis();
+}
+
+//Blocks are compiled linearly from their first instruction, which allows us to keep track of
+//registers holding values known at compile time (ie.: LUI/ADDIU/ORI sequences) and of the
+//addresses that already went through a TLB exception check since the beginning of the block.
+void CMA_MIPSIV::ResetBlockAnalysis()
+{
+	m_constantRegMask = 1;
+	m_tlbCheckedAccesses.clear();
+}
+
+void CMA_MIPSIV::UpdateBlockAnalysis()
+{
+	auto isConstantReg = [this](uint8 reg) { return (m_constantRegMask & (1 << reg)) != 0; };
+
+	//Compute the new value of the destination register if it can be known at compile time
+	bool destIsConstant = false;
+	uint8 destReg = 0;
+	uint32 destValue = 0;
+	switch(m_nOpcode >> 26)
+	{
+	case 0x00:
+		//ADDU/OR/DADDU RD, RS, R0 (register move)
+		switch(m_nOpcode & 0x3F)
+		{
+		case 0x21:
+		case 0x25:
+		case 0x2D:
+			if((m_nRT == 0) && isConstantReg(m_nRS))
+			{
+				destIsConstant = true;
+				destReg = m_nRD;
+				destValue = m_constantRegValues[m_nRS];
+			}
+			break;
+		}
+		break;
+	case 0x09:
+		//ADDIU
+		if(isConstantReg(m_nRS))
+		{
+			destIsConstant = true;
+			destReg = m_nRT;
+			destValue = m_constantRegValues[m_nRS] + static_cast<int16>(m_nImmediate);
+		}
+		break;
+	case 0x0D:
+		//ORI
+		if(isConstantReg(m_nRS))
+		{
+			destIsConstant = true;
+			destReg = m_nRT;
+			destValue = m_constantRegValues[m_nRS] | m_nImmediate;
+		}
+		break;
+	case 0x0F:
+		//LUI
+		destIsConstant = true;
+		destReg = m_nRT;
+		destValue = m_nImmediate << 16;
+		break;
+	case 0x10:
+		//COP0 instructions can modify TLB entries
+		m_tlbCheckedAccesses.clear();
+		break;
+	}
+
+	uint32 writtenRegMask = GetWrittenRegisterMask(m_nOpcode) & ~1;
+	m_constantRegMask &= ~writtenRegMask;
+	m_tlbCheckedAccesses.erase(
+	    std::remove_if(std::begin(m_tlbCheckedAccesses), std::end(m_tlbCheckedAccesses),
+	                   [&](const TLB_CHECKED_ACCESS& checkedAccess) { return (writtenRegMask & (1 << checkedAccess.rs)) != 0; }),
+	    std::end(m_tlbCheckedAccesses));
+
+	if(destIsConstant && (destReg != 0))
+	{
+		m_constantRegMask |= (1 << destReg);
+		m_constantRegValues[destReg] = destValue;
+	}
+}
+
+uint32 CMA_MIPSIV::GetWrittenRegisterMask(uint32 opcode)
+{
+	uint8 rt = static_cast<uint8>((opcode >> 16) & 0x1F);
+	uint8 rd = static_cast<uint8>((opcode >> 11) & 0x1F);
+	switch(opcode >> 26)
+	{
+	case 0x00: //SPECIAL
+	case 0x1C: //SPECIAL2/MMI
+		return (1 << rd);
+	case 0x01: //REGIMM (BLTZAL & co.)
+	case 0x03: //JAL
+		return (1 << CMIPS::RA);
+	case 0x02: //J
+	case 0x04: //BEQ
+	case 0x05: //BNE
+	case 0x06: //BLEZ
+	case 0x07: //BGTZ
+	case 0x14: //BEQL
+	case 0x15: //BNEL
+	case 0x16: //BLEZL
+	case 0x17: //BGTZL
+	case 0x1F: //SQ
+	case 0x28: //SB
+	case 0x29: //SH
+	case 0x2A: //SWL
+	case 0x2B: //SW
+	case 0x2C: //SDL
+	case 0x2D: //SDR
+	case 0x2E: //SWR
+	case 0x2F: //CACHE
+	case 0x31: //LWC1
+	case 0x33: //PREF
+	case 0x36: //LDC2/LQC2
+	case 0x39: //SWC1
+	case 0x3E: //SDC2/SQC2
+	case 0x3F: //SD
+		return 0;
+	case 0x08: //ADDI
+	case 0x09: //ADDIU
+	case 0x0A: //SLTI
+	case 0x0B: //SLTIU
+	case 0x0C: //ANDI
+	case 0x0D: //ORI
+	case 0x0E: //XORI
+	case 0x0F: //LUI
+	case 0x10: //COP0
+	case 0x11: //COP1
+	case 0x12: //COP2
+	case 0x18: //DADDI
+	case 0x19: //DADDIU
+	case 0x1A: //LDL
+	case 0x1B: //LDR
+	case 0x1E: //LQ
+	case 0x20: //LB
+	case 0x21: //LH
+	case 0x22: //LWL
+	case 0x23: //LW
+	case 0x24: //LBU
+	case 0x25: //LHU
+	case 0x26: //LWR
+	case 0x27: //LWU
+	case 0x37: //LD
+		return (1 << rt);
+	default:
+		//Unknown, assume everything has been modified
+		return ~0U;
+	}
+}
+
+bool CMA_MIPSIV::TryGetConstantMemAccessAddress(uint32& address) const
+{
+	if((m_constantRegMask & (1 << m_nRS)) == 0) return false;
+	address = m_constantRegValues[m_nRS] + static_cast<int16>(m_nImmediate);
+	return true;
+}
+
+bool CMA_MIPSIV::IsMemAccessPageMapped(uint32 address) const
+{
+	//Page lookup table is filled when the CPU is created and never changes afterwards
+	if(m_pCtx->m_pageLookup == nullptr) return false;
+	return m_pCtx->m_pageLookup[address / MIPS_PAGE_SIZE] != nullptr;
+}
+
+void CMA_MIPSIV::ComputeConstantMemAccessRefIdx(uint32 address, uint32 accessSize)
+{
+	assert(IsMemAccessPageMapped(address));
+
+	m_codeGen->PushRelRef(offsetof(CMIPS, m_pageLookup));
+	m_codeGen->PushCst(address / MIPS_PAGE_SIZE);
+	m_codeGen->LoadRefFromRefIdx();
+
+	m_codeGen->PushCst(address & (MIPS_PAGE_SIZE - accessSize));
+}
+
+void CMA_MIPSIV::CheckMemAccessTLBExceptions(bool isWrite)
+{
+	uint32 address = 0;
+	if(TryGetConstantMemAccessAddress(address) &&
+	   m_pCtx->m_TLBExemptAddressChecker && m_pCtx->m_TLBExemptAddressChecker(address))
+	{
+		return;
+	}
+
+	//TLB entries can't change in the middle of a block (except through COP0), no need
+	//to check the same address twice
+	auto checkedAccessIterator = std::find_if(std::begin(m_tlbCheckedAccesses), std::end(m_tlbCheckedAccesses),
+	                                          [this](const TLB_CHECKED_ACCESS& checkedAccess) {
+		                                          return (checkedAccess.rs == m_nRS) && (checkedAccess.immediate == m_nImmediate);
+	                                          });
+	if(checkedAccessIterator != std::end(m_tlbCheckedAccesses))
+	{
+		return;
+	}
+
+	CheckTLBExceptions(isWrite);
+
+	TLB_CHECKED_ACCESS checkedAccess;
+	checkedAccess.rs = m_nRS;
+	checkedAccess.immediate = m_nImmediate;
+	m_tlbCheckedAccesses.push_back(checkedAccess);
 }
 
 void CMA_MIPSIV::SPECIAL()
@@ -599,7 +809,7 @@ void CMA_MIPSIV::LH()
 //22
 void CMA_MIPSIV::LWL()
 {
-	CheckTLBExceptions(false);
+	CheckMemAccessTLBExceptions(false);
 
 	if(m_nRT == 0) return;
 
@@ -638,7 +848,7 @@ void CMA_MIPSIV::LHU()
 //26
 void CMA_MIPSIV::LWR()
 {
-	CheckTLBExceptions(false);
+	CheckMemAccessTLBExceptions(false);
 
 	if(m_nRT == 0) return;
 
@@ -677,7 +887,7 @@ void CMA_MIPSIV::SH()
 //2A
 void CMA_MIPSIV::SWL()
 {
-	CheckTLBExceptions(true);
+	CheckMemAccessTLBExceptions(true);
 	ComputeMemAccessAddrNoXlat();
 	m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
 	m_codeGen->PushCtx();
@@ -715,7 +925,7 @@ void CMA_MIPSIV::SDR()
 //2E
 void CMA_MIPSIV::SWR()
 {
-	CheckTLBExceptions(true);
+	CheckMemAccessTLBExceptions(true);
 	ComputeMemAccessAddrNoXlat();
 	m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
 	m_codeGen->PushCtx();
@@ -766,6 +976,15 @@ void CMA_MIPSIV::LD()
 	if(!Ensure64BitRegs()) return;
 	if(m_nRT == 0) return;
 
+	uint32 constantAddress = 0;
+	if(TryGetConstantMemAccessAddress(constantAddress) && IsMemAccessPageMapped(constantAddress))
+	{
+		ComputeConstantMemAccessRefIdx(constantAddress, 8);
+		m_codeGen->Load64FromRefIdx(1);
+		m_codeGen->PullRel64(offsetof(CMIPS, m_State.nGPR[m_nRT]));
+		return;
+	}
+
 	ComputeMemAccessPageRef();
 
 	m_codeGen->PushCst(0);
@@ -821,6 +1040,15 @@ void CMA_MIPSIV::SD()
 {
 	if(!Ensure64BitRegs()) return;
 
+	uint32 constantAddress = 0;
+	if(TryGetConstantMemAccessAddress(constantAddress) && IsMemAccessPageMapped(constantAddress))
+	{
+		ComputeConstantMemAccessRefIdx(constantAddress, 8);
+		m_codeGen->PushRel64(offsetof(CMIPS, m_State.nGPR[m_nRT]));
+		m_codeGen->Store64AtRefIdx(1);
+		return;
+	}
+
 	ComputeMemAccessPageRef();
 
 	m_codeGen->PushCst(0);
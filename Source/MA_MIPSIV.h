@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 #include "MIPSArchitecture.h"
 #include "MIPSReflection.h"
 
@@ -122,7 +123,24 @@ protected:
 	void Template_BranchGez(bool, bool);
 	void Template_BranchLez(bool, bool);
 
+	//Memory access specialization, relies on what the block analysis knows about registers
+	bool TryGetConstantMemAccessAddress(uint32&) const;
+	bool IsMemAccessPageMapped(uint32) const;
+	void ComputeConstantMemAccessRefIdx(uint32, uint32);
+	void CheckMemAccessTLBExceptions(bool);
+
 private:
+	struct TLB_CHECKED_ACCESS
+	{
+		uint8 rs = 0;
+		uint16 immediate = 0;
+	};
+
+	void ResetBlockAnalysis();
+	void UpdateBlockAnalysis();
+
+	static uint32 GetWrittenRegisterMask(uint32);
+
 	void SetupInstructionTables();
 	void SetupReflectionTables();
 
@@ -247,6 +265,12 @@ private:
 	static const MemoryAccessIdxTraits g_wordAccessIdxTraits;
 	static const MemoryAccessIdxTraits g_uwordAccessIdxTraits;
 
+	//Block analysis state, valid for the instruction being compiled
+	//R0 is always known to be 0
+	uint32 m_constantRegMask = 1;
+	uint32 m_constantRegValues[32] = {};
+	std::vector<TLB_CHECKED_ACCESS> m_tlbCheckedAccesses;
+
 	//Opcode tables
 	typedef void (CMA_MIPSIV::*InstructionFuncConstant)();
 
@@ -65,7 +65,7 @@ void CMA_MIPSIV::Template_Sub64(bool isSigned)
 
 void CMA_MIPSIV::Template_Load32Idx(const MemoryAccessIdxTraits& traits)
 {
-	CheckTLBExceptions(false);
+	CheckMemAccessTLBExceptions(false);
 
 	if(m_nRT == 0) return;
 
@@ -94,6 +94,25 @@ void CMA_MIPSIV::Template_Load32Idx(const MemoryAccessIdxTraits& traits)
 		    m_codeGen->PullRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
 	    };
 
+	uint32 constantAddress = 0;
+	if(TryGetConstantMemAccessAddress(constantAddress))
+	{
+		//Address is known at compile time, no need to check the page lookup at run time
+		if(IsMemAccessPageMapped(constantAddress))
+		{
+			ComputeConstantMemAccessRefIdx(constantAddress, traits.elementSize);
+			((m_codeGen)->*(traits.loadFunction))(1);
+		}
+		else
+		{
+			m_codeGen->PushCtx();
+			m_codeGen->PushCst(constantAddress);
+			m_codeGen->Call(traits.getProxyFunction, 2, Jitter::CJitter::RETURN_VALUE_32);
+		}
+		finishLoad();
+		return;
+	}
+
 	bool usePageLookup = (m_pCtx->m_pageLookup != nullptr);
 
 	if(usePageLookup)
@@ -131,7 +150,27 @@ void CMA_MIPSIV::Template_Load32Idx(const MemoryAccessIdxTraits& traits)
 
 void CMA_MIPSIV::Template_Store32Idx(const MemoryAccessIdxTraits& traits)
 {
-	CheckTLBExceptions(true);
+	CheckMemAccessTLBExceptions(true);
+
+	uint32 constantAddress = 0;
+	if(TryGetConstantMemAccessAddress(constantAddress))
+	{
+		//Address is known at compile time, no need to check the page lookup at run time
+		if(IsMemAccessPageMapped(constantAddress))
+		{
+			ComputeConstantMemAccessRefIdx(constantAddress, traits.elementSize);
+			m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
+			((m_codeGen)->*(traits.storeFunction))(1);
+		}
+		else
+		{
+			m_codeGen->PushCtx();
+			m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
+			m_codeGen->PushCst(constantAddress);
+			m_codeGen->Call(traits.setProxyFunction, 3, Jitter::CJitter::RETURN_VALUE_NONE);
+		}
+		return;
+	}
 
 	bool usePageLookup = (m_pCtx->m_pageLookup != nullptr);
 
@@ -147,6 +147,7 @@ class CMIPS
 public:
 	typedef uint32 (*AddressTranslator)(CMIPS*, uint32);
 	typedef uint32 (*TLBExceptionChecker)(CMIPS*, uint32, uint32);
+	typedef bool (*TLBExemptAddressChecker)(uint32);
 
 	typedef std::set<uint32> BreakpointSet;
 
@@ -186,6 +187,8 @@ public:
 
 	AddressTranslator m_pAddrTranslator = nullptr;
 	TLBExceptionChecker m_TLBExceptionChecker = nullptr;
+	//Tells if an address never goes through the TLB, used to skip TLB exception checks at compile time
+	TLBExemptAddressChecker m_TLBExemptAddressChecker = nullptr;
 
 	enum REGISTER
 	{
@@ -2,6 +2,8 @@
 
 #include "Types.h"
 
+class CBlockStats;
+
 class CMipsExecutor
 {
 public:
@@ -10,6 +12,10 @@ public:
 	virtual int Execute(int) = 0;
 	virtual void ClearActiveBlocksInRange(uint32 start, uint32 end, bool executing) = 0;
 
+	//Only affects blocks compiled after the call
+	virtual void SetBlockStatsEnabled(bool) = 0;
+	virtual CBlockStats* GetBlockStats() const = 0;
+
 #ifdef DEBUGGER_INCLUDED
 	virtual bool MustBreak() const = 0;
 	virtual void DisableBreakpointsOnce() = 0;
@@ -0,0 +1,253 @@
+#include "MipsIdleLoopUtils.h"
+
+static bool IsPlainMemoryAddress(CMIPS& context, uint32 address)
+{
+	if(context.m_pAddrTranslator)
+	{
+		address = context.m_pAddrTranslator(&context, address);
+	}
+	auto element = context.m_pMemoryMap->GetReadMap(address);
+	if(!element) return false;
+	return (element->nType == CMemoryMap::MEMORYMAP_TYPE_MEMORY);
+}
+
+bool MipsIdleLoopUtils::IsIdleLoopBlock(CMIPS& context, uint32 begin, uint32 end, bool isEe)
+{
+	enum OP
+	{
+		OP_SPECIAL = 0x00,
+		OP_REGIMM = 0x01,
+		OP_BEQ = 0x04,
+		OP_BNE = 0x05,
+		OP_BLEZ = 0x06,
+		OP_BGTZ = 0x07,
+		OP_ADDIU = 0x09,
+		OP_SLTI = 0x0A,
+		OP_SLTIU = 0x0B,
+		OP_ANDI = 0x0C,
+		OP_ORI = 0x0D,
+		OP_XORI = 0x0E,
+		OP_LUI = 0x0F,
+		OP_LQ = 0x1E,
+		OP_LB = 0x20,
+		OP_LH = 0x21,
+		OP_LW = 0x23,
+		OP_LBU = 0x24,
+		OP_LHU = 0x25,
+		OP_LWU = 0x27,
+		OP_LD = 0x37,
+	};
+
+	enum
+	{
+		OP_SPECIAL_SLL = 0x00,
+		OP_SPECIAL_SRL = 0x02,
+		OP_SPECIAL_SRA = 0x03,
+		OP_SPECIAL_ADDU = 0x21,
+		OP_SPECIAL_SUBU = 0x23,
+		OP_SPECIAL_AND = 0x24,
+		OP_SPECIAL_OR = 0x25,
+		OP_SPECIAL_XOR = 0x26,
+		OP_SPECIAL_NOR = 0x27,
+		OP_SPECIAL_SLT = 0x2A,
+		OP_SPECIAL_SLTU = 0x2B,
+		OP_SPECIAL_DADDU = 0x2D,
+	};
+
+	enum
+	{
+		OP_REGIMM_BLTZ = 0x00,
+		OP_REGIMM_BGEZ = 0x01,
+	};
+
+	if(begin >= end) return false;
+
+	uint32 endInstructionAddress = end - 4;
+	uint32 endInstruction = context.m_pMemoryMap->GetWord(endInstructionAddress);
+
+	//We need a branch at the end of the block
+	auto branchType = context.m_pArch->IsInstructionBranch(&context, endInstructionAddress, endInstruction);
+	if(branchType != MIPS_BRANCH_NORMAL) return false;
+
+	//Check that the branch target is ourself
+	uint32 branchTarget = context.m_pArch->GetInstructionEffectiveAddress(&context, endInstructionAddress, endInstruction);
+	if(branchTarget == MIPS_INVALID_PC) return false;
+	if(branchTarget != begin) return false;
+
+	uint32 compareUse = 0;
+
+	//Check what kind of branching instruction we have.
+	{
+		uint32 op = (endInstruction >> 26) & 0x3F;
+		uint32 rt = (endInstruction >> 16) & 0x1F;
+		uint32 rs = (endInstruction >> 21) & 0x1F;
+
+		switch(op)
+		{
+		case OP_BEQ:
+		case OP_BNE:
+			compareUse = (1 << rs) | (1 << rt);
+			break;
+		case OP_BLEZ:
+		case OP_BGTZ:
+			compareUse = (1 << rs);
+			break;
+		case OP_REGIMM:
+			if((rt != OP_REGIMM_BLTZ) && (rt != OP_REGIMM_BGEZ)) return false;
+			compareUse = (1 << rs);
+			break;
+		default:
+			return false;
+		}
+	}
+
+	uint32 defState = 0; //Set of completely new definitions of registers within this block
+	uint32 useState = 0; //Set of previous state usage within this block
+
+	//Registers for which we know the value, used to resolve load addresses.
+	//Register values are only meaningful if we're about to execute this block.
+	uint32 knownState = 1;
+	uint32 knownValues[32] = {};
+	if(context.m_State.nPC == begin)
+	{
+		knownState = ~0U;
+		for(uint32 i = 1; i < 32; i++)
+		{
+			knownValues[i] = context.m_State.nGPR[i].nV0;
+		}
+	}
+
+	//Check all instructions inside to see if we can prove it's waiting for some kind of flag
+	for(uint32 address = begin; address <= end; address += 4)
+	{
+		//Don't check branch instruction as we've checked it already
+		if(address == endInstructionAddress) continue;
+
+		uint32 inst = context.m_pMemoryMap->GetWord(address);
+		if(inst == 0) continue;
+		uint32 special = inst & 0x3F;
+		uint32 rd = (inst >> 11) & 0x1F;
+		uint32 rt = (inst >> 16) & 0x1F;
+		uint32 rs = (inst >> 21) & 0x1F;
+		uint32 op = (inst >> 26) & 0x3F;
+
+		uint32 newDef = 0;
+		uint32 newUse = 0;
+
+		switch(op)
+		{
+		case OP_SPECIAL:
+			switch(special)
+			{
+			case OP_SPECIAL_SLL:
+			case OP_SPECIAL_SRL:
+			case OP_SPECIAL_SRA:
+				newUse = (1 << rt);
+				newDef = (1 << rd);
+				break;
+			case OP_SPECIAL_ADDU:
+			case OP_SPECIAL_SUBU:
+			case OP_SPECIAL_AND:
+			case OP_SPECIAL_OR:
+			case OP_SPECIAL_XOR:
+			case OP_SPECIAL_NOR:
+			case OP_SPECIAL_SLT:
+			case OP_SPECIAL_SLTU:
+				newUse = (1 << rs) | (1 << rt);
+				newDef = (1 << rd);
+				break;
+			case OP_SPECIAL_DADDU:
+				if(!isEe) return false;
+				newUse = (1 << rs) | (1 << rt);
+				newDef = (1 << rd);
+				break;
+			default:
+				//We don't know what this does, let's not take a chance
+				return false;
+			}
+			break;
+		case OP_LUI:
+			newDef = (1 << rt);
+			break;
+		case OP_ADDIU:
+		case OP_SLTI:
+		case OP_SLTIU:
+		case OP_ANDI:
+		case OP_ORI:
+		case OP_XORI:
+			newUse = (1 << rs);
+			newDef = (1 << rt);
+			break;
+		case OP_LWU:
+		case OP_LD:
+		case OP_LQ:
+			if(!isEe) return false;
+			[[fallthrough]];
+		case OP_LB:
+		case OP_LH:
+		case OP_LW:
+		case OP_LBU:
+		case OP_LHU:
+		{
+			//Make sure we're reading from memory and not from a hardware register
+			if((knownState & (1 << rs)) == 0) return false;
+			uint32 loadAddress = knownValues[rs] + static_cast<int16>(inst & 0xFFFF);
+			if(!IsPlainMemoryAddress(context, loadAddress)) return false;
+			newUse = (1 << rs);
+			newDef = (1 << rt);
+		}
+		break;
+		default:
+			//We don't know what this does, let's not take a chance
+			return false;
+		}
+
+		//R0 is never defined
+		newDef &= ~1;
+
+		//Keep track of constants built inside the block (ie.: LUI/ORI pairs)
+		if(newDef != 0)
+		{
+			uint32 imm = inst & 0xFFFF;
+			bool rsKnown = (knownState & (1 << rs)) != 0;
+			if(op == OP_LUI)
+			{
+				knownValues[rt] = imm << 16;
+				knownState |= newDef;
+			}
+			else if((op == OP_ADDIU) && rsKnown)
+			{
+				knownValues[rt] = knownValues[rs] + static_cast<int16>(imm);
+				knownState |= newDef;
+			}
+			else if((op == OP_ORI) && rsKnown)
+			{
+				knownValues[rt] = knownValues[rs] | imm;
+				knownState |= newDef;
+			}
+			else
+			{
+				knownState &= ~newDef;
+			}
+		}
+
+		//Bail if this defines any state that we previously used
+		if(useState & newDef)
+		{
+			return false;
+		}
+
+		//Remove uses from defs within this block
+		newUse &= ~defState;
+
+		defState |= newDef;
+		useState |= newUse;
+	}
+
+	//Make sure that what we're comparing against is coming from memory,
+	//otherwise, nothing outside of this block can get us out of the loop
+	compareUse &= ~1;
+	if((defState & compareUse) == 0) return false;
+
+	return true;
+}
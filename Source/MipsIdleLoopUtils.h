@@ -0,0 +1,14 @@
+#pragma once
+
+#include "MIPS.h"
+
+namespace MipsIdleLoopUtils
+{
+	//Checks if the block in [begin, end] (end being the delay slot) is a loop that only polls memory
+	//(ie.: waiting on a flag or a semaphore) without any side effect. Executing such a block more than
+	//once doesn't change the state of the machine unless something else writes to memory.
+	//Loads must use addresses that can be resolved to plain memory, hardware registers are rejected
+	//since reading them can have side effects or change on their own (ie.: timers).
+	//EE-only instructions (LQ, LD, LWU, DADDU) are only accepted if the last parameter is true.
+	bool IsIdleLoopBlock(CMIPS&, uint32, uint32, bool);
+}
@@ -0,0 +1,51 @@
+#include "PH_InputReplay.h"
+
+CPH_InputReplay::CPH_InputReplay(CInputRecording recording)
+    : m_recording(std::move(recording))
+{
+}
+
+CPadHandler::FactoryFunction CPH_InputReplay::GetFactoryFunction(CInputRecording recording)
+{
+	return [recording = std::move(recording)]() { return new CPH_InputReplay(recording); };
+}
+
+void CPH_InputReplay::Update(uint8* ram)
+{
+	//Pads are released once we've gone past the end of the recording
+	static const auto neutralFrameState = CInputRecording::GetNeutralFrameState();
+	const auto& frameState = IsComplete() ? neutralFrameState : m_recording.GetFrame(m_currentFrame);
+	for(auto& interface : m_interfaces)
+	{
+		for(unsigned int pad = 0; pad < CInputRecording::MAX_PADS; pad++)
+		{
+			const auto& padState = frameState[pad];
+			for(unsigned int i = 0; i < PS2::CControllerInfo::MAX_BUTTONS; i++)
+			{
+				auto button = static_cast<PS2::CControllerInfo::BUTTON>(i);
+				if(PS2::CControllerInfo::IsAxis(button))
+				{
+					interface->SetAxisState(pad, button, padState[i], ram);
+				}
+				else
+				{
+					interface->SetButtonState(pad, button, padState[i] != 0, ram);
+				}
+			}
+		}
+	}
+	if(!IsComplete())
+	{
+		m_currentFrame++;
+	}
+}
+
+uint32 CPH_InputReplay::GetCurrentFrame() const
+{
+	return m_currentFrame;
+}
+
+bool CPH_InputReplay::IsComplete() const
+{
+	return m_currentFrame >= m_recording.GetFrameCount();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "PadHandler.h"
+#include "InputRecording.h"
+
+//Feeds recorded pad states to the VM, one frame per update
+class CPH_InputReplay : public CPadHandler
+{
+public:
+	CPH_InputReplay(CInputRecording);
+	virtual ~CPH_InputReplay() = default;
+
+	static FactoryFunction GetFactoryFunction(CInputRecording);
+
+	void Update(uint8*) override;
+
+	uint32 GetCurrentFrame() const;
+	bool IsComplete() const;
+
+private:
+	CInputRecording m_recording;
+	uint32 m_currentFrame = 0;
+};
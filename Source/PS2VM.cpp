@@ -10,6 +10,7 @@
 #include "PS2VM_Preferences.h"
 #include "ee/PS2OS.h"
 #include "ee/EeExecutor.h"
+#include "iop/IopExecutor.h"
 #include "Ps2Const.h"
 #include "iop/Iop_SifManPs2.h"
 #include "iop/UsbBuzzerDevice.h"
@@ -30,13 +31,21 @@
 #include "iop/ioman/PreferenceDirectoryDevice.h"
 #include "Log.h"
 #include "DiskUtils.h"
+#include "BasicBlock.h"
+#include "BlockStats.h"
 #ifdef __ANDROID__
 #include "android/JavaVM.h"
 #endif
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__) || defined(__ANDROID__)
+#include <sched.h>
+#endif
 
 #define LOG_NAME ("ps2vm")
 
 #define THREAD_NAME ("PS2VM Thread")
+#define IOP_THREAD_NAME ("PS2VM IOP Thread")
 
 #define STATE_VM_TIMING_XML ("vm_timing.xml")
 #define STATE_VM_TIMING_VBLANK_TICKS ("vblankTicks")
@@ -52,6 +61,64 @@
 #define PREF_PS2_HDD_DIRECTORY_DEFAULT ("vfs/hdd")
 #define PREF_PS2_ARCADEROMS_DIRECTORY_DEFAULT ("arcaderoms")
 
+//Accumulates the time spent in a scope, does nothing when no target is specified
+class CBenchmarkTimer
+{
+public:
+	CBenchmarkTimer(uint64* target)
+	    : m_target(target)
+	{
+		if(m_target)
+		{
+			m_startTime = std::chrono::steady_clock::now();
+		}
+	}
+
+	~CBenchmarkTimer()
+	{
+		if(m_target)
+		{
+			auto duration = std::chrono::steady_clock::now() - m_startTime;
+			(*m_target) += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+		}
+	}
+
+private:
+	uint64* m_target = nullptr;
+	std::chrono::steady_clock::time_point m_startTime;
+};
+
+static void SetCurrentThreadAffinity(uint64 mask)
+{
+	if(mask == 0)
+	{
+		mask = ~0ULL;
+	}
+#if defined(_WIN32)
+	DWORD_PTR processMask = 0, systemMask = 0;
+	GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+	DWORD_PTR threadMask = static_cast<DWORD_PTR>(mask) & systemMask;
+	if(threadMask != 0)
+	{
+		SetThreadAffinityMask(GetCurrentThread(), threadMask);
+	}
+#elif defined(__linux__) || defined(__ANDROID__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for(unsigned int i = 0; i < 64; i++)
+	{
+		if(mask & (1ULL << i))
+		{
+			CPU_SET(i, &cpuSet);
+		}
+	}
+	sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+#else
+	//Not supported on this platform
+	(void)mask;
+#endif
+}
+
 CPS2VM::CPS2VM()
     : m_eeProfilerZone(CProfiler::GetInstance().RegisterZone("EE"))
     , m_iopProfilerZone(CProfiler::GetInstance().RegisterZone("IOP"))
@@ -59,6 +126,8 @@ CPS2VM::CPS2VM()
     , m_gsSyncProfilerZone(CProfiler::GetInstance().RegisterZone("GSSYNC"))
     , m_otherProfilerZone(CProfiler::GetInstance().RegisterZone("OTHER"))
 {
+	CProfiler::GetInstance().AddInstance();
+
 	// clang-format off
 	static const std::pair<const char*, const char*> basicDirectorySettings[] =
 	{
@@ -92,8 +161,17 @@ CPS2VM::CPS2VM()
 	Framework::PathUtils::EnsurePathExists(GetStateDirectoryPath());
 
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE, true);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_LATE_LATCH, false);
 	ReloadFrameRateLimit();
 
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_ADAPTIVE_TIMESLICING, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_IOP_THREADED, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_JIT_BLOCKSTATS, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_JIT_IDLELOOPDETECTION, true);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_FRAMESKIP_AUTO, false);
+	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_PS2_FRAMESKIP_MAX_CONSECUTIVE, CFrameSkipper::DEFAULT_MAX_CONSECUTIVE_SKIPS);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_TURBO_IO, false);
+
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_AUDIO_SPUBLOCKCOUNT, 100);
 	ReloadSpuBlockCountImpl();
 
@@ -101,6 +179,11 @@ CPS2VM::CPS2VM()
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_PS2_ARCADE_IO_SERVER_PORT, 9876);
 }
 
+CPS2VM::~CPS2VM()
+{
+	CProfiler::GetInstance().RemoveInstance();
+}
+
 //////////////////////////////////////////////////
 //Various Message Functions
 //////////////////////////////////////////////////
@@ -176,6 +259,63 @@ void CPS2VM::ReleaseScreenPosition()
 	}
 }
 
+bool CPS2VM::ConnectEthernetSwitch(const std::shared_ptr<CEthernetSwitch>& ethernetSwitch)
+{
+	auto port = ethernetSwitch->AttachPort();
+	if(!port)
+	{
+		//All ports are taken
+		return false;
+	}
+	m_mailBox.SendCall(
+	    [this, &port]() {
+		    auto& speed = m_iop->m_speed;
+		    m_ethernetPort = std::move(port);
+		    auto ethernetPort = m_ethernetPort.get();
+		    speed.SetMacAddress(ethernetPort->GetMacAddress().data());
+		    speed.SetEthernetFrameTxHandler(
+		        [ethernetPort](const uint8* frameData, uint32 frameSize) {
+			        ethernetPort->Send(frameData, frameSize);
+		        });
+		    speed.SetEthernetFrameRxReadyHandler(
+		        [this, ethernetPort]() {
+			        if(ethernetPort->TryReceive(m_ethernetRxFrame))
+			        {
+				        m_iop->m_speed.RxEthernetFrame(m_ethernetRxFrame.data(), static_cast<uint32>(m_ethernetRxFrame.size()));
+			        }
+		        });
+	    },
+	    true);
+	return true;
+}
+
+void CPS2VM::DisconnectEthernetSwitch()
+{
+	m_mailBox.SendCall(
+	    [this]() {
+		    auto& speed = m_iop->m_speed;
+		    speed.SetEthernetFrameTxHandler(Iop::CSpeed::EthernetFrameTxHandler());
+		    speed.SetEthernetFrameRxReadyHandler(Iop::CSpeed::EthernetFrameRxReadyHandler());
+		    m_ethernetPort.reset();
+	    },
+	    true);
+}
+
+void CPS2VM::SetThreadAffinity(uint64 mask)
+{
+	//IOP thread will pick up the new mask before running its next slice
+	m_threadAffinityMask = mask;
+	m_mailBox.SendCall(
+	    [this, mask]() {
+		    SetCurrentThreadAffinity(mask);
+		    if(m_ee->m_gs)
+		    {
+			    m_ee->m_gs->SendGSCall([mask]() { SetCurrentThreadAffinity(mask); });
+		    }
+	    },
+	    true);
+}
+
 void CPS2VM::DestroyPadHandler()
 {
 	if(m_pad == nullptr) return;
@@ -235,8 +375,9 @@ void CPS2VM::ReloadFrameRateLimit()
 		hRefreshRate = m_ee->m_gs->GetCrtHSyncFrequency();
 		vRefreshRate = m_ee->m_gs->GetCrtFrameRate();
 	}
-	bool limitFrameRate = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE);
+	bool limitFrameRate = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE) && !m_benchmarkRunning;
 	m_frameLimiter.SetFrameRate(limitFrameRate ? vRefreshRate : 0);
+	m_frameLimiter.SetLateLatchEnabled(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_LATE_LATCH));
 
 	//At 1x scale, IOP runs 8 times slower than EE
 	uint32 eeFreqScaled = PS2::EE_CLOCK_FREQ * m_eeFreqScaleNumerator / m_eeFreqScaleDenominator;
@@ -369,11 +510,292 @@ std::future<bool> CPS2VM::LoadState(const fs::path& statePath)
 	return future;
 }
 
+#ifdef PROFILE
+
+fs::path CPS2VM::GetTraceDirectoryPath()
+{
+	return CAppConfig::GetInstance().GetBasePath() / fs::path("traces/");
+}
+
+//Records trace events for the next frames and writes them to the specified path
+std::future<bool> CPS2VM::CaptureTrace(const fs::path& tracePath, uint32 frameCount)
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, tracePath, frameCount]() {
+		    if(m_tracePromise)
+		    {
+			    //A trace is already being captured
+			    promise->set_value(false);
+			    return;
+		    }
+		    if(!CProfiler::GetInstance().StartTrace(frameCount))
+		    {
+			    //Profiler is disabled (ie.: more than one VM instance)
+			    promise->set_value(false);
+			    return;
+		    }
+		    m_tracePath = tracePath;
+		    m_tracePromise = promise;
+	    });
+	return future;
+}
+
+void CPS2VM::SaveTrace()
+{
+	assert(m_tracePromise);
+	bool result = false;
+	try
+	{
+		Framework::PathUtils::EnsurePathExists(m_tracePath.parent_path());
+		auto traceStream = Framework::CreateOutputStdStream(m_tracePath.native());
+		CProfiler::GetInstance().WriteTrace(traceStream);
+		result = true;
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to save trace: %s.\r\n", exception.what());
+	}
+	m_tracePromise->set_value(result);
+	m_tracePromise.reset();
+}
+
+#endif
+
 CPS2VM::CPU_UTILISATION_INFO CPS2VM::GetCpuUtilisationInfo() const
 {
 	return m_cpuUtilisation;
 }
 
+CPS2VM::SCHEDULER_STATS CPS2VM::GetSchedulerStats() const
+{
+	return m_schedulerStats;
+}
+
+CPS2VM::FRAME_SKIP_STATS CPS2VM::GetFrameSkipStats() const
+{
+	return m_frameSkipStats;
+}
+
+CFrameLimiter::PACING_STATS CPS2VM::GetFramePacingStats() const
+{
+	return m_frameLimiter.GetPacingStats();
+}
+
+CPadHandler::INPUT_LATENCY_STATS CPS2VM::GetInputLatencyStats() const
+{
+	return m_inputLatencyStats;
+}
+
+CGsStagingArena::STATS CPS2VM::GetGsImageStagingStats() const
+{
+	return m_gsImageStagingStats;
+}
+
+CSIF::RpcServerStatsMap CPS2VM::GetSifRpcServerStats() const
+{
+	return m_sifRpcServerStats;
+}
+
+CVuExecutor::PROGRAM_CACHE_STATS CPS2VM::GetVuProgramCacheStats() const
+{
+	return m_vuProgramCacheStats;
+}
+
+Iop::Ioman::CAsyncIoEngine::DeviceStatsMap CPS2VM::GetAsyncIoStats() const
+{
+	return m_asyncIoStats;
+}
+
+//Measures the next frames with the frame limiter disabled, VM is paused once done
+std::future<CPS2VM::BenchmarkFrameArray> CPS2VM::RunBenchmark(uint32 frameCount)
+{
+	auto promise = std::make_shared<std::promise<BenchmarkFrameArray>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, frameCount]() {
+		    if(m_benchmarkPromise)
+		    {
+			    promise->set_exception(std::make_exception_ptr(std::runtime_error("A benchmark is already running.")));
+			    return;
+		    }
+		    m_benchmarkPromise = promise;
+		    m_benchmarkFrameCount = frameCount;
+		    m_benchmarkFrames.clear();
+		    m_benchmarkFrames.reserve(frameCount);
+		    m_benchmarkRunning = true;
+		    m_benchmarkStarted = false;
+		    ReloadFrameRateLimit();
+	    });
+	return future;
+}
+
+//Recording starts on the next frame, start it right after saving a state to be able to replay it from that state
+void CPS2VM::StartInputRecording()
+{
+	m_mailBox.SendCall(
+	    [this]() {
+		    if(m_inputRecorder) return;
+		    m_inputRecorder = std::make_unique<CInputRecorder>();
+		    if(m_pad)
+		    {
+			    m_pad->InsertListener(m_inputRecorder.get());
+			    m_pad->SetPollingEnabled(false);
+		    }
+	    },
+	    true);
+}
+
+CInputRecording CPS2VM::StopInputRecording()
+{
+	CInputRecording recording;
+	m_mailBox.SendCall(
+	    [this, &recording]() {
+		    if(!m_inputRecorder) return;
+		    if(m_pad)
+		    {
+			    m_pad->RemoveListener(m_inputRecorder.get());
+			    m_pad->SetPollingEnabled(true);
+		    }
+		    recording = m_inputRecorder->GetRecording();
+		    m_inputRecorder.reset();
+	    },
+	    true);
+	return recording;
+}
+
+std::future<bool> CPS2VM::SaveBlockStatsReport(const fs::path& reportPath)
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, reportPath]() {
+		    const std::pair<const char*, CMIPS*> executors[] =
+		        {
+		            std::make_pair("EE", &m_ee->m_EE),
+		            std::make_pair("VU0", &m_ee->m_VU0),
+		            std::make_pair("VU1", &m_ee->m_VU1),
+		            std::make_pair("IOP", &m_iop->m_cpu),
+		        };
+		    bool result = false;
+		    try
+		    {
+			    auto reportStream = Framework::CreateOutputStdStream(reportPath.native());
+			    for(const auto& executor : executors)
+			    {
+				    auto context = executor.second;
+				    auto blockStats = context->m_executor->GetBlockStats();
+				    if(!blockStats) continue;
+				    blockStats->WriteReport(reportStream, *context, executor.first);
+				    result = true;
+			    }
+		    }
+		    catch(const std::exception& exception)
+		    {
+			    CLog::GetInstance().Warn(LOG_NAME, "Failed to save block stats report: %s.\r\n", exception.what());
+		    }
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
+std::future<bool> CPS2VM::SaveIdleLoopReport(const fs::path& reportPath)
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, reportPath]() {
+		    bool result = false;
+		    try
+		    {
+			    auto reportStream = Framework::CreateOutputStdStream(reportPath.native());
+			    auto writeLine =
+			        [&reportStream](const std::string& line) {
+				        reportStream.Write(line.c_str(), line.size());
+				        reportStream.Write("\n", 1);
+			        };
+
+			    auto eeExecutor = static_cast<CEeExecutor*>(m_ee->m_EE.m_executor.get());
+			    writeLine(string_format("<GameConfig Executable=\"%s\">", m_ee->m_os->GetExecutableName()));
+			    for(auto address : eeExecutor->GetDetectedIdleLoopBlocks())
+			    {
+				    writeLine(string_format("\t<IdleLoopBlock Address=\"0x%08X\" />", address));
+			    }
+			    writeLine("</GameConfig>");
+
+			    //IOP idle loops can't be specified in GameConfig, they are listed for reference only
+			    auto iopExecutor = static_cast<CIopExecutor*>(m_iop->m_cpu.m_executor.get());
+			    for(auto address : iopExecutor->GetDetectedIdleLoopBlocks())
+			    {
+				    writeLine(string_format("<!-- IOP idle loop block: 0x%08X -->", address));
+			    }
+			    result = true;
+		    }
+		    catch(const std::exception& exception)
+		    {
+			    CLog::GetInstance().Warn(LOG_NAME, "Failed to save idle loop report: %s.\r\n", exception.what());
+		    }
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
+void CPS2VM::UpdateBenchmark()
+{
+	assert(m_benchmarkRunning);
+	auto currentTime = std::chrono::steady_clock::now();
+	if(m_benchmarkStarted)
+	{
+		//IOP thread is not running at this point, it's safe to read what it has accumulated
+		m_benchmarkFrame.frameTime = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - m_benchmarkFrameStartTime).count();
+		m_benchmarkFrame.jitTime = (CBasicBlock::GetThreadCompileTime() - m_benchmarkJitTimeBase) + m_benchmarkIopThreadJitTime;
+		m_benchmarkFrames.push_back(m_benchmarkFrame);
+		if(m_benchmarkFrames.size() == m_benchmarkFrameCount)
+		{
+			m_benchmarkRunning = false;
+			m_benchmarkPromise->set_value(std::move(m_benchmarkFrames));
+			m_benchmarkPromise.reset();
+			m_benchmarkFrames = BenchmarkFrameArray();
+			ReloadFrameRateLimit();
+			PauseImpl();
+			OnRunningStateChange();
+			return;
+		}
+	}
+	//Frames are measured from one vblank start to the next one
+	m_benchmarkStarted = true;
+	m_benchmarkFrame = BENCHMARK_FRAME();
+	m_benchmarkFrameStartTime = currentTime;
+	m_benchmarkJitTimeBase = CBasicBlock::GetThreadCompileTime();
+	m_benchmarkIopThreadJitTime = 0;
+}
+
+void CPS2VM::UpdateVuProgramCacheStats()
+{
+	m_vuProgramCacheStats = CVuExecutor::PROGRAM_CACHE_STATS();
+	for(auto vuContext : {&m_ee->m_VU0, &m_ee->m_VU1})
+	{
+		auto executor = static_cast<CVuExecutor*>(vuContext->m_executor.get());
+		auto stats = executor->GetProgramCacheStats();
+		m_vuProgramCacheStats.programHits += stats.programHits;
+		m_vuProgramCacheStats.programMisses += stats.programMisses;
+		m_vuProgramCacheStats.blockHits += stats.blockHits;
+		m_vuProgramCacheStats.blockCompiles += stats.blockCompiles;
+		executor->ResetProgramCacheStats();
+	}
+}
+
+void CPS2VM::UpdateAsyncIoStats()
+{
+	m_asyncIoStats.clear();
+	auto iopOs = dynamic_cast<CIopBios*>(m_iop->m_bios.get());
+	if(!iopOs) return;
+	auto ioman = iopOs->GetIoman();
+	m_asyncIoStats = ioman->GetAsyncIoStats();
+	ioman->ResetAsyncIoStats();
+}
+
 #ifdef DEBUGGER_INCLUDED
 
 #define TAGS_SECTION_TAGS ("tags")
@@ -475,6 +897,8 @@ void CPS2VM::CreateVM()
 	m_ee = std::make_unique<Ee::CSubSystem>(m_iop->m_ram, *iopOs);
 	m_OnRequestLoadExecutableConnection = m_ee->m_os->OnRequestLoadExecutable.Connect(std::bind(&CPS2VM::ReloadExecutable, this, std::placeholders::_1, std::placeholders::_2));
 	m_OnCrtModeChangeConnection = m_ee->m_os->OnCrtModeChange.Connect(std::bind(&CPS2VM::OnCrtModeChange, this));
+	m_OnExecutableChangeConnection = m_ee->m_os->OnExecutableChange.Connect(std::bind(&CPS2VM::UpdateTurboIo, this));
+	m_ee->m_sif.SetIopSyncHandler(std::bind(&CPS2VM::WaitForIopSlice, this));
 
 	ResetVM();
 }
@@ -487,9 +911,26 @@ void CPS2VM::ResetVM()
 	assert(m_eeRamSize <= PS2::EE_RAM_SIZE);
 	assert(m_iopRamSize <= PS2::IOP_RAM_SIZE);
 
+	//Can happen while the IOP is still running (ie.: executable reload requested by EE)
+	WaitForIopSlice();
+
 	m_ee->Reset(m_eeRamSize);
 	m_iop->Reset();
 
+	{
+		bool blockStatsEnabled = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_JIT_BLOCKSTATS);
+		m_ee->m_EE.m_executor->SetBlockStatsEnabled(blockStatsEnabled);
+		m_ee->m_VU0.m_executor->SetBlockStatsEnabled(blockStatsEnabled);
+		m_ee->m_VU1.m_executor->SetBlockStatsEnabled(blockStatsEnabled);
+		m_iop->m_cpu.m_executor->SetBlockStatsEnabled(blockStatsEnabled);
+	}
+
+	{
+		bool idleLoopDetectionEnabled = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_JIT_IDLELOOPDETECTION);
+		static_cast<CEeExecutor*>(m_ee->m_EE.m_executor.get())->SetIdleLoopDetectionEnabled(idleLoopDetectionEnabled);
+		static_cast<CIopExecutor*>(m_iop->m_cpu.m_executor.get())->SetIdleLoopDetectionEnabled(idleLoopDetectionEnabled);
+	}
+
 	if(m_ee->m_gs != NULL)
 	{
 		m_ee->m_gs->Reset();
@@ -526,6 +967,18 @@ void CPS2VM::ResetVM()
 	m_eeExecutionTicks = 0;
 	m_iopExecutionTicks = 0;
 
+	m_adaptiveTimeSlicing = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_ADAPTIVE_TIMESLICING);
+	m_timeSliceScale = 1;
+	m_lastSifTransferCount = 0;
+
+	m_iopThreaded = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_IOP_THREADED);
+
+	m_autoFrameSkip = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_FRAMESKIP_AUTO);
+	m_frameSkipper.SetMaxConsecutiveSkips(CAppConfig::GetInstance().GetPreferenceInteger(PREF_PS2_FRAMESKIP_MAX_CONSECUTIVE));
+	m_frameSkipper.Reset();
+
+	UpdateTurboIo();
+
 	m_currentSpuBlock = 0;
 	m_iop->m_spuCore0.SetDestinationSamplingRate(DST_SAMPLE_RATE);
 	m_iop->m_spuCore1.SetDestinationSamplingRate(DST_SAMPLE_RATE);
@@ -550,6 +1003,12 @@ bool CPS2VM::SaveVMState(const fs::path& statePath)
 
 	try
 	{
+		//Data from host reads still in progress must reach guest memory before it gets saved
+		if(auto iopOs = dynamic_cast<CIopBios*>(m_iop->m_bios.get()))
+		{
+			iopOs->GetIoman()->CompleteAsyncRequests();
+		}
+
 		auto stateStream = Framework::CreateOutputStdStream(statePath.native());
 		Framework::CZipArchiveWriter archive;
 
@@ -657,8 +1116,12 @@ void CPS2VM::CreateGsHandlerImpl(const CGSHandler::FactoryFunction& factoryFunct
 	m_ee->m_gs = factoryFunction();
 	m_ee->m_gs->SetIntc(&m_ee->m_intc);
 	m_ee->m_gs->Initialize();
-	m_ee->m_gs->SendGSCall([this]() {
+	m_ee->m_gs->SendGSCall([this, affinityMask = m_threadAffinityMask.load()]() {
 		static_cast<CEeExecutor*>(m_ee->m_EE.m_executor.get())->AttachExceptionHandlerToThread();
+		if(affinityMask != 0)
+		{
+			SetCurrentThreadAffinity(affinityMask);
+		}
 	});
 	if(gs)
 	{
@@ -711,11 +1174,66 @@ void CPS2VM::DestroySoundHandlerImpl()
 	m_soundHandler = nullptr;
 }
 
+int CPS2VM::ComputeEeTimeSlice() const
+{
+	int minTimeSlice = m_eeTickStep;
+	if(!m_adaptiveTimeSlicing || (m_timeSliceScale == 1))
+	{
+		return minTimeSlice;
+	}
+
+	//Don't go beyond the next timing event to keep it as precise as with fixed slices
+	int nextEventTicks = std::min(m_hblankTicks, m_vblankTicks);
+	nextEventTicks = static_cast<int>(std::min<int64>(nextEventTicks, m_spuUpdateTicks >> SPU_UPDATE_TICKS_PRECISION));
+	return std::max(minTimeSlice, std::min(minTimeSlice * m_timeSliceScale, nextEventTicks));
+}
+
+void CPS2VM::UpdateTimeSliceScale()
+{
+	//Grow time slice while IOP has nothing to do and no SIF transfer is happening,
+	//go back to the smallest time slice as soon as EE and IOP start talking to each other.
+	uint32 sifTransferCount = m_ee->m_sif.GetTransferCount();
+	bool sifActive = (sifTransferCount != m_lastSifTransferCount) || m_ee->m_sif.HasPendingTransfers();
+	m_lastSifTransferCount = sifTransferCount;
+
+	if(sifActive)
+	{
+		m_schedulerStats.sifSyncCount++;
+	}
+
+	if(sifActive || !m_iop->IsCpuIdle())
+	{
+		m_timeSliceScale = 1;
+	}
+	else
+	{
+		m_timeSliceScale = std::min<int>(m_timeSliceScale * 2, MAX_TIME_SLICE_SCALE);
+	}
+}
+
+void CPS2VM::UpdateFrameSkip()
+{
+	//Frame durations measured by the frame limiter include EE/IOP execution and the time
+	//spent waiting for the GS to catch up, so they reflect the whole host cost of a frame.
+	if(!m_autoFrameSkip || !m_ee->m_gs) return;
+	bool renderFrame = m_frameSkipper.ProcessFrame(m_frameLimiter.GetLastFrameDuration(), m_frameLimiter.GetMinFrameDuration());
+	m_ee->m_gs->SetFrameSkipped(!renderFrame);
+	if(renderFrame)
+	{
+		m_frameSkipStats.renderedFrames++;
+	}
+	else
+	{
+		m_frameSkipStats.skippedFrames++;
+	}
+}
+
 void CPS2VM::UpdateEe()
 {
 #ifdef PROFILE
 	CProfilerZone profilerZone(m_eeProfilerZone);
 #endif
+	CBenchmarkTimer benchmarkTimer(m_benchmarkRunning ? &m_benchmarkFrame.eeTime : nullptr);
 
 	while(m_eeExecutionTicks > 0)
 	{
@@ -727,8 +1245,11 @@ void CPS2VM::UpdateEe()
 		}
 		m_cpuUtilisation.eeTotalTicks += executed;
 
-		m_ee->m_vpu0->Execute(m_singleStepVu0 ? 1 : executed);
-		m_ee->m_vpu1->Execute(m_singleStepVu1 ? 1 : executed);
+		{
+			CBenchmarkTimer vuBenchmarkTimer(m_benchmarkRunning ? &m_benchmarkFrame.vuTime : nullptr);
+			m_ee->m_vpu0->Execute(m_singleStepVu0 ? 1 : executed);
+			m_ee->m_vpu1->Execute(m_singleStepVu1 ? 1 : executed);
+		}
 
 		m_eeExecutionTicks -= executed;
 		m_spuUpdateTicks -= (static_cast<int64>(executed) << SPU_UPDATE_TICKS_PRECISION);
@@ -749,6 +1270,13 @@ void CPS2VM::UpdateIop()
 	CProfilerZone profilerZone(m_iopProfilerZone);
 #endif
 
+	ExecuteIopSlice();
+}
+
+void CPS2VM::ExecuteIopSlice()
+{
+	CBenchmarkTimer benchmarkTimer(m_benchmarkRunning ? &m_benchmarkFrame.iopTime : nullptr);
+
 	while(m_iopExecutionTicks > 0)
 	{
 		int executed = m_iop->ExecuteCpu(m_singleStepIop ? 1 : m_iopExecutionTicks);
@@ -769,11 +1297,119 @@ void CPS2VM::UpdateIop()
 	}
 }
 
+bool CPS2VM::CanRunIopThreaded() const
+{
+#if defined(__APPLE__)
+	//EE RAM access faults are handled on a separate thread on these platforms
+	//and can't be attributed to the IOP thread
+	return false;
+#else
+	if(!m_iopThreaded) return false;
+#ifdef DEBUGGER_INCLUDED
+	if(m_singleStepEe || m_singleStepIop || m_singleStepVu0 || m_singleStepVu1) return false;
+#endif
+	return true;
+#endif
+}
+
+void CPS2VM::BeginIopSlice()
+{
+	if(!m_iopThread.joinable())
+	{
+		m_iopThreadEnd = false;
+		m_iopThread = std::thread([&]() { IopThreadProc(); });
+		Framework::ThreadUtils::SetThreadName(m_iopThread, IOP_THREAD_NAME);
+	}
+	{
+		std::lock_guard<std::mutex> iopThreadLock(m_iopThreadMutex);
+		assert(!m_iopSliceRunning);
+		m_iopSliceRunning = true;
+	}
+	m_iopThreadCondVar.notify_all();
+}
+
+void CPS2VM::WaitForIopSlice()
+{
+	assert(std::this_thread::get_id() != m_iopThread.get_id());
+	//Slices are short, try to avoid going to sleep
+	for(unsigned int i = 0; i < IOP_THREAD_SPIN_COUNT; i++)
+	{
+		if(!m_iopSliceRunning) return;
+	}
+	std::unique_lock<std::mutex> iopThreadLock(m_iopThreadMutex);
+	m_iopThreadCondVar.wait(iopThreadLock, [this]() { return !m_iopSliceRunning; });
+}
+
+void CPS2VM::EndIopSlice()
+{
+	WaitForIopSlice();
+	//Clear EE blocks that were overwritten by the IOP while the EE was running
+	static_cast<CEeExecutor*>(m_ee->m_EE.m_executor.get())->FlushDeferredAccessFaults();
+}
+
+void CPS2VM::StopIopThread()
+{
+	if(!m_iopThread.joinable()) return;
+	WaitForIopSlice();
+	{
+		std::lock_guard<std::mutex> iopThreadLock(m_iopThreadMutex);
+		m_iopThreadEnd = true;
+	}
+	m_iopThreadCondVar.notify_all();
+	m_iopThread.join();
+}
+
+void CPS2VM::IopThreadProc()
+{
+	fesetround(FE_TOWARDZERO);
+	FpUtils::SetDenormalHandlingMode();
+	CProfiler::GetInstance().SetTraceThreadName("IOP");
+#ifdef __ANDROID__
+	JNIEnv* env = nullptr;
+	Framework::CJavaVM::AttachCurrentThread(&env, IOP_THREAD_NAME);
+#endif
+	uint64 affinityMask = 0;
+	while(1)
+	{
+		if(uint64 newAffinityMask = m_threadAffinityMask; newAffinityMask != affinityMask)
+		{
+			SetCurrentThreadAffinity(newAffinityMask);
+			affinityMask = newAffinityMask;
+		}
+		for(unsigned int i = 0; i < IOP_THREAD_SPIN_COUNT; i++)
+		{
+			if(m_iopSliceRunning) break;
+		}
+		{
+			std::unique_lock<std::mutex> iopThreadLock(m_iopThreadMutex);
+			m_iopThreadCondVar.wait(iopThreadLock, [this]() { return m_iopSliceRunning || m_iopThreadEnd; });
+			if(m_iopThreadEnd) break;
+		}
+		{
+#ifdef PROFILE
+			CProfilerTraceZone profilerZone(m_iopProfilerZone);
+#endif
+			uint64 jitTimeBase = CBasicBlock::GetThreadCompileTime();
+			ExecuteIopSlice();
+			m_benchmarkIopThreadJitTime += CBasicBlock::GetThreadCompileTime() - jitTimeBase;
+		}
+		{
+			std::lock_guard<std::mutex> iopThreadLock(m_iopThreadMutex);
+			m_iopSliceRunning = false;
+		}
+		m_iopThreadCondVar.notify_all();
+	}
+#ifdef __ANDROID__
+	Framework::CJavaVM::DetachCurrentThread();
+#endif
+}
+
 void CPS2VM::UpdateSpu()
 {
 #ifdef PROFILE
 	CProfilerZone profilerZone(m_spuProfilerZone);
 #endif
+	CBenchmarkTimer benchmarkTimer(m_benchmarkRunning ? &m_benchmarkFrame.spuTime : nullptr);
 
 	unsigned int blockOffset = (BLOCK_SIZE * m_currentSpuBlock);
 	int16* samplesSpu0 = m_samples + blockOffset;
@@ -853,6 +1489,13 @@ void CPS2VM::RegisterModulesInPadHandler()
 	m_pad->RemoveAllListeners();
 	m_pad->InsertListener(iopOs->GetPadman());
 	m_pad->InsertListener(&m_iop->m_sio2);
+	m_iop->m_sio2.SetPollHandler(GetPadPollHandler());
+	if(m_inputRecorder)
+	{
+		m_pad->InsertListener(m_inputRecorder.get());
+	}
+	//Recordings hold pad states sampled at vblank, keep using those while recording to make sure replays match
+	m_pad->SetPollingEnabled(!m_inputRecorder);
 
 	{
 		auto device = iopOs->GetUsbd()->GetDevice<Iop::CBuzzerUsbDevice>();
@@ -860,6 +1503,17 @@ void CPS2VM::RegisterModulesInPadHandler()
 	}
 }
 
+CPadInterface::PollHandler CPS2VM::GetPadPollHandler()
+{
+	return [this](CPadInterface* listener) { PollPad(listener); };
+}
+
+void CPS2VM::PollPad(CPadInterface* listener)
+{
+	if(!m_pad || !m_pad->IsPollingEnabled()) return;
+	m_pad->Poll(listener, m_ee->m_ram);
+}
+
 void CPS2VM::ReloadExecutable(const char* executablePath, const CPS2OS::ArgumentList& arguments)
 {
 	{
@@ -886,12 +1540,26 @@ void CPS2VM::OnCrtModeChange()
 	ReloadFrameRateLimit();
 }
 
+void CPS2VM::UpdateTurboIo()
+{
+	//Game config is applied before executable change is signaled, games can opt out from there
+	bool turboIoEnabled = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_TURBO_IO) && !m_ee->m_os->IsTurboIoDisabled();
+
+	auto iopOs = dynamic_cast<CIopBios*>(m_iop->m_bios.get());
+	assert(iopOs);
+
+	iopOs->GetCdvdman()->SetTurboIoEnabled(turboIoEnabled);
+	iopOs->GetCdvdfsv()->SetTurboIoEnabled(turboIoEnabled);
+	iopOs->GetMcServ()->SetTurboIoEnabled(turboIoEnabled);
+}
+
 void CPS2VM::EmuThread()
 {
 	CreateVM();
 	fesetround(FE_TOWARDZERO);
 	FpUtils::SetDenormalHandlingMode();
 	CProfiler::GetInstance().SetWorkThread();
+	CProfiler::GetInstance().SetTraceThreadName("EE");
 #ifdef __ANDROID__
 	JNIEnv* env = nullptr;
 	Framework::CJavaVM::AttachCurrentThread(&env, THREAD_NAME);
@@ -945,22 +1613,48 @@ void CPS2VM::EmuThread()
 #ifdef PROFILE
 							CProfilerZone profilerZone(m_gsSyncProfilerZone);
 #endif
+							CBenchmarkTimer benchmarkTimer(m_benchmarkRunning ? &m_benchmarkFrame.gsSyncTime : nullptr);
 							m_ee->m_gs->SetVBlank();
+							m_gsImageStagingStats = m_ee->m_gs->GetImageStagingStats();
+							m_ee->m_gs->ResetImageStagingStats();
 						}
 
+						m_sifRpcServerStats = m_ee->m_sif.GetRpcServerStats();
+						m_ee->m_sif.ResetRpcServerStats();
+
 						if(m_pad != NULL)
 						{
 							m_pad->Update(m_ee->m_ram);
+							m_inputLatencyStats = m_pad->GetInputLatencyStats();
+							m_pad->ResetInputLatencyStats();
+						}
+						if(m_inputRecorder)
+						{
+							m_inputRecorder->EndFrame();
 						}
 #ifdef PROFILE
 						//Finish up profile
 						CProfiler::GetInstance().CountCurrentZone();
 #endif
+						UpdateVuProgramCacheStats();
+						UpdateAsyncIoStats();
 						OnNewFrame();
+						if(m_benchmarkRunning)
+						{
+							UpdateBenchmark();
+						}
 #ifdef PROFILE
 						CProfiler::GetInstance().Reset();
+						if(CProfiler::GetInstance().NotifyTraceFrame())
+						{
+							SaveTrace();
+						}
 #endif
 						m_cpuUtilisation = CPU_UTILISATION_INFO();
+						m_schedulerStats = SCHEDULER_STATS();
+						m_frameSkipStats = FRAME_SKIP_STATS();
+						m_frameLimiter.ResetPacingStats();
+						m_inputLatencyStats = CPadHandler::INPUT_LATENCY_STATS();
 					}
 					else
 					{
@@ -972,15 +1666,40 @@ void CPS2VM::EmuThread()
 							m_ee->m_gs->ResetVBlank();
 						}
 						m_frameLimiter.EndFrame();
+						UpdateFrameSkip();
 						m_frameLimiter.BeginFrame();
 					}
 				}
 
-				m_eeExecutionTicks += m_eeTickStep;
-				m_iopExecutionTicks += m_iopTickStep;
+				{
+					int eeTimeSlice = ComputeEeTimeSlice();
+					int iopTimeSlice = (eeTimeSlice == m_eeTickStep) ? m_iopTickStep : static_cast<int>(static_cast<int64>(eeTimeSlice) * m_iopTickStep / m_eeTickStep);
+					m_eeExecutionTicks += eeTimeSlice;
+					m_iopExecutionTicks += iopTimeSlice;
+
+					m_schedulerStats.sliceCount++;
+					m_schedulerStats.sliceTicks += eeTimeSlice;
+					m_schedulerStats.maxSliceTicks = std::max(m_schedulerStats.maxSliceTicks, eeTimeSlice);
+				}
+
+				if(CanRunIopThreaded())
+				{
+					//IOP runs its time slice on its own thread while the EE runs. The EE will wait for
+					//the IOP before the end of its slice if it needs to access IOP state (ie.: SIF DMA).
+					BeginIopSlice();
+					UpdateEe();
+					EndIopSlice();
+				}
+				else
+				{
+					UpdateEe();
+					UpdateIop();
+				}
 
-				UpdateEe();
-				UpdateIop();
+				if(m_adaptiveTimeSlicing)
+				{
+					UpdateTimeSliceScale();
+				}
 			}
 #ifdef DEBUGGER_INCLUDED
 			if(
@@ -1000,6 +1719,7 @@ void CPS2VM::EmuThread()
 #endif
 		}
 	}
+	StopIopThread();
 	static_cast<CEeExecutor*>(m_ee->m_EE.m_executor.get())->RemoveExceptionHandler();
 #ifdef __ANDROID__
 	Framework::CJavaVM::DetachCurrentThread();
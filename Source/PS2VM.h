@@ -2,6 +2,9 @@
 
 #include <thread>
 #include <future>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "filesystem_def.h"
 #include "Types.h"
 #include "MIPS.h"
@@ -11,10 +14,15 @@
 #include "OpticalMedia.h"
 #include "VirtualMachine.h"
 #include "ee/Ee_SubSystem.h"
+#include "ee/VuExecutor.h"
 #include "iop/Iop_SubSystem.h"
+#include "iop/ioman/AsyncIoEngine.h"
 #include "../tools/PsfPlayer/Source/SoundHandler.h"
 #include "FrameLimiter.h"
+#include "FrameSkipper.h"
 #include "Profiler.h"
+#include "EthernetSwitch.h"
+#include "InputRecording.h"
 
 class CPS2VM : public CVirtualMachine
 {
@@ -28,6 +36,33 @@ public:
 		int32 iopIdleTicks = 0;
 	};
 
+	struct SCHEDULER_STATS
+	{
+		int32 sliceCount = 0;
+		int32 sliceTicks = 0;
+		int32 maxSliceTicks = 0;
+		int32 sifSyncCount = 0;
+	};
+
+	struct FRAME_SKIP_STATS
+	{
+		int32 renderedFrames = 0;
+		int32 skippedFrames = 0;
+	};
+
+	//All times are in nanoseconds, JIT compilation time is also included in the time of the unit that triggered it
+	struct BENCHMARK_FRAME
+	{
+		uint64 frameTime = 0;
+		uint64 eeTime = 0;
+		uint64 iopTime = 0;
+		uint64 vuTime = 0;
+		uint64 gsSyncTime = 0;
+		uint64 spuTime = 0;
+		uint64 jitTime = 0;
+	};
+	typedef std::vector<BENCHMARK_FRAME> BenchmarkFrameArray;
+
 	typedef std::unique_ptr<COpticalMedia> OpticalMediaPtr;
 	typedef std::unique_ptr<Ee::CSubSystem> EeSubSystemPtr;
 	typedef std::unique_ptr<Iop::CSubSystem> IopSubSystemPtr;
@@ -35,7 +70,7 @@ public:
 	typedef std::function<void(CPS2VM*)> ExecutableReloadedHandler;
 
 	CPS2VM();
-	virtual ~CPS2VM() = default;
+	virtual ~CPS2VM();
 
 	void Initialize();
 	void Destroy();
@@ -59,6 +94,8 @@ public:
 	void CreatePadHandler(const CPadHandler::FactoryFunction&);
 	CPadHandler* GetPadHandler();
 	void DestroyPadHandler();
+	//Lets pad interfaces sample the latest pad states when the game reads them
+	CPadInterface::PollHandler GetPadPollHandler();
 
 	void CreateSoundHandler(const CSoundHandler::FactoryFunction&);
 	CSoundHandler* GetSoundHandler();
@@ -78,6 +115,30 @@ public:
 	std::future<bool> LoadState(const fs::path&);
 
 	CPU_UTILISATION_INFO GetCpuUtilisationInfo() const;
+	SCHEDULER_STATS GetSchedulerStats() const;
+	FRAME_SKIP_STATS GetFrameSkipStats() const;
+	CFrameLimiter::PACING_STATS GetFramePacingStats() const;
+	CPadHandler::INPUT_LATENCY_STATS GetInputLatencyStats() const;
+	CGsStagingArena::STATS GetGsImageStagingStats() const;
+	CSIF::RpcServerStatsMap GetSifRpcServerStats() const;
+	CVuExecutor::PROGRAM_CACHE_STATS GetVuProgramCacheStats() const;
+	Iop::Ioman::CAsyncIoEngine::DeviceStatsMap GetAsyncIoStats() const;
+
+	std::future<BenchmarkFrameArray> RunBenchmark(uint32);
+
+	void StartInputRecording();
+	CInputRecording StopInputRecording();
+
+	//Block statistics are only gathered when enabled in preferences
+	std::future<bool> SaveBlockStatsReport(const fs::path&);
+
+	//Lists idle loops detected since the last reset, EE ones are written as GameConfig entries
+	std::future<bool> SaveIdleLoopReport(const fs::path&);
+
+#ifdef PROFILE
+	static fs::path GetTraceDirectoryPath();
+	std::future<bool> CaptureTrace(const fs::path&, uint32);
+#endif
 
 #ifdef DEBUGGER_INCLUDED
 	fs::path MakeDebugTagsPackagePath(const char*);
@@ -94,6 +155,12 @@ public:
 	void SetTouchListener(CScreenPositionListener*);
 	void ReleaseScreenPosition();
 
+	bool ConnectEthernetSwitch(const std::shared_ptr<CEthernetSwitch>&);
+	void DisconnectEthernetSwitch();
+
+	//Restricts the EE, IOP and GS threads to a set of host CPUs (0 removes the restriction)
+	void SetThreadAffinity(uint64);
+
 	OpticalMediaPtr m_cdrom0;
 	CPadHandler* m_pad = nullptr;
 
@@ -119,11 +186,18 @@ private:
 	bool SaveVMState(const fs::path&);
 	bool LoadVMState(const fs::path&);
 
+#ifdef PROFILE
+	void SaveTrace();
+#endif
+
+	void UpdateBenchmark();
+
 	void SaveVmTimingState(Framework::CZipArchiveWriter&);
 	void LoadVmTimingState(Framework::CZipArchiveReader&);
 
 	void ReloadExecutable(const char*, const CPS2OS::ArgumentList&);
 	void OnCrtModeChange();
+	void UpdateTurboIo();
 
 	void PauseImpl();
 	void DestroyImpl();
@@ -139,17 +213,33 @@ private:
 
 	void ReloadSpuBlockCountImpl();
 
+	int ComputeEeTimeSlice() const;
+	void UpdateTimeSliceScale();
+	void UpdateFrameSkip();
+
 	void UpdateEe();
 	void UpdateIop();
+	void ExecuteIopSlice();
+	void UpdateVuProgramCacheStats();
+	void UpdateAsyncIoStats();
 	void UpdateSpu();
 
+	bool CanRunIopThreaded() const;
+	void BeginIopSlice();
+	void WaitForIopSlice();
+	void EndIopSlice();
+	void StopIopThread();
+	void IopThreadProc();
+
 	void SetIopOpticalMedia(COpticalMedia*);
 
 	void RegisterModulesInPadHandler();
+	void PollPad(CPadInterface*);
 
 	void EmuThread();
 
 	std::thread m_thread;
+	std::atomic<uint64> m_threadAffinityMask = 0;
 	STATUS m_nStatus = PAUSED;
 	bool m_nEnd = false;
 
@@ -171,7 +261,41 @@ private:
 	int m_iopTickStep = 0;
 	CFrameLimiter m_frameLimiter;
 
+	//Automatic frame skipping parameters
+	bool m_autoFrameSkip = false;
+	CFrameSkipper m_frameSkipper;
+
+	//Adaptive time slicing parameters
+	enum
+	{
+		MAX_TIME_SLICE_SCALE = 4,
+	};
+
+	bool m_adaptiveTimeSlicing = false;
+	int m_timeSliceScale = 1;
+	uint32 m_lastSifTransferCount = 0;
+
+	//Threaded IOP parameters
+	enum
+	{
+		IOP_THREAD_SPIN_COUNT = 0x4000,
+	};
+
+	bool m_iopThreaded = false;
+	std::thread m_iopThread;
+	std::mutex m_iopThreadMutex;
+	std::condition_variable m_iopThreadCondVar;
+	std::atomic<bool> m_iopSliceRunning = false;
+	bool m_iopThreadEnd = false;
+
 	CPU_UTILISATION_INFO m_cpuUtilisation;
+	SCHEDULER_STATS m_schedulerStats;
+	FRAME_SKIP_STATS m_frameSkipStats;
+	CPadHandler::INPUT_LATENCY_STATS m_inputLatencyStats;
+	CGsStagingArena::STATS m_gsImageStagingStats;
+	CSIF::RpcServerStatsMap m_sifRpcServerStats;
+	CVuExecutor::PROGRAM_CACHE_STATS m_vuProgramCacheStats;
+	Iop::Ioman::CAsyncIoEngine::DeviceStatsMap m_asyncIoStats;
 
 	bool m_singleStepEe = false;
 	bool m_singleStepIop = false;
@@ -196,12 +320,33 @@ private:
 	CScreenPositionListener* m_gunListener = nullptr;
 	CScreenPositionListener* m_touchListener = nullptr;
 
+	CEthernetSwitch::PortPtr m_ethernetPort;
+	std::vector<uint8> m_ethernetRxFrame;
+
+	//Benchmark parameters
+	std::shared_ptr<std::promise<BenchmarkFrameArray>> m_benchmarkPromise;
+	BenchmarkFrameArray m_benchmarkFrames;
+	BENCHMARK_FRAME m_benchmarkFrame;
+	uint32 m_benchmarkFrameCount = 0;
+	bool m_benchmarkRunning = false;
+	bool m_benchmarkStarted = false;
+	std::chrono::steady_clock::time_point m_benchmarkFrameStartTime;
+	uint64 m_benchmarkJitTimeBase = 0;
+	uint64 m_benchmarkIopThreadJitTime = 0;
+
+	std::unique_ptr<CInputRecorder> m_inputRecorder;
+
 	CProfiler::ZoneHandle m_eeProfilerZone = 0;
 	CProfiler::ZoneHandle m_iopProfilerZone = 0;
 	CProfiler::ZoneHandle m_spuProfilerZone = 0;
 	CProfiler::ZoneHandle m_gsSyncProfilerZone = 0;
 	CProfiler::ZoneHandle m_otherProfilerZone = 0;
+#ifdef PROFILE
+	fs::path m_tracePath;
+	std::shared_ptr<std::promise<bool>> m_tracePromise;
+#endif
 
 	CPS2OS::RequestLoadExecutableEvent::Connection m_OnRequestLoadExecutableConnection;
 	Framework::CSignal<void()>::Connection m_OnCrtModeChangeConnection;
+	Framework::CSignal<void()>::Connection m_OnExecutableChangeConnection;
 };
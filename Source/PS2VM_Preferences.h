@@ -13,6 +13,14 @@
 #define PREF_PS2_ARCADE_IO_SERVER_PORT ("ps2.arcade.ioserver.port")
 
 #define PREF_PS2_LIMIT_FRAMERATE ("ps2.limitframerate")
+#define PREF_PS2_LATE_LATCH ("ps2.latelatch")
+#define PREF_PS2_ADAPTIVE_TIMESLICING ("ps2.adaptivetimeslicing")
+#define PREF_PS2_IOP_THREADED ("ps2.iopthreaded")
+#define PREF_PS2_JIT_BLOCKSTATS ("ps2.jit.blockstats")
+#define PREF_PS2_JIT_IDLELOOPDETECTION ("ps2.jit.idleloopdetection")
+#define PREF_PS2_FRAMESKIP_AUTO ("ps2.frameskip.auto")
+#define PREF_PS2_FRAMESKIP_MAX_CONSECUTIVE ("ps2.frameskip.maxconsecutive")
+#define PREF_PS2_TURBO_IO ("ps2.turboio")
 
 #define PREF_AUDIO_SPUBLOCKCOUNT ("audio.spublockcount")
 
@@ -11,7 +11,42 @@ bool CPadHandler::HasListener(CPadInterface* listener) const
 	return std::find(m_interfaces.begin(), m_interfaces.end(), listener) != m_interfaces.end();
 }
 
+void CPadHandler::RemoveListener(CPadInterface* listener)
+{
+	m_interfaces.remove(listener);
+}
+
 void CPadHandler::RemoveAllListeners()
 {
 	m_interfaces.clear();
 }
+
+void CPadHandler::SetPollingEnabled(bool pollingEnabled)
+{
+	m_pollingEnabled = pollingEnabled;
+}
+
+bool CPadHandler::IsPollingEnabled() const
+{
+	return m_pollingEnabled;
+}
+
+CPadHandler::INPUT_LATENCY_STATS CPadHandler::GetInputLatencyStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_inputLatencyStatsMutex);
+	return m_inputLatencyStats;
+}
+
+void CPadHandler::ResetInputLatencyStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_inputLatencyStatsMutex);
+	m_inputLatencyStats = INPUT_LATENCY_STATS();
+}
+
+void CPadHandler::RecordInputLatency(uint64 latency)
+{
+	std::lock_guard<std::mutex> statsLock(m_inputLatencyStatsMutex);
+	m_inputLatencyStats.eventCount++;
+	m_inputLatencyStats.totalLatency += latency;
+	m_inputLatencyStats.maxLatency = std::max(m_inputLatencyStats.maxLatency, latency);
+}
@@ -3,20 +3,53 @@
 #include "PadInterface.h"
 #include <list>
 #include <functional>
+#include <mutex>
+#include <atomic>
 
 class CPadHandler
 {
 public:
 	typedef std::function<CPadHandler*(void)> FactoryFunction;
 
+	//Time between the moment a host input event was received and the moment the game read it, in microseconds
+	struct INPUT_LATENCY_STATS
+	{
+		uint32 eventCount = 0;
+		uint64 totalLatency = 0;
+		uint64 maxLatency = 0;
+	};
+
 	CPadHandler() = default;
 	virtual ~CPadHandler() = default;
 	virtual void Update(uint8*) = 0;
+	//Pushes the latest pad states to a single listener when the game is about to read them.
+	//Handlers that can't provide more recent states than the ones pushed by Update don't need to do anything.
+	virtual void Poll(CPadInterface*, uint8*)
+	{
+	}
 	void InsertListener(CPadInterface*);
 	bool HasListener(CPadInterface*) const;
+	void RemoveListener(CPadInterface*);
 	void RemoveAllListeners();
 
+	//When polling is enabled, listeners with a poll handler only receive states through Poll.
+	//This makes sure that a listener's states are only written by the thread that reads them.
+	void SetPollingEnabled(bool);
+	bool IsPollingEnabled() const;
+
+	INPUT_LATENCY_STATS GetInputLatencyStats();
+	void ResetInputLatencyStats();
+
 protected:
 	typedef std::list<CPadInterface*> ListenerList;
 	ListenerList m_interfaces;
+
+	void RecordInputLatency(uint64);
+
+private:
+	//Poll can be called from the IOP thread
+	std::mutex m_inputLatencyStatsMutex;
+	INPUT_LATENCY_STATS m_inputLatencyStats;
+
+	std::atomic<bool> m_pollingEnabled = false;
 };
@@ -33,3 +33,21 @@ uint32 CPadInterface::GetButtonMask(CControllerInfo::BUTTON button)
 	assert(result != -1);
 	return result;
 }
+
+void CPadInterface::SetPollHandler(const PollHandler& pollHandler)
+{
+	m_pollHandler = pollHandler;
+}
+
+bool CPadInterface::HasPollHandler() const
+{
+	return static_cast<bool>(m_pollHandler);
+}
+
+void CPadInterface::Poll()
+{
+	if(m_pollHandler)
+	{
+		m_pollHandler(this);
+	}
+}
@@ -1,14 +1,27 @@
 #pragma once
 
+#include <functional>
 #include "Types.h"
 #include "ControllerInfo.h"
 
 class CPadInterface
 {
 public:
+	typedef std::function<void(CPadInterface*)> PollHandler;
+
 	virtual ~CPadInterface() = default;
 	virtual void SetButtonState(unsigned int, PS2::CControllerInfo::BUTTON, bool, uint8*) = 0;
 	virtual void SetAxisState(unsigned int, PS2::CControllerInfo::BUTTON, uint8, uint8*) = 0;
 	virtual void GetVibration(unsigned int, uint8& largeMotor, uint8& smallMotor) = 0;
 	static uint32 GetButtonMask(PS2::CControllerInfo::BUTTON);
+
+	void SetPollHandler(const PollHandler&);
+	bool HasPollHandler() const;
+
+protected:
+	//Called right before the game reads pad states, gives a chance to the pad handler to provide the latest ones
+	void Poll();
+
+private:
+	PollHandler m_pollHandler;
 };
@@ -1,107 +1,432 @@
-#include "Profiler.h"
-
-#include <cassert>
-
-CProfiler::ZoneHandle CProfiler::RegisterZone(const char* name)
-{
-#ifdef PROFILE
-	for(unsigned int i = 0; i < m_zones.size(); i++)
-	{
-		const auto& zone(m_zones[i]);
-		if(zone.name == name) return i;
-	}
-	auto newZone = ZONE();
-	newZone.name = name;
-	newZone.totalTime = 0;
-	m_zones.push_back(newZone);
-	return static_cast<CProfiler::ZoneHandle>(m_zones.size() - 1);
-#else
-	return 0;
-#endif
-}
-
-void CProfiler::CountCurrentZone()
-{
-	assert(std::this_thread::get_id() == m_workThreadId);
-	assert(!m_zoneStack.empty());
-
-	auto thisTime = std::chrono::high_resolution_clock::now();
-
-	{
-		auto topZoneHandle = m_zoneStack.top();
-		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(thisTime - m_currentTime);
-		AddTimeToZone(topZoneHandle, duration.count());
-	}
-
-	m_currentTime = thisTime;
-}
-
-void CProfiler::EnterZone(ZoneHandle zoneHandle)
-{
-	assert(std::this_thread::get_id() == m_workThreadId);
-
-	auto thisTime = std::chrono::high_resolution_clock::now();
-
-	if(!m_zoneStack.empty())
-	{
-		auto topZoneHandle = m_zoneStack.top();
-		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(thisTime - m_currentTime);
-		AddTimeToZone(topZoneHandle, duration.count());
-	}
-
-	m_zoneStack.push(zoneHandle);
-
-	m_currentTime = thisTime;
-}
-
-void CProfiler::ExitZone()
-{
-	CountCurrentZone();
-	m_zoneStack.pop();
-}
-
-CProfiler::ZoneArray CProfiler::GetStats() const
-{
-	assert(std::this_thread::get_id() == m_workThreadId);
-	return m_zones;
-}
-
-void CProfiler::Reset()
-{
-	assert(std::this_thread::get_id() == m_workThreadId);
-	for(auto& zone : m_zones)
-	{
-		zone.totalTime = 0;
-	}
-}
-
-void CProfiler::SetWorkThread()
-{
-#ifndef NDEBUG
-	m_workThreadId = std::this_thread::get_id();
-#endif
-}
-
-void CProfiler::AddTimeToZone(ZoneHandle zoneHandle, uint64 timeNs)
-{
-	assert(m_zones.size() > zoneHandle);
-	auto& zone = m_zones[zoneHandle];
-	zone.totalTime += timeNs;
-}
-
-//////////////////////////////////////////////////////////////////////////
-//CProfilerZone
-
-CProfilerZone::CProfilerZone(CProfiler::ZoneHandle handle)
-{
-#ifdef PROFILE
-	CProfiler::GetInstance().EnterZone(handle);
-#endif
-}
-
-CProfilerZone::~CProfilerZone()
-{
-#ifdef PROFILE
-	CProfiler::GetInstance().ExitZone();
-#endif
-}
+#include "Profiler.h"
+
+#include <cassert>
+#include <algorithm>
+#include "string_format.h"
+
+//Frame events don't belong to a registered zone
+static const CProfiler::ZoneHandle g_traceFrameZone = ~0U;
+
+static uint64 GetTraceTime()
+{
+	auto time = std::chrono::high_resolution_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+static std::string EscapeJsonString(const std::string& text)
+{
+	std::string result;
+	result.reserve(text.size());
+	for(auto character : text)
+	{
+		switch(character)
+		{
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		default:
+			if(static_cast<uint8>(character) < 0x20)
+			{
+				result += string_format("\\u%04x", static_cast<uint8>(character));
+			}
+			else
+			{
+				result += character;
+			}
+			break;
+		}
+	}
+	return result;
+}
+
+CProfiler::ZoneHandle CProfiler::RegisterZone(const char* name)
+{
+#ifdef PROFILE
+	std::lock_guard<std::mutex> zonesLock(m_zonesMutex);
+	for(unsigned int i = 0; i < m_zones.size(); i++)
+	{
+		const auto& zone(m_zones[i]);
+		if(zone.name == name) return i;
+	}
+	assert(m_zones.size() < MAX_ZONE_COUNT);
+	auto newZone = ZONE();
+	newZone.name = name;
+	newZone.totalTime = 0;
+	m_zones.push_back(newZone);
+	return static_cast<CProfiler::ZoneHandle>(m_zones.size() - 1);
+#else
+	return 0;
+#endif
+}
+
+void CProfiler::CountCurrentZone()
+{
+	auto& threadState = GetThreadState();
+	assert(!threadState.zoneStack.empty());
+
+	auto thisTime = std::chrono::high_resolution_clock::now();
+
+	if(IsEnabled())
+	{
+		auto topZoneHandle = threadState.zoneStack.top();
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(thisTime - threadState.currentTime);
+		AddTimeToZone(topZoneHandle, duration.count());
+	}
+
+	threadState.currentTime = thisTime;
+}
+
+void CProfiler::EnterZone(ZoneHandle zoneHandle)
+{
+	auto& threadState = GetThreadState();
+
+	auto thisTime = std::chrono::high_resolution_clock::now();
+
+	if(!threadState.zoneStack.empty() && IsEnabled())
+	{
+		auto topZoneHandle = threadState.zoneStack.top();
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(thisTime - threadState.currentTime);
+		AddTimeToZone(topZoneHandle, duration.count());
+	}
+
+	threadState.zoneStack.push(zoneHandle);
+
+	threadState.currentTime = thisTime;
+
+	BeginTraceZone(zoneHandle);
+}
+
+void CProfiler::ExitZone()
+{
+	CountCurrentZone();
+	auto& threadState = GetThreadState();
+	EndTraceZone(threadState.zoneStack.top());
+	threadState.zoneStack.pop();
+}
+
+CProfiler::ZoneArray CProfiler::GetStats() const
+{
+	if(!IsEnabled()) return ZoneArray();
+	assert(std::this_thread::get_id() == m_workThreadId);
+	std::lock_guard<std::mutex> zonesLock(m_zonesMutex);
+	auto zoneTimes = CollectZoneTimes();
+	auto zones = m_zones;
+	for(uint32 i = 0; i < zones.size(); i++)
+	{
+		zones[i].totalTime = zoneTimes[i] - m_resetZoneTimes[i];
+	}
+	return zones;
+}
+
+void CProfiler::Reset()
+{
+	if(!IsEnabled()) return;
+	assert(std::this_thread::get_id() == m_workThreadId);
+	std::lock_guard<std::mutex> zonesLock(m_zonesMutex);
+	//Thread totals are never cleared since their owners might be updating them
+	m_resetZoneTimes = CollectZoneTimes();
+}
+
+void CProfiler::SetWorkThread()
+{
+#ifndef NDEBUG
+	if(!IsEnabled()) return;
+	m_workThreadId = std::this_thread::get_id();
+#endif
+}
+
+void CProfiler::AddInstance()
+{
+	if(m_instanceCount.fetch_add(1) != 0)
+	{
+		m_disabled = true;
+	}
+}
+
+void CProfiler::RemoveInstance()
+{
+	assert(m_instanceCount != 0);
+	m_instanceCount--;
+}
+
+bool CProfiler::IsEnabled() const
+{
+	return !m_disabled.load(std::memory_order_relaxed);
+}
+
+void CProfiler::SetTraceThreadName(const char* name)
+{
+#ifdef PROFILE
+	auto& threadState = GetThreadState();
+	threadState.traceThreadName = name;
+	if(threadState.traceBuffer)
+	{
+		std::lock_guard<std::mutex> traceBuffersLock(m_traceBuffersMutex);
+		threadState.traceBuffer->threadName = name;
+	}
+#endif
+}
+
+//Returns false if the trace can't be recorded
+bool CProfiler::StartTrace(uint32 frameCount)
+{
+	if(!IsEnabled()) return false;
+	assert(std::this_thread::get_id() == m_workThreadId);
+	assert(frameCount != 0);
+	m_traceFrameCount = frameCount;
+	m_traceState = TRACE_STATE_ARMED;
+	return true;
+}
+
+//Called by the work thread at the start of every frame, returns true when a trace was completed
+bool CProfiler::NotifyTraceFrame()
+{
+	if(!IsEnabled()) return false;
+	assert(std::this_thread::get_id() == m_workThreadId);
+	switch(m_traceState)
+	{
+	case TRACE_STATE_ARMED:
+	{
+		{
+			//Free buffers of threads that are gone
+			std::lock_guard<std::mutex> traceBuffersLock(m_traceBuffersMutex);
+			m_traceBuffers.erase(std::remove_if(std::begin(m_traceBuffers), std::end(m_traceBuffers),
+			                                    [](const auto& traceBuffer) { return traceBuffer->released.load(std::memory_order_acquire); }),
+			                     std::end(m_traceBuffers));
+		}
+		//Buffers from the previous trace will be reset by their owners on their next event
+		m_traceEpoch++;
+		m_traceDroppedEventCount = 0;
+		m_traceFramesLeft = m_traceFrameCount;
+		m_traceState = TRACE_STATE_RECORDING;
+		BeginTraceZone(g_traceFrameZone);
+		return false;
+	}
+	case TRACE_STATE_RECORDING:
+		EndTraceZone(g_traceFrameZone);
+		m_traceFramesLeft--;
+		if(m_traceFramesLeft == 0)
+		{
+			m_traceState = TRACE_STATE_COMPLETE;
+			return true;
+		}
+		BeginTraceZone(g_traceFrameZone);
+		return false;
+	default:
+		return false;
+	}
+}
+
+bool CProfiler::IsTraceComplete() const
+{
+	return m_traceState == TRACE_STATE_COMPLETE;
+}
+
+//Writes events in the Chrome trace event format (can be loaded by Perfetto)
+void CProfiler::WriteTrace(Framework::CStream& stream) const
+{
+	assert(IsTraceComplete());
+
+	std::vector<std::string> zoneNames;
+	{
+		std::lock_guard<std::mutex> zonesLock(m_zonesMutex);
+		for(const auto& zone : m_zones)
+		{
+			zoneNames.push_back(EscapeJsonString(zone.name));
+		}
+	}
+
+	auto writeString =
+	    [&stream](const std::string& text) {
+		    stream.Write(text.c_str(), text.size());
+	    };
+
+	std::lock_guard<std::mutex> traceBuffersLock(m_traceBuffersMutex);
+
+	uint32 traceEpoch = m_traceEpoch;
+	uint64 baseTime = ~0ULL;
+	for(const auto& traceBuffer : m_traceBuffers)
+	{
+		if(traceBuffer->epoch.load(std::memory_order_acquire) != traceEpoch) continue;
+		if(traceBuffer->eventCount.load(std::memory_order_acquire) == 0) continue;
+		baseTime = std::min(baseTime, traceBuffer->events[0].time);
+	}
+
+	writeString("{\"traceEvents\":[\n");
+	bool first = true;
+	for(const auto& traceBuffer : m_traceBuffers)
+	{
+		if(traceBuffer->epoch.load(std::memory_order_acquire) != traceEpoch) continue;
+		uint32 eventCount = traceBuffer->eventCount.load(std::memory_order_acquire);
+		if(eventCount == 0) continue;
+
+		auto threadName = traceBuffer->threadName.empty() ? string_format("Thread %d", traceBuffer->threadIndex) : traceBuffer->threadName;
+		writeString(string_format("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+		                          first ? "" : ",\n", traceBuffer->threadIndex, EscapeJsonString(threadName).c_str()));
+		first = false;
+
+		for(uint32 i = 0; i < eventCount; i++)
+		{
+			const auto& event = traceBuffer->events[i];
+			const char* zoneName = "Frame";
+			if(event.zone != g_traceFrameZone)
+			{
+				zoneName = (event.zone < zoneNames.size()) ? zoneNames[event.zone].c_str() : "Unknown";
+			}
+			double time = static_cast<double>(event.time - baseTime) / 1000.0;
+			writeString(string_format(",\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+			                          zoneName, (event.type == TRACE_EVENT_BEGIN) ? "B" : "E", traceBuffer->threadIndex, time));
+		}
+	}
+	writeString(string_format("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%d}}\n",
+	                          m_traceDroppedEventCount.load()));
+}
+
+void CProfiler::BeginTraceZone(ZoneHandle zoneHandle)
+{
+	AddTraceEvent(zoneHandle, TRACE_EVENT_BEGIN);
+}
+
+void CProfiler::EndTraceZone(ZoneHandle zoneHandle)
+{
+	AddTraceEvent(zoneHandle, TRACE_EVENT_END);
+}
+
+CProfiler::THREAD_STATE::~THREAD_STATE()
+{
+	if(zoneTimes) zoneTimes->released.store(true, std::memory_order_release);
+	if(traceBuffer) traceBuffer->released.store(true, std::memory_order_release);
+}
+
+CProfiler::THREAD_STATE& CProfiler::GetThreadState()
+{
+	//Each VM instance runs on its own threads, zone nesting is tracked per thread
+	thread_local THREAD_STATE threadState;
+	return threadState;
+}
+
+void CProfiler::AddTimeToZone(ZoneHandle zoneHandle, uint64 timeNs)
+{
+	assert(zoneHandle < MAX_ZONE_COUNT);
+	auto& threadState = GetThreadState();
+	if(!threadState.zoneTimes)
+	{
+		threadState.zoneTimes = std::make_shared<THREAD_ZONE_TIMES>();
+		std::lock_guard<std::mutex> zonesLock(m_zonesMutex);
+		m_threadZoneTimes.push_back(threadState.zoneTimes);
+	}
+	//Only the owner thread writes to this, no need for an atomic add
+	auto& zoneTime = threadState.zoneTimes->zoneTimes[zoneHandle];
+	zoneTime.store(zoneTime.load(std::memory_order_relaxed) + timeNs, std::memory_order_relaxed);
+}
+
+//Must be called with the zones mutex held
+CProfiler::ZoneTimeArray CProfiler::CollectZoneTimes() const
+{
+	ZoneTimeArray result = m_releasedZoneTimes;
+	for(auto threadZoneTimesIterator = std::begin(m_threadZoneTimes);
+	    threadZoneTimesIterator != std::end(m_threadZoneTimes);)
+	{
+		const auto& threadZoneTimes = *threadZoneTimesIterator;
+		bool released = threadZoneTimes->released.load(std::memory_order_acquire);
+		for(uint32 i = 0; i < MAX_ZONE_COUNT; i++)
+		{
+			uint64 zoneTime = threadZoneTimes->zoneTimes[i].load(std::memory_order_relaxed);
+			result[i] += zoneTime;
+			if(released)
+			{
+				//Keep totals of threads that are gone
+				m_releasedZoneTimes[i] += zoneTime;
+			}
+		}
+		if(released)
+		{
+			threadZoneTimesIterator = m_threadZoneTimes.erase(threadZoneTimesIterator);
+		}
+		else
+		{
+			threadZoneTimesIterator++;
+		}
+	}
+	return result;
+}
+
+CProfiler::TRACE_BUFFER* CProfiler::GetThreadTraceBuffer()
+{
+	auto& threadState = GetThreadState();
+	if(threadState.traceBuffer) return threadState.traceBuffer.get();
+
+	threadState.traceBuffer = std::make_shared<TRACE_BUFFER>();
+
+	std::lock_guard<std::mutex> traceBuffersLock(m_traceBuffersMutex);
+	threadState.traceBuffer->threadName = threadState.traceThreadName;
+	threadState.traceBuffer->threadIndex = m_nextTraceThreadIndex++;
+	m_traceBuffers.push_back(threadState.traceBuffer);
+	return threadState.traceBuffer.get();
+}
+
+void CProfiler::AddTraceEvent(ZoneHandle zoneHandle, TRACE_EVENT_TYPE type)
+{
+#ifdef PROFILE
+	if(m_traceState.load(std::memory_order_relaxed) != TRACE_STATE_RECORDING) return;
+
+	auto traceBuffer = GetThreadTraceBuffer();
+	uint32 traceEpoch = m_traceEpoch.load(std::memory_order_acquire);
+	if(traceBuffer->epoch.load(std::memory_order_relaxed) != traceEpoch)
+	{
+		traceBuffer->eventCount.store(0, std::memory_order_relaxed);
+		traceBuffer->epoch.store(traceEpoch, std::memory_order_release);
+	}
+
+	uint32 eventCount = traceBuffer->eventCount.load(std::memory_order_relaxed);
+	if(eventCount == TRACE_BUFFER_SIZE)
+	{
+		m_traceDroppedEventCount++;
+		return;
+	}
+
+	auto& event = traceBuffer->events[eventCount];
+	event.time = GetTraceTime();
+	event.zone = zoneHandle;
+	event.type = type;
+	traceBuffer->eventCount.store(eventCount + 1, std::memory_order_release);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+//CProfilerZone
+
+CProfilerZone::CProfilerZone(CProfiler::ZoneHandle handle)
+{
+#ifdef PROFILE
+	CProfiler::GetInstance().EnterZone(handle);
+#endif
+}
+
+CProfilerZone::~CProfilerZone()
+{
+#ifdef PROFILE
+	CProfiler::GetInstance().ExitZone();
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+//CProfilerTraceZone
+
+CProfilerTraceZone::CProfilerTraceZone(CProfiler::ZoneHandle handle)
+    : m_zone(handle)
+{
+#ifdef PROFILE
+	CProfiler::GetInstance().BeginTraceZone(m_zone);
+#endif
+}
+
+CProfilerTraceZone::~CProfilerTraceZone()
+{
+#ifdef PROFILE
+	CProfiler::GetInstance().EndTraceZone(m_zone);
+#endif
+}
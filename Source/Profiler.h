@@ -1,12 +1,17 @@
 #pragma once
 
 #include <string>
+#include <array>
 #include <stack>
 #include <thread>
 #include <vector>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <memory>
 #include "Singleton.h"
 #include "Types.h"
+#include "Stream.h"
 
 class CProfiler : public CSingleton<CProfiler>
 {
@@ -22,6 +27,7 @@ public:
 	typedef std::vector<ZONE> ZoneArray;
 	typedef std::chrono::high_resolution_clock::time_point TimePoint;
 
+	CProfiler() = default;
 	virtual ~CProfiler() = default;
 
 	ZoneHandle RegisterZone(const char*);
@@ -36,14 +42,111 @@ public:
 
 	void SetWorkThread();
 
+	//Zones and the work thread are shared by all VM instances. The profiler gets disabled
+	//for the rest of the session as soon as more than one instance is alive at the same time.
+	void AddInstance();
+	void RemoveInstance();
+	bool IsEnabled() const;
+
+	//Tracing records zone begin/end events from any thread for a number of frames
+	void SetTraceThreadName(const char*);
+	bool StartTrace(uint32);
+	bool NotifyTraceFrame();
+	bool IsTraceComplete() const;
+	void WriteTrace(Framework::CStream&) const;
+
+	void BeginTraceZone(ZoneHandle);
+	void EndTraceZone(ZoneHandle);
+
 private:
 	typedef std::stack<ZoneHandle> ZoneStack;
 
+	enum
+	{
+		MAX_ZONE_COUNT = 0x40,
+		TRACE_BUFFER_SIZE = 0x40000,
+	};
+
+	typedef std::array<uint64, MAX_ZONE_COUNT> ZoneTimeArray;
+
+	//Only written by its owner thread, merged when stats are requested
+	struct THREAD_ZONE_TIMES
+	{
+		std::atomic<bool> released = false;
+		std::atomic<uint64> zoneTimes[MAX_ZONE_COUNT] = {};
+	};
+
+	enum TRACE_STATE
+	{
+		TRACE_STATE_IDLE,
+		TRACE_STATE_ARMED,
+		TRACE_STATE_RECORDING,
+		TRACE_STATE_COMPLETE,
+	};
+
+	enum TRACE_EVENT_TYPE
+	{
+		TRACE_EVENT_BEGIN,
+		TRACE_EVENT_END,
+	};
+
+	struct TRACE_EVENT
+	{
+		uint64 time;
+		ZoneHandle zone;
+		uint32 type;
+	};
+
+	//Only written by its owner thread, allocated when the thread records its first trace event
+	struct TRACE_BUFFER
+	{
+		std::string threadName;
+		uint32 threadIndex = 0;
+		std::atomic<bool> released = false;
+		std::atomic<uint32> epoch = 0;
+		std::atomic<uint32> eventCount = 0;
+		TRACE_EVENT events[TRACE_BUFFER_SIZE];
+	};
+
+	//Buffers are shared with the profiler and released when their owner thread exits
+	struct THREAD_STATE
+	{
+		~THREAD_STATE();
+
+		ZoneStack zoneStack;
+		TimePoint currentTime;
+		std::string traceThreadName;
+		std::shared_ptr<THREAD_ZONE_TIMES> zoneTimes;
+		std::shared_ptr<TRACE_BUFFER> traceBuffer;
+	};
+
+	typedef std::vector<std::shared_ptr<THREAD_ZONE_TIMES>> ThreadZoneTimesArray;
+	typedef std::vector<std::shared_ptr<TRACE_BUFFER>> TraceBufferArray;
+
+	static THREAD_STATE& GetThreadState();
 	void AddTimeToZone(ZoneHandle, uint64);
+	ZoneTimeArray CollectZoneTimes() const;
 
+	TRACE_BUFFER* GetThreadTraceBuffer();
+	void AddTraceEvent(ZoneHandle, TRACE_EVENT_TYPE);
+
+	mutable std::mutex m_zonesMutex;
 	ZoneArray m_zones;
-	ZoneStack m_zoneStack;
-	TimePoint m_currentTime;
+	mutable ThreadZoneTimesArray m_threadZoneTimes;
+	mutable ZoneTimeArray m_releasedZoneTimes = {};
+	ZoneTimeArray m_resetZoneTimes = {};
+
+	mutable std::mutex m_traceBuffersMutex;
+	TraceBufferArray m_traceBuffers;
+	uint32 m_nextTraceThreadIndex = 0;
+	std::atomic<uint32> m_traceState = TRACE_STATE_IDLE;
+	std::atomic<uint32> m_traceEpoch = 0;
+	std::atomic<uint32> m_traceDroppedEventCount = 0;
+	uint32 m_traceFrameCount = 0;
+	uint32 m_traceFramesLeft = 0;
+
+	std::atomic<uint32> m_instanceCount = 0;
+	std::atomic<bool> m_disabled = false;
 
 #ifndef NDEBUG
 	std::thread::id m_workThreadId;
@@ -56,3 +159,14 @@ public:
 	CProfilerZone(CProfiler::ZoneHandle);
 	~CProfilerZone();
 };
+
+//Only records trace events, can be used on any thread
+class CProfilerTraceZone
+{
+public:
+	CProfilerTraceZone(CProfiler::ZoneHandle);
+	~CProfilerTraceZone();
+
+private:
+	CProfiler::ZoneHandle m_zone = 0;
+};
@@ -1,4 +1,5 @@
 #include "ChdImageStream.h"
+#include <algorithm>
 #include <cstring>
 #include <cassert>
 #include <stdexcept>
@@ -61,17 +62,27 @@ bool CChdImageStream::IsEOF()
 
 uint64 CChdImageStream::Read(void* buffer, uint64 size)
 {
-	uint32 hunkPosition = m_position % m_hunkSize;
-	assert((hunkPosition + size) <= m_hunkSize);
-	uint32 hunkIdx = m_position / m_hunkSize;
-	if(hunkIdx != m_hunkBufferIdx)
+	auto outBuffer = reinterpret_cast<uint8*>(buffer);
+	uint64 totalSize = GetTotalSize();
+	size = (m_position < totalSize) ? std::min<uint64>(size, totalSize - m_position) : 0;
+	uint64 remainSize = size;
+	while(remainSize != 0)
 	{
-		FRAMEWORK_MAYBE_UNUSED chd_error error = chd_read(m_chd, hunkIdx, m_hunkBuffer.data());
-		assert(error == CHDERR_NONE);
-		m_hunkBufferIdx = hunkIdx;
+		//Reads can span multiple hunks (ie.: HDD cache chunks)
+		uint32 hunkPosition = m_position % m_hunkSize;
+		uint32 hunkIdx = m_position / m_hunkSize;
+		if(hunkIdx != m_hunkBufferIdx)
+		{
+			FRAMEWORK_MAYBE_UNUSED chd_error error = chd_read(m_chd, hunkIdx, m_hunkBuffer.data());
+			assert(error == CHDERR_NONE);
+			m_hunkBufferIdx = hunkIdx;
+		}
+		uint64 copySize = std::min<uint64>(remainSize, m_hunkSize - hunkPosition);
+		memcpy(outBuffer, m_hunkBuffer.data() + hunkPosition, copySize);
+		m_position += copySize;
+		outBuffer += copySize;
+		remainSize -= copySize;
 	}
-	memcpy(buffer, m_hunkBuffer.data() + hunkPosition, size);
-	m_position += size;
 	return size;
 }
 
@@ -15,8 +15,6 @@ protected:
 	void CompileEpilog(CMipsJitter*, bool) override;
 
 private:
-	bool IsCodeIdleLoopBlock() const;
-
 	static constexpr auto DEFAULT_FP_ROUNDING_MODE = Jitter::CJitter::ROUND_TRUNCATE;
 	Jitter::CJitter::ROUNDINGMODE m_fpRoundingMode = DEFAULT_FP_ROUNDING_MODE;
 
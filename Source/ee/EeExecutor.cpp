@@ -1,8 +1,12 @@
 #include "EeExecutor.h"
 #include "../Ps2Const.h"
+#include "../Log.h"
+#include "../MipsIdleLoopUtils.h"
 #include "AlignedAlloc.h"
 #include "EeBasicBlock.h"
 #include "xxhash.h"
+#include <mutex>
+#include <thread>
 
 #if defined(__unix__) || defined(__ANDROID__) || defined(__APPLE__)
 #include <sys/mman.h>
@@ -31,13 +35,28 @@
 
 #endif
 
-static CEeExecutor* g_eeExecutor = nullptr;
+#define LOG_NAME ("ee_executor")
+
+#if defined(_WIN32) || defined(__unix__) || defined(__ANDROID__)
+//Several VMs can live in the same process, each with their own executor. The process-wide
+//fault handler is installed once and faults are dispatched to the executor owning the address.
+static constexpr uint32 MAX_EXECUTOR_COUNT = 64;
+static std::atomic<CEeExecutor*> g_eeExecutors[MAX_EXECUTOR_COUNT] = {};
+static std::mutex g_eeExecutorsMutex;
+static uint32 g_eeExecutorCount = 0;
+//Number of fault dispatches in flight, used to make sure a removed executor isn't used anymore
+static std::atomic<uint32> g_eeExecutorDispatchCount = 0;
+#if defined(_WIN32)
+static LPVOID g_eeExecutorHandler = NULL;
+#endif
+#endif
 
 CEeExecutor::CEeExecutor(CMIPS& context, uint8* ram)
     : CGenericMipsExecutor(context, 0x20000000, BLOCK_CATEGORY_PS2_EE)
     , m_ram(ram)
 {
 	m_pageSize = framework_getpagesize();
+	m_deferredAccessFaultPages.resize(PS2::EE_RAM_SIZE / m_pageSize);
 }
 
 void CEeExecutor::SetBlockFpRoundingModes(BlockFpRoundingModeMap blockFpRoundingModes)
@@ -50,19 +69,49 @@ void CEeExecutor::SetIdleLoopBlocks(IdleLoopBlockSet idleLoopBlocks)
 	m_idleLoopBlocks = std::move(idleLoopBlocks);
 }
 
+void CEeExecutor::SetIdleLoopDetectionEnabled(bool idleLoopDetectionEnabled)
+{
+	m_idleLoopDetectionEnabled = idleLoopDetectionEnabled;
+}
+
+const CEeExecutor::IdleLoopBlockSet& CEeExecutor::GetDetectedIdleLoopBlocks() const
+{
+	return m_detectedIdleLoopBlocks;
+}
+
 void CEeExecutor::AddExceptionHandler()
 {
-	assert(g_eeExecutor == nullptr);
-	g_eeExecutor = this;
+	m_executorThreadId = std::this_thread::get_id();
 
 #ifdef DISABLE_PROTECTION
 	return;
 #endif
 
+#if defined(_WIN32) || defined(__unix__) || defined(__ANDROID__)
+	std::lock_guard<std::mutex> executorsLock(g_eeExecutorsMutex);
+
+	bool registered = false;
+	for(auto& executor : g_eeExecutors)
+	{
+		CEeExecutor* expected = nullptr;
+		if(executor.compare_exchange_strong(expected, this))
+		{
+			registered = true;
+			break;
+		}
+	}
+	assert(registered);
+	if(!registered)
+	{
+		throw std::runtime_error("Too many EE executors registered.");
+	}
+
+	if(g_eeExecutorCount++ != 0) return;
+
 #if defined(_WIN32)
-	m_handler = AddVectoredExceptionHandler(TRUE, &CEeExecutor::HandleException);
-	assert(m_handler != NULL);
-#elif defined(__unix__) || defined(__ANDROID__)
+	g_eeExecutorHandler = AddVectoredExceptionHandler(TRUE, &CEeExecutor::HandleException);
+	assert(g_eeExecutorHandler != NULL);
+#else
 	struct sigaction sigAction;
 	sigAction.sa_handler = nullptr;
 	sigAction.sa_sigaction = &HandleException;
@@ -70,6 +119,7 @@ void CEeExecutor::AddExceptionHandler()
 	sigemptyset(&sigAction.sa_mask);
 	int result = sigaction(SIGSEGV, &sigAction, nullptr);
 	assert(result >= 0);
+#endif
 #elif defined(__APPLE__)
 	if(!m_running)
 	{
@@ -88,16 +138,40 @@ void CEeExecutor::RemoveExceptionHandler()
 {
 #ifndef DISABLE_PROTECTION
 
+#if defined(_WIN32) || defined(__unix__) || defined(__ANDROID__)
+	std::lock_guard<std::mutex> executorsLock(g_eeExecutorsMutex);
+
+	for(auto& executor : g_eeExecutors)
+	{
+		CEeExecutor* expected = this;
+		if(executor.compare_exchange_strong(expected, nullptr))
+		{
+			assert(g_eeExecutorCount != 0);
+			g_eeExecutorCount--;
+			break;
+		}
+	}
+
+	//Fault handlers can't take locks. Wait for the dispatches that might have picked up
+	//this executor before it was removed from the table, new ones won't see it.
+	while(g_eeExecutorDispatchCount.load() != 0)
+	{
+		std::this_thread::yield();
+	}
+
 #if defined(_WIN32)
-	RemoveVectoredExceptionHandler(m_handler);
+	if(g_eeExecutorCount == 0)
+	{
+		RemoveVectoredExceptionHandler(g_eeExecutorHandler);
+		g_eeExecutorHandler = NULL;
+	}
+#endif
 #elif defined(__APPLE__)
 	m_running = false;
 	m_handlerThread.join();
 #endif
 
 #endif //!DISABLE_PROTECTION
-
-	g_eeExecutor = nullptr;
 }
 
 void CEeExecutor::AttachExceptionHandlerToThread()
@@ -117,11 +191,28 @@ void CEeExecutor::AttachExceptionHandlerToThread()
 #endif
 }
 
+void CEeExecutor::FlushDeferredAccessFaults()
+{
+	assert(std::this_thread::get_id() == m_executorThreadId);
+	if(!m_hasDeferredAccessFaults) return;
+	m_hasDeferredAccessFaults = false;
+	for(uint32 pageIndex = 0; pageIndex < m_deferredAccessFaultPages.size(); pageIndex++)
+	{
+		if(!m_deferredAccessFaultPages[pageIndex]) continue;
+		m_deferredAccessFaultPages[pageIndex] = 0;
+		uint32 addr = pageIndex * m_pageSize;
+		ClearActiveBlocksInRange(addr, addr + m_pageSize, false);
+	}
+}
+
 void CEeExecutor::Reset()
 {
 	SetMemoryProtected(m_ram, PS2::EE_RAM_SIZE, false);
 	m_cachedBlocks.clear();
 	m_blockFpRoundingModes.clear();
+	m_detectedIdleLoopBlocks.clear();
+	std::fill(m_deferredAccessFaultPages.begin(), m_deferredAccessFaultPages.end(), 0);
+	m_hasDeferredAccessFaults = false;
 	CGenericMipsExecutor::Reset();
 }
 
@@ -191,6 +282,14 @@ BasicBlockPtr CEeExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end
 	{
 		result->SetIsIdleLoopBlock();
 	}
+	else if(m_idleLoopDetectionEnabled && MipsIdleLoopUtils::IsIdleLoopBlock(context, start, end, true))
+	{
+		result->SetIsIdleLoopBlock();
+		if(m_detectedIdleLoopBlocks.insert(start).second)
+		{
+			CLog::GetInstance().Print(LOG_NAME, "Detected idle loop block at 0x%08X.\r\n", start);
+		}
+	}
 
 	result->Compile();
 	if(!hasBreakpoint)
@@ -206,12 +305,44 @@ bool CEeExecutor::HandleAccessFault(intptr_t ptr)
 	if(addr >= 0 && addr < PS2::EE_RAM_SIZE)
 	{
 		addr &= ~(m_pageSize - 1);
+#if !defined(__APPLE__)
+		//On macOS/iOS, faults are handled by a separate thread, so this check can't be done
+		if(std::this_thread::get_id() != m_executorThreadId)
+		{
+			SetMemoryProtected(m_ram + addr, m_pageSize, false);
+			m_deferredAccessFaultPages[addr / m_pageSize] = 1;
+			m_hasDeferredAccessFaults = true;
+			return true;
+		}
+#endif
 		ClearActiveBlocksInRange(addr, addr + m_pageSize, true);
 		return true;
 	}
 	return false;
 }
 
+#if defined(_WIN32) || defined(__unix__) || defined(__ANDROID__)
+
+bool CEeExecutor::DispatchAccessFault(intptr_t ptr)
+{
+	//Called from the fault handler, must not take locks
+	bool handled = false;
+	g_eeExecutorDispatchCount++;
+	for(const auto& executor : g_eeExecutors)
+	{
+		auto executorPtr = executor.load();
+		if(executorPtr && executorPtr->HandleAccessFault(ptr))
+		{
+			handled = true;
+			break;
+		}
+	}
+	g_eeExecutorDispatchCount--;
+	return handled;
+}
+
+#endif
+
 void CEeExecutor::SetMemoryProtected(void* addr, size_t size, bool protect)
 {
 #ifdef DISABLE_PROTECTION
@@ -240,16 +371,11 @@ void CEeExecutor::SetMemoryProtected(void* addr, size_t size, bool protect)
 #if defined(_WIN32)
 
 LONG WINAPI CEeExecutor::HandleException(_EXCEPTION_POINTERS* exceptionInfo)
-{
-	return g_eeExecutor->HandleExceptionInternal(exceptionInfo);
-}
-
-LONG CEeExecutor::HandleExceptionInternal(_EXCEPTION_POINTERS* exceptionInfo)
 {
 	auto exceptionRecord = exceptionInfo->ExceptionRecord;
 	if(exceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION)
 	{
-		if(HandleAccessFault(exceptionRecord->ExceptionInformation[1]))
+		if(DispatchAccessFault(exceptionRecord->ExceptionInformation[1]))
 		{
 			return EXCEPTION_CONTINUE_EXECUTION;
 		}
@@ -260,14 +386,9 @@ LONG CEeExecutor::HandleExceptionInternal(_EXCEPTION_POINTERS* exceptionInfo)
 #elif defined(__unix__) || defined(__ANDROID__)
 
 void CEeExecutor::HandleException(int sigId, siginfo_t* sigInfo, void* baseContext)
-{
-	g_eeExecutor->HandleExceptionInternal(sigId, sigInfo, baseContext);
-}
-
-void CEeExecutor::HandleExceptionInternal(int sigId, siginfo_t* sigInfo, void* baseContext)
 {
 	if(sigId != SIGSEGV) return;
-	if(HandleAccessFault(reinterpret_cast<intptr_t>(sigInfo->si_addr)))
+	if(DispatchAccessFault(reinterpret_cast<intptr_t>(sigInfo->si_addr)))
 	{
 		return;
 	}
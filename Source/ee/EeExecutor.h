@@ -10,6 +10,9 @@
 #include <signal.h>
 #endif
 
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "../GenericMipsExecutor.h"
 
 class CEeExecutor : public CGenericMipsExecutor<BlockLookupTwoWay>
@@ -23,11 +26,14 @@ public:
 
 	void SetBlockFpRoundingModes(BlockFpRoundingModeMap);
 	void SetIdleLoopBlocks(IdleLoopBlockSet);
+	void SetIdleLoopDetectionEnabled(bool);
+	const IdleLoopBlockSet& GetDetectedIdleLoopBlocks() const;
 
 	void AddExceptionHandler();
 	void RemoveExceptionHandler();
 
 	void AttachExceptionHandlerToThread();
+	void FlushDeferredAccessFaults();
 
 	void Reset() override;
 	void ClearActiveBlocksInRange(uint32, uint32, bool) override;
@@ -40,22 +46,28 @@ private:
 	CachedBlockMap m_cachedBlocks;
 
 	IdleLoopBlockSet m_idleLoopBlocks;
+	IdleLoopBlockSet m_detectedIdleLoopBlocks;
+	bool m_idleLoopDetectionEnabled = true;
 	BlockFpRoundingModeMap m_blockFpRoundingModes;
 
 	uint8* m_ram = nullptr;
 	size_t m_pageSize = 0;
 
+	//Pages written to by threads other than the one running the EE (ie.: IOP thread).
+	//Blocks in those pages can't be cleared right away since the EE might be executing them.
+	std::thread::id m_executorThreadId;
+	std::vector<uint8> m_deferredAccessFaultPages;
+	std::atomic<bool> m_hasDeferredAccessFaults = false;
+
 	bool HandleAccessFault(intptr_t);
 	void SetMemoryProtected(void*, size_t, bool);
 
 #if defined(_WIN32)
+	static bool DispatchAccessFault(intptr_t);
 	static LONG CALLBACK HandleException(_EXCEPTION_POINTERS*);
-	LONG HandleExceptionInternal(_EXCEPTION_POINTERS*);
-
-	LPVOID m_handler = NULL;
 #elif defined(__unix__) || defined(__ANDROID__)
+	static bool DispatchAccessFault(intptr_t);
 	static void HandleException(int, siginfo_t*, void*);
-	void HandleExceptionInternal(int, siginfo_t*, void*);
 #elif defined(__APPLE__)
 	void HandlerThreadProc();
 
@@ -50,6 +50,7 @@ void CGIF::Reset()
 	m_regs = 0;
 	m_regsTemp = 0;
 	m_regList = 0;
+	m_packedHandler = &CGIF::ProcessPacked;
 	m_eop = false;
 	m_qtemp = QTEMP_INIT;
 	m_signalState = SIGNAL_STATE_NONE;
@@ -72,6 +73,7 @@ void CGIF::LoadState(Framework::CZipArchiveReader& archive)
 		m_regsTemp = static_cast<uint8>(registerFile.GetRegister32(STATE_REGS_REGSTEMP));
 		m_regList = registerFile.GetRegister64(STATE_REGS_REGLIST);
 		m_eop = registerFile.GetRegister32(STATE_REGS_EOP) != 0;
+		m_packedHandler = GetPackedHandler(m_regs, m_regList);
 		m_qtemp = registerFile.GetRegister32(STATE_REGS_QTEMP);
 		m_path3XferActiveTicks = registerFile.GetRegister32(STATE_REGS_PATH3_XFER_ACTIVE_TICKS);
 		m_fifoIndex = registerFile.GetRegister32(STATE_REGS_FIFO_INDEX);
@@ -102,6 +104,46 @@ void CGIF::SaveState(Framework::CZipArchiveWriter& archive)
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_FIFO_BUFFER, m_fifoBuffer, FIFO_SIZE));
 }
 
+CGIF::PackedHandler CGIF::GetPackedHandler(uint8 regCount, uint64 regList) const
+{
+	//Common PACKED register patterns get their own specialized handler, everything else goes through the generic path
+	if(!m_packedSpecializationEnabled) return &CGIF::ProcessPacked;
+	if(regCount > 6) return &CGIF::ProcessPacked;
+	uint32 regs = static_cast<uint32>(regList & ((1ULL << (regCount * 4)) - 1));
+	switch((regCount << 24) | regs)
+	{
+	case (2 << 24) | 0x51:
+		//RGBAQ, XYZ2
+		return &CGIF::ProcessPackedSpecialized<0x01, 0x05>;
+	case (2 << 24) | 0x41:
+		//RGBAQ, XYZF2
+		return &CGIF::ProcessPackedSpecialized<0x01, 0x04>;
+	case (3 << 24) | 0x512:
+		//ST, RGBAQ, XYZ2
+		return &CGIF::ProcessPackedSpecialized<0x02, 0x01, 0x05>;
+	case (3 << 24) | 0x412:
+		//ST, RGBAQ, XYZF2
+		return &CGIF::ProcessPackedSpecialized<0x02, 0x01, 0x04>;
+	case (3 << 24) | 0x513:
+		//UV, RGBAQ, XYZ2
+		return &CGIF::ProcessPackedSpecialized<0x03, 0x01, 0x05>;
+	case (3 << 24) | 0x413:
+		//UV, RGBAQ, XYZF2
+		return &CGIF::ProcessPackedSpecialized<0x03, 0x01, 0x04>;
+	case (4 << 24) | 0x5252:
+		//ST, XYZ2, ST, XYZ2 (sprites)
+		return &CGIF::ProcessPackedSpecialized<0x02, 0x05, 0x02, 0x05>;
+	case (4 << 24) | 0x5353:
+		//UV, XYZ2, UV, XYZ2 (sprites)
+		return &CGIF::ProcessPackedSpecialized<0x03, 0x05, 0x03, 0x05>;
+	case (6 << 24) | 0x512512:
+		//ST, RGBAQ, XYZ2, ST, RGBAQ, XYZ2 (sprites)
+		return &CGIF::ProcessPackedSpecialized<0x02, 0x01, 0x05, 0x02, 0x01, 0x05>;
+	default:
+		return &CGIF::ProcessPacked;
+	}
+}
+
 uint32 CGIF::ProcessPacked(const uint8* memory, uint32 address, uint32 end)
 {
 	uint32 start = address;
@@ -344,13 +386,14 @@ uint32 CGIF::ProcessSinglePacket(const uint8* memory, uint32 memorySize, uint32
 
 			if(m_regs == 0) m_regs = 0x10;
 			m_regsTemp = m_regs;
+			m_packedHandler = GetPackedHandler(m_regs, m_regList);
 			m_activePath = packetMetadata.pathIndex;
 			continue;
 		}
 		switch(m_cmd)
 		{
 		case 0x00:
-			address += ProcessPacked(memory, address, end);
+			address += (this->*m_packedHandler)(memory, address, end);
 			break;
 		case 0x01:
 			address += ProcessRegList(memory, address, end);
@@ -622,6 +665,11 @@ void CGIF::SetPath3Masked(bool masked)
 	}
 }
 
+void CGIF::SetPackedSpecializationEnabled(bool enabled)
+{
+	m_packedSpecializationEnabled = enabled;
+}
+
 void CGIF::DisassembleGet(uint32 address)
 {
 	switch(address)
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include "Types.h"
+#include "../uint128.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 #include "../gs/GSHandler.h"
@@ -66,6 +68,9 @@ public:
 	uint32 GetActivePath() const;
 	void SetPath3Masked(bool);
 
+	//Allows tests to compare specialized PACKED handlers against the generic one
+	void SetPackedSpecializationEnabled(bool);
+
 	void LoadState(Framework::CZipArchiveReader&);
 	void SaveState(Framework::CZipArchiveWriter&);
 
@@ -90,7 +95,96 @@ private:
 		MASKED_PATH3_XFER_DONE,
 	};
 
+	typedef uint32 (CGIF::*PackedHandler)(const uint8*, uint32, uint32);
+
+	PackedHandler GetPackedHandler(uint8, uint64) const;
+
 	uint32 ProcessPacked(const uint8*, uint32, uint32);
+
+	//Processes as many complete loops of a known PACKED register pattern as possible in a single pass,
+	//leaving partial loops to the generic handler. Only registers without side effects on the GIF's state
+	//(besides Q) can be used here (ie.: no A+D or NOP).
+	template <uint32... regDescs>
+	uint32 ProcessPackedSpecialized(const uint8* memory, uint32 address, uint32 end)
+	{
+		static constexpr uint32 regCount = sizeof...(regDescs);
+		static constexpr uint32 loopSize = regCount * 0x10;
+
+		if(m_regsTemp != m_regs)
+		{
+			return ProcessPacked(memory, address, end);
+		}
+
+		uint32 start = address;
+		uint32 loopCount = std::min<uint32>(m_loops, (end - address) / loopSize);
+		if(loopCount != 0)
+		{
+			auto writes = m_gs->ReserveRegisterWrites(loopCount * regCount);
+			if(writes == nullptr)
+			{
+				return ProcessPacked(memory, address, end);
+			}
+			auto packet = reinterpret_cast<const uint128*>(memory + address);
+			for(uint32 i = 0; i < loopCount; i++)
+			{
+				((*writes++ = DecodePackedRegister<regDescs>(*packet++)), ...);
+			}
+			address += loopCount * loopSize;
+			m_loops -= loopCount;
+		}
+
+		return (address - start) + ProcessPacked(memory, address, end);
+	}
+
+	template <uint32 regDesc>
+	CGSHandler::RegisterWrite DecodePackedRegister(const uint128& packet)
+	{
+		switch(regDesc)
+		{
+		case 0x01:
+		{
+			//RGBA
+			uint64 temp = (packet.nV[0] & 0xFF);
+			temp |= (packet.nV[1] & 0xFF) << 8;
+			temp |= (packet.nV[2] & 0xFF) << 16;
+			temp |= (packet.nV[3] & 0xFF) << 24;
+			temp |= (static_cast<uint64>(m_qtemp) << 32);
+			return CGSHandler::RegisterWrite(GS_REG_RGBAQ, temp);
+		}
+		case 0x02:
+			//ST
+			m_qtemp = packet.nV2;
+			return CGSHandler::RegisterWrite(GS_REG_ST, packet.nD0);
+		case 0x03:
+		{
+			//UV
+			uint64 temp = (packet.nV[0] & 0x7FFF);
+			temp |= (packet.nV[1] & 0x7FFF) << 16;
+			return CGSHandler::RegisterWrite(GS_REG_UV, temp);
+		}
+		case 0x04:
+		{
+			//XYZF2
+			uint64 temp = (packet.nV[0] & 0xFFFF);
+			temp |= (packet.nV[1] & 0xFFFF) << 16;
+			temp |= static_cast<uint64>(packet.nV[2] & 0x0FFFFFF0) << 28;
+			temp |= static_cast<uint64>(packet.nV[3] & 0x00000FF0) << 52;
+			return CGSHandler::RegisterWrite((packet.nV[3] & 0x8000) ? GS_REG_XYZF3 : GS_REG_XYZF2, temp);
+		}
+		case 0x05:
+		{
+			//XYZ2
+			uint64 temp = (packet.nV[0] & 0xFFFF);
+			temp |= (packet.nV[1] & 0xFFFF) << 16;
+			temp |= static_cast<uint64>(packet.nV[2]) << 32;
+			return CGSHandler::RegisterWrite((packet.nV[3] & 0x8000) ? GS_REG_XYZ3 : GS_REG_XYZ2, temp);
+		}
+		default:
+			static_assert((regDesc >= 0x01) && (regDesc <= 0x05), "Unsupported register descriptor for specialized PACKED processing.");
+			return CGSHandler::RegisterWrite();
+		}
+	}
+
 	uint32 ProcessRegList(const uint8*, uint32, uint32);
 	uint32 ProcessImage(const uint8*, uint32, uint32, uint32);
 
@@ -109,6 +203,8 @@ private:
 	uint8 m_regs = 0;
 	uint8 m_regsTemp = 0;
 	uint64 m_regList = 0;
+	PackedHandler m_packedHandler = &CGIF::ProcessPacked;
+	bool m_packedSpecializationEnabled = true;
 	bool m_eop = false;
 	uint32 m_qtemp;
 	SIGNAL_STATE m_signalState = SIGNAL_STATE_NONE;
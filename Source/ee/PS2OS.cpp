@@ -372,6 +372,11 @@ const char* CPS2OS::GetExecutableName() const
 	return m_executableName.c_str();
 }
 
+bool CPS2OS::IsTurboIoDisabled() const
+{
+	return m_turboIoDisabled;
+}
+
 std::pair<uint32, uint32> CPS2OS::GetExecutableRange() const
 {
 	uint32 minAddr = 0xFFFFFFF0;
@@ -571,6 +576,8 @@ uint32 CPS2OS::LoadExecutable(const char* path, const char* section)
 
 void CPS2OS::ApplyGameConfig()
 {
+	m_turboIoDisabled = false;
+
 	std::unique_ptr<Framework::Xml::CNode> document;
 	try
 	{
@@ -682,6 +689,11 @@ void CPS2OS::ApplyGameConfig()
 			idleLoopBlocks.insert(address);
 		}
 
+		if(gameConfigNode->Select("DisableTurboIo"))
+		{
+			m_turboIoDisabled = true;
+		}
+
 		auto executor = static_cast<CEeExecutor*>(m_ee.m_executor.get());
 		executor->SetBlockFpRoundingModes(std::move(blockFpRoundingModes));
 		executor->SetIdleLoopBlocks(std::move(idleLoopBlocks));
@@ -1589,11 +1601,13 @@ void CPS2OS::UpdateTLBEnabledState()
 	{
 		m_ee.m_pAddrTranslator = &TranslateAddressTLB;
 		m_ee.m_TLBExceptionChecker = &CheckTLBExceptions;
+		m_ee.m_TLBExemptAddressChecker = &IsTLBExemptAddress;
 	}
 	else
 	{
 		m_ee.m_pAddrTranslator = &TranslateAddress;
 		m_ee.m_TLBExceptionChecker = nullptr;
+		m_ee.m_TLBExemptAddressChecker = nullptr;
 	}
 }
 
@@ -1676,19 +1690,7 @@ uint32 CPS2OS::TranslateAddressTLB(CMIPS* context, uint32 vaddrLo)
 
 uint32 CPS2OS::CheckTLBExceptions(CMIPS* context, uint32 vaddrLo, uint32 isWrite)
 {
-	if(TLB_IS_DIRECT_VADDRESS(vaddrLo))
-	{
-		return MIPS_EXCEPTION_NONE;
-	}
-	if(TLB_IS_UNCACHED_RAM_VADDRESS(vaddrLo))
-	{
-		return MIPS_EXCEPTION_NONE;
-	}
-	if(TLB_IS_UNCACHED_FAST_RAM_VADDRESS(vaddrLo))
-	{
-		return MIPS_EXCEPTION_NONE;
-	}
-	if(TLB_IS_SPR_VADDRESS(vaddrLo))
+	if(IsTLBExemptAddress(vaddrLo))
 	{
 		return MIPS_EXCEPTION_NONE;
 	}
@@ -1724,6 +1726,14 @@ uint32 CPS2OS::CheckTLBExceptions(CMIPS* context, uint32 vaddrLo, uint32 isWrite
 	return MIPS_EXCEPTION_NONE;
 }
 
+bool CPS2OS::IsTLBExemptAddress(uint32 vaddrLo)
+{
+	return TLB_IS_DIRECT_VADDRESS(vaddrLo) ||
+	       TLB_IS_UNCACHED_RAM_VADDRESS(vaddrLo) ||
+	       TLB_IS_UNCACHED_FAST_RAM_VADDRESS(vaddrLo) ||
+	       TLB_IS_SPR_VADDRESS(vaddrLo);
+}
+
 //////////////////////////////////////////////////
 //System Calls
 //////////////////////////////////////////////////
@@ -3225,6 +3235,7 @@ void CPS2OS::sc_Deci2Call()
 					assert(sendInfo->size >= 0x0C);
 					if(sendInfo->size >= 0x0C)
 					{
+						m_sif.SyncIop();
 						m_iopBios.GetIoman()->Write(Iop::CIoman::FID_STDOUT, sendInfo->size - 0xC, sendInfo->data);
 					}
 					buffer->status0 = 0;
@@ -3260,6 +3271,7 @@ void CPS2OS::sc_Deci2Call()
 		{
 			uint32 stringAddr = *reinterpret_cast<uint32*>(GetStructPtr(param));
 			uint8* string = &m_ram[stringAddr];
+			m_sif.SyncIop();
 			m_iopBios.GetIoman()->Write(1, static_cast<uint32>(strlen(reinterpret_cast<char*>(string))), string);
 		}
 		break;
@@ -3323,6 +3335,8 @@ void CPS2OS::HandleSyscall()
 	}
 	else if((func >= Ee::CLibMc2::SYSCALL_RANGE_START) && (func < Ee::CLibMc2::SYSCALL_RANGE_END))
 	{
+		//LibMc2 calls directly into IOP modules
+		m_sif.SyncIop();
 		m_libMc2.HandleSyscall(m_ee);
 	}
 	else
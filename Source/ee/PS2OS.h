@@ -39,6 +39,7 @@ public:
 	void BootFromCDROM();
 	CELF32* GetELF();
 	const char* GetExecutableName() const;
+	bool IsTurboIoDisabled() const;
 	std::pair<uint32, uint32> GetExecutableRange() const;
 	uint32 LoadExecutable(const char*, const char*);
 
@@ -60,6 +61,7 @@ public:
 	static uint32 TranslateAddress(CMIPS*, uint32);
 	static uint32 TranslateAddressTLB(CMIPS*, uint32);
 	static uint32 CheckTLBExceptions(CMIPS*, uint32, uint32);
+	static bool IsTLBExemptAddress(uint32);
 
 #ifdef DEBUGGER_INCLUDED
 	BiosDebugModuleInfoArray GetModulesDebugInfo() const override;
@@ -475,6 +477,9 @@ private:
 	//For display purposes only
 	std::string m_executableName;
 
+	//Set by the game config of games that don't cope with I/O completing too quickly
+	bool m_turboIoDisabled = false;
+
 	Ee::CIdleEvaluator m_idleEvaluator;
 
 #ifdef DEBUGGER_INCLUDED
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <stdio.h>
 #include "../Log.h"
@@ -82,6 +83,9 @@ void CSIF::Reset()
 
 	m_packetQueue.clear();
 	m_packetProcessed = true;
+	m_transferCount = 0;
+	m_totalTicks = 0;
+	m_rpcServerStats.clear();
 
 	m_callReplies.clear();
 	m_bindReplies.clear();
@@ -104,6 +108,8 @@ void CSIF::SetCmdBuffer(uint32 bufferAddress, uint32 size)
 
 void CSIF::RegisterModule(uint32 moduleId, CSifModule* module)
 {
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+
 	m_modules[moduleId] = module;
 
 	auto replyIterator(m_bindReplies.find(moduleId));
@@ -160,6 +166,12 @@ uint32 CSIF::ReceiveDMA6(uint32 nSrcAddr, uint32 nSize, uint32 nDstAddr, bool is
 {
 	assert(!isTagIncluded);
 
+	{
+		//The IOP might not be stopped yet, transfer count is shared with it
+		std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+		m_transferCount++;
+	}
+
 	//Humm, this is kinda odd, but it ors the address with 0x20000000
 	nSrcAddr &= (PS2::EE_RAM_SIZE - 1);
 
@@ -167,10 +179,15 @@ uint32 CSIF::ReceiveDMA6(uint32 nSrcAddr, uint32 nSize, uint32 nDstAddr, bool is
 	{
 		//This should be the arguments for the call command
 		//Just save the source address for later use
+		//Arguments stay in EE RAM until the call command arrives, no need to wait for the IOP here
 		m_nDataAddr = nSrcAddr;
 		return nSize;
 	}
-	else if(nDstAddr == SIF_RESETADDR)
+
+	//Commands sent to the IOP will run its modules, make sure it's not running
+	SyncIop();
+
+	if(nDstAddr == SIF_RESETADDR)
 	{
 		auto commandData = m_eeRam + nSrcAddr;
 		auto hdr = reinterpret_cast<const SIFCMDHEADER*>(commandData);
@@ -249,6 +266,9 @@ void CSIF::SendPacket(const void* packet, uint32 size)
 
 void CSIF::SendPacketToAddress(const void* packet, uint32 size, uint32 dstAddr)
 {
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+
+	m_transferCount++;
 	m_packetQueue.insert(m_packetQueue.end(),
 	                     reinterpret_cast<const uint8*>(&size),
 	                     reinterpret_cast<const uint8*>(&size) + 4);
@@ -262,6 +282,10 @@ void CSIF::SendPacketToAddress(const void* packet, uint32 size, uint32 dstAddr)
 
 void CSIF::CountTicks(uint32 ticks)
 {
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+
+	m_totalTicks += ticks;
+
 	CheckPendingBindRequests(ticks);
 
 	if(m_packetProcessed && !m_packetQueue.empty())
@@ -281,6 +305,30 @@ void CSIF::MarkPacketProcessed()
 	m_packetProcessed = true;
 }
 
+uint32 CSIF::GetTransferCount() const
+{
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+	return m_transferCount;
+}
+
+bool CSIF::HasPendingTransfers() const
+{
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+	return !m_packetQueue.empty() || !m_packetProcessed;
+}
+
+CSIF::RpcServerStatsMap CSIF::GetRpcServerStats()
+{
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+	return m_rpcServerStats;
+}
+
+void CSIF::ResetRpcServerStats()
+{
+	std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+	m_rpcServerStats.clear();
+}
+
 void CSIF::SendDMA(const void* data, uint32 dstAddr, uint32 size)
 {
 	memcpy(m_eeRam + dstAddr, data, size);
@@ -308,6 +356,9 @@ void CSIF::LoadState(Framework::CZipArchiveReader& archive)
 
 	m_callReplies = LoadCallReplies(archive);
 	m_bindReplies = LoadBindReplies(archive);
+
+	//Call times of loaded replies are not saved, measure their latency from here
+	m_totalTicks = 0;
 }
 
 void CSIF::SaveState(Framework::CZipArchiveWriter& archive)
@@ -574,6 +625,11 @@ void CSIF::Cmd_Call(const SIFCMDHEADER* hdr)
 
 	CLog::GetInstance().Print(LOG_NAME, "Calling function 0x%08X of module 0x%08X.\r\n", call->rpcNumber, serverId);
 
+	{
+		std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+		m_rpcServerStats[serverId].callCount++;
+	}
+
 	uint32 recvAddr = (call->recv & (PS2::EE_RAM_SIZE - 1));
 
 	auto moduleIterator(m_modules.find(serverId));
@@ -619,6 +675,7 @@ void CSIF::Cmd_Call(const SIFCMDHEADER* hdr)
 			CALLREQUESTINFO requestInfo;
 			requestInfo.reply = rend;
 			requestInfo.call = *call;
+			requestInfo.callTicks = m_totalTicks;
 			m_callReplies[serverId] = requestInfo;
 		}
 	}
@@ -672,6 +729,16 @@ void CSIF::SendCallReply(uint32 serverId, const void* returnData)
 		memcpy(m_eeRam + dstPtr, returnData, dstSize);
 	}
 	SendPacket(&requestInfo.reply, sizeof(SIFRPCREQUESTEND));
+
+	{
+		std::lock_guard<std::recursive_mutex> iopStateLock(m_iopStateMutex);
+		uint64 latency = m_totalTicks - requestInfo.callTicks;
+		auto& stats = m_rpcServerStats[serverId];
+		stats.deferredReplyCount++;
+		stats.totalReplyLatency += latency;
+		stats.maxReplyLatency = std::max(stats.maxReplyLatency, latency);
+	}
+
 	m_callReplies.erase(replyIterator);
 }
 
@@ -685,12 +752,28 @@ void CSIF::SetCustomCommandHandler(const CustomCommandHandler& customCommandHand
 	m_customCommandHandler = customCommandHandler;
 }
 
+void CSIF::SetIopSyncHandler(const IopSyncHandler& iopSyncHandler)
+{
+	m_iopSyncHandler = iopSyncHandler;
+}
+
+void CSIF::SyncIop()
+{
+	if(m_iopSyncHandler)
+	{
+		m_iopSyncHandler();
+	}
+}
+
 /////////////////////////////////////////////////////////
 //Get/Set Register
 /////////////////////////////////////////////////////////
 
 uint32 CSIF::GetRegister(uint32 nRegister)
 {
+	//SMFLAG and SUBADDR are written by the IOP
+	SyncIop();
+
 	switch(nRegister)
 	{
 	case 0x00000001:
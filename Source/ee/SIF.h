@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <vector>
 #include "../SifDefs.h"
 #include "../SifModule.h"
@@ -14,6 +15,17 @@ class CSIF
 public:
 	typedef std::function<void(const std::string&)> ModuleResetHandler;
 	typedef std::function<void(uint32)> CustomCommandHandler;
+	typedef std::function<void()> IopSyncHandler;
+
+	//Reply latencies are in EE cycles and only account for calls whose reply was deferred by the server
+	struct RPC_SERVER_STATS
+	{
+		uint32 callCount = 0;
+		uint32 deferredReplyCount = 0;
+		uint64 totalReplyLatency = 0;
+		uint64 maxReplyLatency = 0;
+	};
+	typedef std::map<uint32, RPC_SERVER_STATS> RpcServerStatsMap;
 
 	CSIF(CDMAC&, uint8*, uint8*);
 	virtual ~CSIF() = default;
@@ -23,6 +35,12 @@ public:
 	void CountTicks(uint32);
 	void MarkPacketProcessed();
 
+	uint32 GetTransferCount() const;
+	bool HasPendingTransfers() const;
+
+	RpcServerStatsMap GetRpcServerStats();
+	void ResetRpcServerStats();
+
 	void RegisterModule(uint32, CSifModule*);
 	bool IsModuleRegistered(uint32) const;
 	void UnregisterModule(uint32);
@@ -31,6 +49,9 @@ public:
 	void SendCallReply(uint32, const void*);
 	void SetModuleResetHandler(const ModuleResetHandler&);
 	void SetCustomCommandHandler(const CustomCommandHandler&);
+	void SetIopSyncHandler(const IopSyncHandler&);
+
+	void SyncIop();
 
 	uint32 ReceiveDMA5(uint32, uint32, uint32, bool);
 	uint32 ReceiveDMA6(uint32, uint32, uint32, bool);
@@ -51,6 +72,7 @@ private:
 	{
 		SIFRPCCALL call;
 		SIFRPCREQUESTEND reply;
+		uint64 callTicks = 0;
 	};
 
 	struct BINDREQUESTINFO
@@ -107,12 +129,20 @@ private:
 
 	ModuleMap m_modules;
 
+	//Protects state that can be modified by the IOP while the EE is running (when IOP runs on its own thread)
+	mutable std::recursive_mutex m_iopStateMutex;
+
 	PacketQueue m_packetQueue;
 	bool m_packetProcessed;
 
+	uint32 m_transferCount = 0;
+	uint64 m_totalTicks = 0;
+	RpcServerStatsMap m_rpcServerStats;
+
 	CallReplyMap m_callReplies;
 	BindReplyMap m_bindReplies;
 
 	ModuleResetHandler m_moduleResetHandler;
 	CustomCommandHandler m_customCommandHandler;
+	IopSyncHandler m_iopSyncHandler;
 };
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <stdio.h>
 #include "../Log.h"
@@ -20,81 +21,134 @@ CTimer::CTimer(CINTC& intc, CGSHandler*& gs)
 void CTimer::Reset()
 {
 	memset(m_timer, 0, sizeof(TIMER) * 4);
+	m_totalTicks = 0;
+	m_nextEventTicks = ~0ULL;
 }
 
 void CTimer::Count(unsigned int ticks)
 {
-	for(unsigned int i = 0; i < MAX_TIMER; i++)
+	m_totalTicks += ticks;
+	if(m_totalTicks < m_nextEventTicks) return;
+	SyncTimers();
+}
+
+uint32 CTimer::GetTimerDivider(const TIMER& timer) const
+{
+	//BUSCLOCK runs at half EE frequency
+	switch(timer.nMODE & MODE_CLOCK_SELECT)
 	{
-		auto& timer = m_timer[i];
+	default:
+	case MODE_CLOCK_SELECT_BUSCLOCK:
+		return 1 * 2;
+	case MODE_CLOCK_SELECT_BUSCLOCK16:
+		return 16 * 2;
+	case MODE_CLOCK_SELECT_BUSCLOCK256:
+		return 256 * 2;
+	case MODE_CLOCK_SELECT_EXTERNAL:
+	{
+		assert(m_gs);
+		uint32 hSyncFreq = m_gs->GetCrtHSyncFrequency();
+		return PS2::EE_CLOCK_FREQ / hSyncFreq;
+	}
+	}
+}
 
-		if(!(timer.nMODE & MODE_COUNT_ENABLE)) continue;
+uint32 CTimer::GetTimerCount(const TIMER& timer) const
+{
+	//No compare or overflow point can be crossed before the next event, so the
+	//current count can be derived from the elapsed ticks alone
+	assert(m_totalTicks < m_nextEventTicks);
+	if(!(timer.nMODE & MODE_COUNT_ENABLE)) return timer.nCOUNT;
+	uint64 totalTicks = timer.clockRemain + (m_totalTicks - timer.baseTicks);
+	return timer.nCOUNT + static_cast<uint32>(totalTicks / GetTimerDivider(timer));
+}
 
-		uint32 previousCount = timer.nCOUNT;
-		uint32 nextCount = timer.nCOUNT;
+void CTimer::SyncTimer(unsigned int timerId)
+{
+	auto& timer = m_timer[timerId];
 
-		uint32 divider = 1;
-		//BUSCLOCK runs at half EE frequency
-		switch(timer.nMODE & MODE_CLOCK_SELECT)
-		{
-		case MODE_CLOCK_SELECT_BUSCLOCK:
-			divider = 1 * 2;
-			break;
-		case MODE_CLOCK_SELECT_BUSCLOCK16:
-			divider = 16 * 2;
-			break;
-		case MODE_CLOCK_SELECT_BUSCLOCK256:
-			divider = 256 * 2;
-			break;
-		case MODE_CLOCK_SELECT_EXTERNAL:
-		{
-			assert(m_gs);
-			uint32 hSyncFreq = m_gs->GetCrtHSyncFrequency();
-			divider = PS2::EE_CLOCK_FREQ / hSyncFreq;
-		}
-		break;
-		}
+	uint64 elapsedTicks = m_totalTicks - timer.baseTicks;
+	timer.baseTicks = m_totalTicks;
 
-		//Compute increment
-		uint32 totalTicks = timer.clockRemain + ticks;
-		uint32 countAdd = totalTicks / divider;
-		timer.clockRemain = totalTicks % divider;
-		nextCount = previousCount + countAdd;
+	if(!(timer.nMODE & MODE_COUNT_ENABLE)) return;
 
-		uint32 compare = (timer.nCOMP == 0) ? 0x10000 : timer.nCOMP;
-		uint32 newFlags = 0;
+	uint32 previousCount = timer.nCOUNT;
+	uint32 nextCount = timer.nCOUNT;
+
+	uint32 divider = GetTimerDivider(timer);
+
+	//Compute increment
+	uint64 totalTicks = timer.clockRemain + elapsedTicks;
+	uint32 countAdd = static_cast<uint32>(totalTicks / divider);
+	timer.clockRemain = static_cast<uint32>(totalTicks % divider);
+	nextCount = previousCount + countAdd;
+
+	uint32 compare = (timer.nCOMP == 0) ? 0x10000 : timer.nCOMP;
+	uint32 newFlags = 0;
 
-		//Check if it hit the reference value
-		if((previousCount < compare) && (nextCount >= compare))
+	//Check if it hit the reference value
+	if((previousCount < compare) && (nextCount >= compare))
+	{
+		newFlags |= MODE_EQUAL_FLAG;
+		if(timer.nMODE & MODE_ZERO_RETURN)
 		{
-			newFlags |= MODE_EQUAL_FLAG;
-			if(timer.nMODE & MODE_ZERO_RETURN)
-			{
-				timer.nCOUNT = nextCount - compare;
-			}
-			else
-			{
-				timer.nCOUNT = nextCount;
-			}
+			timer.nCOUNT = nextCount - compare;
 		}
 		else
 		{
 			timer.nCOUNT = nextCount;
 		}
+	}
+	else
+	{
+		timer.nCOUNT = nextCount;
+	}
 
-		if(timer.nCOUNT >= 0x10000)
-		{
-			newFlags |= MODE_OVERFLOW_FLAG;
-			timer.nCOUNT &= 0xFFFF;
-		}
-		timer.nMODE |= newFlags;
+	if(timer.nCOUNT >= 0x10000)
+	{
+		newFlags |= MODE_OVERFLOW_FLAG;
+		timer.nCOUNT &= 0xFFFF;
+	}
+	timer.nMODE |= newFlags;
+
+	uint32 nMask = (timer.nMODE & 0x300) << 2;
+	bool interruptPending = (newFlags & nMask) != 0;
+	if(interruptPending)
+	{
+		m_intc.AssertLine(CINTC::INTC_LINE_TIMER0 + timerId);
+	}
+}
+
+void CTimer::SyncTimers()
+{
+	for(unsigned int i = 0; i < MAX_TIMER; i++)
+	{
+		SyncTimer(i);
+	}
+	UpdateNextEventTicks();
+}
 
-		uint32 nMask = (timer.nMODE & 0x300) << 2;
-		bool interruptPending = (newFlags & nMask) != 0;
-		if(interruptPending)
+void CTimer::UpdateNextEventTicks()
+{
+	//Find the earliest time at which a timer will reach its compare value or overflow
+	m_nextEventTicks = ~0ULL;
+	for(unsigned int i = 0; i < MAX_TIMER; i++)
+	{
+		const auto& timer = m_timer[i];
+		if(!(timer.nMODE & MODE_COUNT_ENABLE)) continue;
+
+		uint32 compare = (timer.nCOMP == 0) ? 0x10000 : timer.nCOMP;
+		uint32 eventCount = (timer.nCOUNT < compare) ? compare : 0x10000;
+		uint64 eventTicks = timer.baseTicks + 1;
+		if(eventCount > timer.nCOUNT)
 		{
-			m_intc.AssertLine(CINTC::INTC_LINE_TIMER0 + i);
+			uint64 ticksToEvent = static_cast<uint64>(eventCount - timer.nCOUNT) * GetTimerDivider(timer);
+			if(ticksToEvent > timer.clockRemain)
+			{
+				eventTicks = timer.baseTicks + ticksToEvent - timer.clockRemain;
+			}
 		}
+		m_nextEventTicks = std::min(m_nextEventTicks, eventTicks);
 	}
 }
 
@@ -104,10 +158,16 @@ uint32 CTimer::GetRegister(uint32 nAddress)
 
 	unsigned int nTimerId = (nAddress >> 11) & 0x3;
 
+	//Flags and counts only need to be brought up to date if an event is due
+	if(m_totalTicks >= m_nextEventTicks)
+	{
+		SyncTimers();
+	}
+
 	switch(nAddress & 0x7FF)
 	{
 	case 0x00:
-		return m_timer[nTimerId].nCOUNT & 0xFFFF;
+		return GetTimerCount(m_timer[nTimerId]) & 0xFFFF;
 		break;
 	case 0x04:
 	case 0x08:
@@ -152,6 +212,8 @@ void CTimer::SetRegister(uint32 nAddress, uint32 nValue)
 
 	unsigned int nTimerId = (nAddress >> 11) & 0x3;
 
+	SyncTimers();
+
 	switch(nAddress & 0x7FF)
 	{
 	case 0x00:
@@ -192,6 +254,8 @@ void CTimer::SetRegister(uint32 nAddress, uint32 nValue)
 		CLog::GetInstance().Warn(LOG_NAME, "Wrote to an unhandled IO port (0x%08X, 0x%08X).\r\n", nAddress, nValue);
 		break;
 	}
+
+	UpdateNextEventTicks();
 }
 
 void CTimer::DisassembleGet(uint32 nAddress)
@@ -254,11 +318,14 @@ void CTimer::LoadState(Framework::CZipArchiveReader& archive)
 		timer.nCOMP = registerFile.GetRegister32((timerPrefix + "COMP").c_str());
 		timer.nHOLD = registerFile.GetRegister32((timerPrefix + "HOLD").c_str());
 		timer.clockRemain = registerFile.GetRegister32((timerPrefix + "REM").c_str());
+		timer.baseTicks = m_totalTicks;
 	}
+	UpdateNextEventTicks();
 }
 
 void CTimer::SaveState(Framework::CZipArchiveWriter& archive)
 {
+	SyncTimers();
 	auto registerFile = std::make_unique<CRegisterStateFile>(STATE_REGS_XML);
 	for(unsigned int i = 0; i < MAX_TIMER; i++)
 	{
@@ -285,6 +352,9 @@ void CTimer::NotifyVBlankEnd()
 
 void CTimer::ProcessGateEdgeChange(uint32 gate, uint32 edgeMode)
 {
+	//Also keeps timers using the HBLANK clock from accumulating too many ticks
+	//with an outdated divider if the video mode changes
+	SyncTimers();
 	for(unsigned int i = 0; i < MAX_TIMER; i++)
 	{
 		auto& timer = m_timer[i];
@@ -300,4 +370,5 @@ void CTimer::ProcessGateEdgeChange(uint32 gate, uint32 edgeMode)
 			timer.clockRemain = 0;
 		}
 	}
+	UpdateNextEventTicks();
 }
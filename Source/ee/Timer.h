@@ -77,6 +77,9 @@ private:
 
 	void ProcessGateEdgeChange(uint32, uint32);
 
+	//Timer counts are only brought up to date when they are accessed or when one of them
+	//reaches its next compare or overflow point. In between, nCOUNT and clockRemain hold
+	//the state of the timer at baseTicks.
 	struct TIMER
 	{
 		uint32 nCOUNT;
@@ -85,9 +88,18 @@ private:
 		uint32 nHOLD;
 
 		uint32 clockRemain;
+		uint64 baseTicks;
 	};
 
+	uint32 GetTimerDivider(const TIMER&) const;
+	uint32 GetTimerCount(const TIMER&) const;
+	void SyncTimer(unsigned int);
+	void SyncTimers();
+	void UpdateNextEventTicks();
+
 	TIMER m_timer[MAX_TIMER];
+	uint64 m_totalTicks = 0;
+	uint64 m_nextEventTicks = ~0ULL;
 	CINTC& m_intc;
 	CGSHandler*& m_gs;
 };
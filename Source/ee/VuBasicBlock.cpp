@@ -23,6 +23,7 @@ void CVuBasicBlock::CompileRange(CMipsJitter* jitter)
 {
 	CompileProlog(jitter);
 	jitter->MarkFirstBlockLabel();
+	CompileEntryCounter(jitter);
 
 	assert((m_begin & 0x07) == 0);
 	assert(((m_end + 4) & 0x07) == 0);
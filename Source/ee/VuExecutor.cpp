@@ -1,3 +1,4 @@
+#include <set>
 #include "VuExecutor.h"
 #include "VuBasicBlock.h"
 #include "VUShared.h"
@@ -19,24 +20,26 @@ CVuExecutor::CVuExecutor(CMIPS& context, uint32 maxAddress)
 void CVuExecutor::Reset()
 {
 	m_cachedBlocks.clear();
+	m_cachedPrograms.clear();
 	CGenericMipsExecutor::Reset();
 }
 
+CVuExecutor::PROGRAM_CACHE_STATS CVuExecutor::GetProgramCacheStats() const
+{
+	return m_programCacheStats;
+}
+
+void CVuExecutor::ResetProgramCacheStats()
+{
+	m_programCacheStats = PROGRAM_CACHE_STATS();
+}
+
 BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end)
 {
 	uint32 blockSize = ((end - begin) + 4) / 4;
 	uint32 blockSizeByte = blockSize * 4;
 
-	auto map = m_context.m_pMemoryMap->GetInstructionMap(begin);
-	assert(m_context.m_pMemoryMap->GetInstructionMap(end) == map);
-	uint32 localBegin = begin - map->nStart;
-	auto blockMemory = reinterpret_cast<const uint32*>(reinterpret_cast<uint8*>(map->pPointer) + localBegin);
-
-	auto xxHash = XXH3_128bits(blockMemory, blockSizeByte);
-	uint128 hash;
-	memcpy(&hash, &xxHash, sizeof(xxHash));
-	static_assert(sizeof(hash) == sizeof(xxHash));
-	auto blockKey = std::make_pair(hash, blockSizeByte);
+	auto blockKey = std::make_pair(HashRange(begin, begin + blockSizeByte), blockSizeByte);
 
 	//Don't use the cached blocks of we have a breakpoint in our block range.
 	bool hasBreakpoint = m_context.HasBreakpointInRange(begin, end);
@@ -50,6 +53,7 @@ BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end
 			const auto& basicBlock(blockIterator->second);
 			if(basicBlock->GetBeginAddress() == begin && basicBlock->GetEndAddress() == end)
 			{
+				m_programCacheStats.blockHits++;
 				return basicBlock;
 			}
 		}
@@ -59,11 +63,13 @@ BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end
 			auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
 			result->CopyFunctionFrom(beginBlockIterator->second);
 			m_cachedBlocks.insert(std::make_pair(blockKey, result));
+			m_programCacheStats.blockHits++;
 			return result;
 		}
 	}
 
 	//Totally new block, build it from scratch
+	m_programCacheStats.blockCompiles++;
 	auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
 
 	auto blockCompileHintsIterator = std::find_if(std::begin(g_blockCompileHints), std::end(g_blockCompileHints),
@@ -82,9 +88,21 @@ BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end
 }
 
 void CVuExecutor::PartitionFunction(uint32 startAddress)
+{
+	if(LinkCachedProgram(startAddress))
+	{
+		m_programCacheStats.programHits++;
+		return;
+	}
+	m_programCacheStats.programMisses++;
+	CompileProgram(startAddress);
+}
+
+uint32 CVuExecutor::FindBlockEnd(uint32 startAddress, uint32& branchAddress, bool& hasNext) const
 {
 	uint32 endAddress = std::min<uint32>(startAddress + MAX_BLOCK_SIZE - 4, m_maxAddress - 4);
-	uint32 branchAddress = MIPS_INVALID_PC;
+	branchAddress = MIPS_INVALID_PC;
+	hasNext = true;
 	for(uint32 address = startAddress; address < endAddress; address += 8)
 	{
 		uint32 addrLo = address + 0;
@@ -95,6 +113,7 @@ void CVuExecutor::PartitionFunction(uint32 startAddress)
 		if(upperOp & VUShared::VU_UPPEROP_BIT_E)
 		{
 			endAddress = address + 0xC;
+			hasNext = false;
 			break;
 		}
 		else if(upperOp & (VUShared::VU_UPPEROP_BIT_D | VUShared::VU_UPPEROP_BIT_T))
@@ -106,6 +125,9 @@ void CVuExecutor::PartitionFunction(uint32 startAddress)
 		{
 			branchAddress = m_context.m_pArch->GetInstructionEffectiveAddress(&m_context, addrLo, lowerOp);
 			endAddress = address + 0xC;
+			//B (0x20) and JR (0x24) never fall through to the next block
+			uint32 lowerOpId = (lowerOp >> 25) & 0x7F;
+			hasNext = (lowerOpId != 0x20) && (lowerOpId != 0x24);
 			break;
 		}
 		else if(branchType == MIPS_BRANCH_NODELAY)
@@ -115,10 +137,124 @@ void CVuExecutor::PartitionFunction(uint32 startAddress)
 		}
 	}
 	assert((endAddress - startAddress) <= MAX_BLOCK_SIZE);
-	CreateBlock(startAddress, endAddress);
-	auto block = static_cast<CVuBasicBlock*>(FindBlockStartingAt(startAddress));
-	if(block->IsLinkable())
+	return endAddress;
+}
+
+uint128 CVuExecutor::HashRange(uint32 begin, uint32 end) const
+{
+	auto map = m_context.m_pMemoryMap->GetInstructionMap(begin);
+	assert(m_context.m_pMemoryMap->GetInstructionMap(end - 4) == map);
+	uint32 localBegin = begin - map->nStart;
+	auto rangeMemory = reinterpret_cast<const uint8*>(map->pPointer) + localBegin;
+
+	auto xxHash = XXH3_128bits(rangeMemory, end - begin);
+	uint128 hash;
+	memcpy(&hash, &xxHash, sizeof(xxHash));
+	static_assert(sizeof(hash) == sizeof(xxHash));
+	return hash;
+}
+
+bool CVuExecutor::LinkCachedProgram(uint32 entryAddress)
+{
+	auto programRange = m_cachedPrograms.equal_range(entryAddress);
+	for(auto programIterator = programRange.first; programIterator != programRange.second; programIterator++)
+	{
+		const auto& program = programIterator->second;
+		if(m_context.HasBreakpointInRange(program.begin, program.end - 4)) continue;
+		if(!(HashRange(program.begin, program.end) == program.hash)) continue;
+
+		//Same contents as when the program was compiled, put back all its blocks and link them together
+		std::vector<const PROGRAM_BLOCK*> insertedBlocks;
+		for(const auto& programBlock : program.blocks)
+		{
+			if(HasBlockAt(programBlock.block->GetBeginAddress())) continue;
+			InsertBlock(programBlock.block);
+			insertedBlocks.push_back(&programBlock);
+		}
+		for(const auto& programBlock : insertedBlocks)
+		{
+			auto block = static_cast<CVuBasicBlock*>(programBlock->block.get());
+			if(block->IsLinkable())
+			{
+				SetupBlockLinks(block->GetBeginAddress(), block->GetEndAddress(), programBlock->branchAddress);
+			}
+		}
+		assert(HasBlockAt(entryAddress));
+		return true;
+	}
+	return false;
+}
+
+void CVuExecutor::CompileProgram(uint32 entryAddress)
+{
+	CACHED_PROGRAM program;
+	program.begin = entryAddress;
+	program.end = entryAddress;
+	bool cacheable = true;
+
+	std::vector<uint32> createdBlockIndices;
+	std::vector<uint32> pendingAddresses = {entryAddress};
+	std::set<uint32> visitedAddresses;
+	while(!pendingAddresses.empty() && (program.blocks.size() < MAX_PROGRAM_BLOCKS))
+	{
+		uint32 startAddress = pendingAddresses.back();
+		pendingAddresses.pop_back();
+		if(!visitedAddresses.insert(startAddress).second) continue;
+
+		uint32 branchAddress = MIPS_INVALID_PC;
+		bool hasNext = false;
+		uint32 endAddress = FindBlockEnd(startAddress, branchAddress, hasNext);
+
+		auto block = FindBlockStartingAt(startAddress);
+		if(block->IsEmpty())
+		{
+			CreateBlock(startAddress, endAddress);
+			block = FindBlockStartingAt(startAddress);
+			createdBlockIndices.push_back(program.blocks.size());
+		}
+		else if(block->GetEndAddress() != endAddress)
+		{
+			cacheable = false;
+			continue;
+		}
+
+		PROGRAM_BLOCK programBlock;
+		programBlock.block = block->shared_from_this();
+		programBlock.branchAddress = branchAddress;
+		program.blocks.push_back(std::move(programBlock));
+		program.begin = std::min(program.begin, startAddress);
+		program.end = std::max(program.end, endAddress + 4);
+
+		if(branchAddress != MIPS_INVALID_PC)
+		{
+			pendingAddresses.push_back(branchAddress & m_addressMask);
+		}
+		if(hasNext && ((endAddress + 4) < m_maxAddress))
+		{
+			pendingAddresses.push_back(endAddress + 4);
+		}
+	}
+
+	//Link all new blocks once they've been created to avoid going through the empty block handler
+	for(auto blockIndex : createdBlockIndices)
+	{
+		const auto& programBlock = program.blocks[blockIndex];
+		auto block = static_cast<CVuBasicBlock*>(programBlock.block.get());
+		if(block->IsLinkable())
+		{
+			SetupBlockLinks(block->GetBeginAddress(), block->GetEndAddress(), programBlock.branchAddress);
+		}
+	}
+	assert(HasBlockAt(entryAddress));
+
+	if(!cacheable) return;
+	if(m_context.HasBreakpointInRange(program.begin, program.end - 4)) return;
+
+	program.hash = HashRange(program.begin, program.end);
+	if(m_cachedPrograms.count(entryAddress) >= MAX_CACHED_PROGRAMS_PER_ENTRY)
 	{
-		SetupBlockLinks(startAddress, endAddress, branchAddress);
+		//Drop the oldest program for this entry point
+		m_cachedPrograms.erase(m_cachedPrograms.lower_bound(entryAddress));
 	}
+	m_cachedPrograms.insert(std::make_pair(entryAddress, std::move(program)));
 }
@@ -1,17 +1,35 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include "../GenericMipsExecutor.h"
 
 class CVuExecutor : public CGenericMipsExecutor<BlockLookupOneWay, 8>
 {
 public:
+	struct PROGRAM_CACHE_STATS
+	{
+		int32 programHits = 0;
+		int32 programMisses = 0;
+		int32 blockHits = 0;
+		int32 blockCompiles = 0;
+	};
+
 	CVuExecutor(CMIPS&, uint32);
 	virtual ~CVuExecutor() = default;
 
 	void Reset() override;
 
+	PROGRAM_CACHE_STATS GetProgramCacheStats() const;
+	void ResetProgramCacheStats();
+
 protected:
+	enum
+	{
+		MAX_PROGRAM_BLOCKS = 0x100,
+		MAX_CACHED_PROGRAMS_PER_ENTRY = 8,
+	};
+
 	typedef std::pair<uint128, uint32> CachedBlockKey;
 	typedef std::multimap<CachedBlockKey, BasicBlockPtr> CachedBlockMap;
 
@@ -21,9 +39,33 @@ protected:
 		uint32 hints;
 	};
 
+	struct PROGRAM_BLOCK
+	{
+		BasicBlockPtr block;
+		uint32 branchAddress = MIPS_INVALID_PC;
+	};
+
+	//A microprogram is all blocks reachable from an entry point until an E bit is met.
+	//It is keyed by the contents of the micro memory range spanned by its blocks.
+	struct CACHED_PROGRAM
+	{
+		uint32 begin = 0;
+		uint32 end = 0;
+		uint128 hash;
+		std::vector<PROGRAM_BLOCK> blocks;
+	};
+	typedef std::multimap<uint32, CACHED_PROGRAM> CachedProgramMap;
+
 	BasicBlockPtr BlockFactory(CMIPS&, uint32, uint32) override;
 	void PartitionFunction(uint32) override;
 
+	uint32 FindBlockEnd(uint32, uint32&, bool&) const;
+	uint128 HashRange(uint32, uint32) const;
+	bool LinkCachedProgram(uint32);
+	void CompileProgram(uint32);
+
 	static const BLOCK_COMPILE_HINTS g_blockCompileHints[];
 	CachedBlockMap m_cachedBlocks;
+	CachedProgramMap m_cachedPrograms;
+	PROGRAM_CACHE_STATS m_programCacheStats;
 };
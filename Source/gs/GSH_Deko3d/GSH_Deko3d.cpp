@@ -447,7 +447,7 @@ void CGSH_Deko3d::VertexKick(uint8 registerId, uint64 data)
 	bool drawingKick = (registerId == GS_REG_XYZ2) || (registerId == GS_REG_XYZF2);
 	bool fog = (registerId == GS_REG_XYZF2) || (registerId == GS_REG_XYZF3);
 
-	if(!m_drawEnabled)
+	if(!m_drawEnabled || m_frameSkipped)
 		drawingKick = false;
 
 	if(fog)
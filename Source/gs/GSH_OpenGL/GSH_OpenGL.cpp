@@ -1927,7 +1927,7 @@ void CGSH_OpenGL::VertexKick(uint8 nRegister, uint64 nValue)
 	bool nDrawingKick = (nRegister == GS_REG_XYZ2) || (nRegister == GS_REG_XYZF2);
 	bool nFog = (nRegister == GS_REG_XYZF2) || (nRegister == GS_REG_XYZF3);
 
-	if(!m_drawEnabled) nDrawingKick = false;
+	if(!m_drawEnabled || m_frameSkipped) nDrawingKick = false;
 
 	if(nFog)
 	{
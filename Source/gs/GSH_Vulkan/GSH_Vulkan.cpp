@@ -260,6 +260,8 @@ void CGSH_Vulkan::ResetImpl()
 	m_pendingPrimValue = 0;
 	m_regState.isValid = false;
 	memset(&m_clutStates, 0, sizeof(m_clutStates));
+	m_xferHistory.clear();
+	m_drawTargetsTracked = false;
 	memset(m_memoryCache, 0, RAMSIZE);
 	WriteBackMemoryCache();
 }
@@ -274,6 +276,7 @@ void CGSH_Vulkan::MarkNewFrame()
 {
 	m_drawCallCount = m_frameCommandBuffer->GetFlushCount();
 	m_frameCommandBuffer->ResetFlushCount();
+	PrefetchLocalToHostTransfers();
 	m_frameCommandBuffer->EndFrame();
 	m_frameCommandBuffer->BeginFrame();
 	CGSHandler::MarkNewFrame();
@@ -632,7 +635,7 @@ void CGSH_Vulkan::VertexKick(uint8 registerId, uint64 data)
 	bool drawingKick = (registerId == GS_REG_XYZ2) || (registerId == GS_REG_XYZF2);
 	bool fog = (registerId == GS_REG_XYZF2) || (registerId == GS_REG_XYZF3);
 
-	if(!m_drawEnabled) drawingKick = false;
+	if(!m_drawEnabled || m_frameSkipped) drawingKick = false;
 
 	if(fog)
 	{
@@ -667,6 +670,7 @@ void CGSH_Vulkan::VertexKick(uint8 registerId, uint64 data)
 		if(drawingKick)
 		{
 			SetRenderingContext(m_primitiveMode);
+			InvalidateLocalToHostTransfersForDraw(m_primitiveMode);
 		}
 
 		switch(m_primitiveType)
@@ -1426,6 +1430,9 @@ void CGSH_Vulkan::ProcessHostToLocalTransfer()
 	m_transferHost->DoTransfer(m_xferBuffer);
 
 	m_xferBuffer.clear();
+
+	auto [transferAddress, transferSize] = GsTransfer::GetDstRange(bltBuf, trxReg, trxPos);
+	InvalidateLocalToHostTransfers(transferAddress, transferSize);
 }
 
 void CGSH_Vulkan::ProcessLocalToHostTransfer()
@@ -1439,10 +1446,6 @@ void CGSH_Vulkan::ProcessLocalToHostTransfer()
 		auto trxReg = make_convertible<TRXREG>(m_nReg[GS_REG_TRXREG]);
 		auto trxPos = make_convertible<TRXPOS>(m_nReg[GS_REG_TRXPOS]);
 
-		m_xferHistory.insert(std::make_pair(bltBuf, LOCAL_TO_HOST_XFER_HISTORY{}));
-		auto transfer = m_xferHistory.find(bltBuf);
-		transfer->second.MarkUsed();
-
 		auto [copyBase, copySize] = GsTransfer::GetSrcRange(bltBuf, trxReg, trxPos);
 
 		//Some games do that, example: Star Ocean 3
@@ -1457,33 +1460,40 @@ void CGSH_Vulkan::ProcessLocalToHostTransfer()
 			copySize = RAMSIZE - copyBase;
 		}
 
-		auto& srcBuffer = m_context->memoryBuffer;
-		auto& dstBuffer = m_context->memoryBufferTransfer;
-
-		auto commandBuffer = m_frameCommandBuffer->GetCommandBuffer();
-
+		auto transferKey = std::make_tuple(m_nReg[GS_REG_BITBLTBUF], m_nReg[GS_REG_TRXPOS], m_nReg[GS_REG_TRXREG]);
+		auto transferIterator = m_xferHistory.find(transferKey);
+		if(transferIterator == std::end(m_xferHistory))
 		{
-			auto memoryBarrier = Framework::Vulkan::MemoryBarrier();
-			memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-			memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-			m_context->device.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-			                                       0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+			transferIterator = m_xferHistory.insert(std::make_pair(transferKey, LOCAL_TO_HOST_XFER_HISTORY{})).first;
+			auto& transfer = transferIterator->second;
+			transfer.copyBase = copyBase;
+			transfer.copySize = copySize;
+			transfer.srcArea.SetArea(bltBuf.nSrcPsm, bltBuf.GetSrcPtr(), bltBuf.GetSrcWidth(), trxPos.nSSAY + trxReg.nRRH);
 		}
+		auto& transfer = transferIterator->second;
+		transfer.MarkUsed();
 
+		//Draws and transfers made after the prefetch mark the pages they write in the source area
+		if(transfer.prefetchValid && !transfer.srcArea.HasDirtyPages())
 		{
-			VkBufferCopy bufferCopy = {};
-			bufferCopy.size = copySize;
-			bufferCopy.dstOffset = copyBase;
-			bufferCopy.srcOffset = copyBase;
-			m_context->device.vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &bufferCopy);
+			//Data was copied at the end of the frame that produced it, this will
+			//only wait if the GPU is still working on that frame.
+			m_frameCommandBuffer->WaitForSerial(transfer.prefetchSerial);
 		}
-
-		if(!transfer->second.IsRecurring())
+		else
 		{
-			m_frameCommandBuffer->Flush();
-			m_context->device.vkQueueWaitIdle(m_context->queue);
+			RecordLocalToHostCopy(copyBase, copySize);
+			//Recurring transfers don't wait, they get the data copied by the previous transfer
+			if(!transfer.IsRecurring())
+			{
+				auto copySerial = m_frameCommandBuffer->GetCurrentSerial();
+				m_frameCommandBuffer->Flush();
+				m_frameCommandBuffer->WaitForSerial(copySerial);
+			}
 		}
+		transfer.prefetchValid = false;
+
+		auto& dstBuffer = m_context->memoryBufferTransfer;
 
 		void* bufferPtr = nullptr;
 		auto result = m_context->device.vkMapMemory(m_context->device, dstBuffer.GetMemory(), copyBase, copySize, 0, &bufferPtr);
@@ -1495,6 +1505,96 @@ void CGSH_Vulkan::ProcessLocalToHostTransfer()
 	}
 }
 
+void CGSH_Vulkan::RecordLocalToHostCopy(uint32 copyBase, uint32 copySize)
+{
+	auto& srcBuffer = m_context->memoryBuffer;
+	auto& dstBuffer = m_context->memoryBufferTransfer;
+
+	auto commandBuffer = m_frameCommandBuffer->GetCommandBuffer();
+
+	{
+		auto memoryBarrier = Framework::Vulkan::MemoryBarrier();
+		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		m_context->device.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
+		                                       0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	{
+		VkBufferCopy bufferCopy = {};
+		bufferCopy.size = copySize;
+		bufferCopy.dstOffset = copyBase;
+		bufferCopy.srcOffset = copyBase;
+		m_context->device.vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &bufferCopy);
+	}
+}
+
+void CGSH_Vulkan::PrefetchLocalToHostTransfers()
+{
+	//Games that read back the same area every frame will get their data from
+	//the copy made here instead of waiting for the GPU to go idle.
+	bool flushed = false;
+	for(auto& transferPair : m_xferHistory)
+	{
+		auto& transfer = transferPair.second;
+		if(!transfer.IsRecurring()) continue;
+		if(transfer.srcArea.GetPageCount() == 0) continue;
+		if(!flushed)
+		{
+			m_draw->FlushRenderPass();
+			flushed = true;
+		}
+		RecordLocalToHostCopy(transfer.copyBase, transfer.copySize);
+		transfer.srcArea.ClearDirtyPages();
+		transfer.prefetchSerial = m_frameCommandBuffer->GetCurrentSerial();
+		transfer.prefetchValid = true;
+	}
+	//Dirty pages were cleared, the next draw needs to mark them again
+	m_drawTargetsTracked = false;
+}
+
+void CGSH_Vulkan::InvalidateLocalToHostTransfersForDraw(uint64 primReg)
+{
+	if(m_xferHistory.empty()) return;
+
+	auto prim = make_convertible<PRMODE>(primReg);
+	unsigned int context = prim.nContext;
+
+	//Pages of the buffers drawn to only need to be marked when these buffers change
+	auto drawTargets = std::make_tuple(m_nReg[GS_REG_FRAME_1 + context], m_nReg[GS_REG_ZBUF_1 + context], m_nReg[GS_REG_SCISSOR_1 + context]);
+	if(m_drawTargetsTracked && (m_trackedDrawTargets == drawTargets)) return;
+	m_trackedDrawTargets = drawTargets;
+	m_drawTargetsTracked = true;
+
+	auto frame = make_convertible<FRAME>(m_nReg[GS_REG_FRAME_1 + context]);
+	auto zbuf = make_convertible<ZBUF>(m_nReg[GS_REG_ZBUF_1 + context]);
+	auto scissor = make_convertible<SCISSOR>(m_nReg[GS_REG_SCISSOR_1 + context]);
+
+	uint32 height = scissor.scay1 + 1;
+	InvalidateLocalToHostTransfers(frame.GetBasePtr(), GetBufferSize(frame.nPsm, frame.GetWidth(), height));
+	if(zbuf.nMask == 0)
+	{
+		InvalidateLocalToHostTransfers(zbuf.GetBasePtr(), GetBufferSize(zbuf.nPsm | 0x30, frame.GetWidth(), height));
+	}
+}
+
+uint32 CGSH_Vulkan::GetBufferSize(uint32 psm, uint32 width, uint32 height)
+{
+	auto pageSize = CGsPixelFormats::GetPsmPageSize(psm);
+	uint32 pageCountX = (width + pageSize.first - 1) / pageSize.first;
+	uint32 pageCountY = (height + pageSize.second - 1) / pageSize.second;
+	return pageCountX * pageCountY * CGsPixelFormats::PAGESIZE;
+}
+
+void CGSH_Vulkan::InvalidateLocalToHostTransfers(uint32 memoryStart, uint32 memorySize)
+{
+	for(auto& transferPair : m_xferHistory)
+	{
+		transferPair.second.srcArea.Invalidate(memoryStart, memorySize);
+	}
+}
+
 void CGSH_Vulkan::ProcessLocalToLocalTransfer()
 {
 	//Flush previous cached info
@@ -1544,6 +1644,9 @@ void CGSH_Vulkan::ProcessLocalToLocalTransfer()
 
 	m_transferLocal->SetPipelineCaps(pipelineCaps);
 	m_transferLocal->DoTransfer();
+
+	auto [transferAddress, transferSize] = GsTransfer::GetDstRange(bltBuf, trxReg, trxPos);
+	InvalidateLocalToHostTransfers(transferAddress, transferSize);
 }
 
 void CGSH_Vulkan::ProcessClutTransfer(uint32 csa, uint32)
@@ -1563,6 +1666,7 @@ void CGSH_Vulkan::TransferWrite(const uint8* imageData, uint32 length)
 
 void CGSH_Vulkan::WriteBackMemoryCache()
 {
+	InvalidateLocalToHostTransfers(0, RAMSIZE);
 	m_frameCommandBuffer->Flush();
 	m_context->device.vkQueueWaitIdle(m_context->queue);
 
@@ -12,6 +12,7 @@
 #include "GSH_VulkanTransferLocal.h"
 #include <vector>
 #include <map>
+#include <tuple>
 #include <cstring>
 #include "../GSHandler.h"
 #include "../GsDebuggerInterface.h"
@@ -106,6 +107,14 @@ private:
 		std::array<bool, MAX_FRAME_COUNT> used = {};
 		int frameCount = 0;
 
+		//Source range is copied in the transfer buffer at the end of every frame for recurring
+		//transfers. Prefetched data stays valid until a transfer or a draw writes in the source area.
+		uint32 copyBase = 0;
+		uint32 copySize = 0;
+		CGsCachedArea srcArea;
+		uint64 prefetchSerial = 0;
+		bool prefetchValid = false;
+
 		void Advance()
 		{
 			frameCount++;
@@ -149,6 +158,12 @@ private:
 	void CreateMemoryBuffer();
 	void CreateClutBuffer();
 
+	void RecordLocalToHostCopy(uint32, uint32);
+	void PrefetchLocalToHostTransfers();
+	void InvalidateLocalToHostTransfers(uint32, uint32);
+	void InvalidateLocalToHostTransfersForDraw(uint64);
+	static uint32 GetBufferSize(uint32, uint32, uint32);
+
 	void ProcessPrim(uint64);
 	void VertexKick(uint8, uint64);
 	void SetRenderingContext(uint64);
@@ -253,7 +268,13 @@ private:
 	CLUTKEY m_clutStates[CLUT_CACHE_SIZE];
 	uint32 m_nextClutCacheIndex = 0;
 	std::vector<uint8> m_xferBuffer;
-	std::map<uint64, LOCAL_TO_HOST_XFER_HISTORY> m_xferHistory;
+	//Keyed by BITBLTBUF, TRXPOS and TRXREG
+	typedef std::tuple<uint64, uint64, uint64> LocalToHostXferKey;
+	std::map<LocalToHostXferKey, LOCAL_TO_HOST_XFER_HISTORY> m_xferHistory;
+	//FRAME, ZBUF and SCISSOR of the last draw that marked pages in the local to host transfers
+	typedef std::tuple<uint64, uint64, uint64> DrawTargetsKey;
+	DrawTargetsKey m_trackedDrawTargets;
+	bool m_drawTargetsTracked = false;
 
 	//Optimization for Virtua Fighter 2, Sega Rally 95
 	float m_lastLineU = 0;
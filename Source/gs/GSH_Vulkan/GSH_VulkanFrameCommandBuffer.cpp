@@ -1,3 +1,4 @@
+#include <cassert>
 #include "GSH_VulkanFrameCommandBuffer.h"
 #include "vulkan/StructDefs.h"
 
@@ -84,6 +85,7 @@ void CFrameCommandBuffer::EndFrame()
 
 	m_currentFrame++;
 	m_currentFrame %= MAX_FRAMES;
+	m_currentSerial++;
 }
 
 void CFrameCommandBuffer::Flush()
@@ -113,3 +115,22 @@ uint32 CFrameCommandBuffer::GetCurrentFrame() const
 {
 	return m_currentFrame;
 }
+
+uint64 CFrameCommandBuffer::GetCurrentSerial() const
+{
+	return m_currentSerial;
+}
+
+void CFrameCommandBuffer::WaitForSerial(uint64 serial)
+{
+	if(serial >= m_currentSerial)
+	{
+		Flush();
+	}
+	assert(serial < m_currentSerial);
+	//Fence of that frame has already been waited on and reused if enough frames were submitted since
+	if((m_currentSerial - serial) >= MAX_FRAMES) return;
+	const auto& frame = m_frames[serial % MAX_FRAMES];
+	auto result = m_context->device.vkWaitForFences(m_context->device, 1, &frame.execCompleteFence, VK_TRUE, UINT64_MAX);
+	CHECKVULKANERROR(result);
+}
@@ -35,6 +35,11 @@ namespace GSH_Vulkan
 		VkCommandBuffer GetCommandBuffer();
 		uint32 GetCurrentFrame() const;
 
+		//Serials identify submissions, the current serial is the one that
+		//commands recorded in the current command buffer will be submitted with.
+		uint64 GetCurrentSerial() const;
+		void WaitForSerial(uint64);
+
 	private:
 		struct FRAMECONTEXT
 		{
@@ -48,6 +53,7 @@ namespace GSH_Vulkan
 
 		FRAMECONTEXT m_frames[MAX_FRAMES];
 		uint32 m_currentFrame = 0;
+		uint64 m_currentSerial = 0;
 
 		uint32 m_flushCount = 0;
 	};
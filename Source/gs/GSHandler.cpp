@@ -9,6 +9,7 @@
 #include "../ee/INTC.h"
 #include "GSHandler.h"
 #include "GsPixelFormats.h"
+#include "GsBlockSwizzler.h"
 #include "string_format.h"
 #include "ThreadUtils.h"
 
@@ -61,6 +62,7 @@
 
 CGSHandler::CGSHandler(bool gsThreaded)
     : m_gsThreaded(gsThreaded)
+    , m_gsProfilerZone(CProfiler::GetInstance().RegisterZone("GS"))
 {
 	RegisterPreferences();
 
@@ -167,6 +169,8 @@ void CGSHandler::ResetBase()
 	m_nIMR = ~0;
 	m_nBUSDIR = 0;
 	m_nSIGLBLID = 0;
+	m_frameSkipped = false;
+	m_hasPresentedDisplayInfo = false;
 	m_crtMode = CRT_MODE_NTSC;
 	m_nCBP0 = 0;
 	m_nCBP1 = 0;
@@ -391,6 +395,12 @@ void CGSHandler::SetDrawEnabled(bool drawEnabled)
 	m_drawEnabled = drawEnabled;
 }
 
+void CGSHandler::SetFrameSkipped(bool frameSkipped)
+{
+	//Needs to go through the mailbox to apply to commands queued after this point only
+	SendGSCall([this, frameSkipped]() { m_frameSkipped = frameSkipped; });
+}
+
 void CGSHandler::SetHBlank()
 {
 	std::lock_guard registerMutexLock(m_registerMutex);
@@ -569,7 +579,18 @@ void CGSHandler::Flip(uint32 flags)
 	    [this, displayInfo = GetCurrentDisplayInfo(), force]() {
 		    if(force || m_regsDirty)
 		    {
-			    FlipImpl(displayInfo);
+			    //Nothing was drawn in a skipped frame, the buffer it wants to display is stale.
+			    //Present the last presented buffer again, it still holds the last rendered frame.
+			    if(m_frameSkipped && m_hasPresentedDisplayInfo)
+			    {
+				    FlipImpl(m_presentedDisplayInfo);
+			    }
+			    else
+			    {
+				    m_presentedDisplayInfo = displayInfo;
+				    m_hasPresentedDisplayInfo = true;
+				    FlipImpl(displayInfo);
+			    }
 		    }
 		    m_regsDirty = false;
 	    },
@@ -626,15 +647,16 @@ void CGSHandler::FeedImageData(const void* data, uint32 length)
 	m_transferCount++;
 #endif
 
-	//Allocate 0x10 more bytes to allow transfer handlers
+	//Staging arena pads allocations to allow transfer handlers
 	//to read beyond the actual length of the buffer (ie.: PSMCT24)
+	auto allocation = m_imageStagingArena.Allocate(length);
+	memcpy(CGsStagingArena::GetData(allocation), data, length);
 
-	uint8* imageData = new uint8[length + 0x10];
-	memcpy(imageData, data, length);
-	memset(imageData + length, 0, 0x10);
-
+	//Only capture pointers to keep the function object small enough to not require a heap allocation
 	SendGSCall(
-	    [this, imageData, length]() {
+	    [this, allocation]() {
+		    auto imageData = CGsStagingArena::GetData(allocation);
+		    uint32 length = allocation->size;
 #ifdef DEBUGGER_INCLUDED
 		    if(m_frameDump)
 		    {
@@ -642,10 +664,20 @@ void CGSHandler::FeedImageData(const void* data, uint32 length)
 		    }
 #endif
 		    FeedImageDataImpl(imageData, length);
-		    delete[] imageData;
+		    m_imageStagingArena.Release(allocation);
 	    });
 }
 
+CGsStagingArena::STATS CGSHandler::GetImageStagingStats() const
+{
+	return m_imageStagingArena.GetStats();
+}
+
+void CGSHandler::ResetImageStagingStats()
+{
+	m_imageStagingArena.ResetStats();
+}
+
 void CGSHandler::ReadImageData(void* data, uint32 length)
 {
 	assert(m_writeBufferProcessIndex == m_writeBufferSize);
@@ -984,6 +1016,12 @@ bool CGSHandler::TransferWriteHandlerGeneric(const void* pData, uint32 nLength)
 
 	for(unsigned int i = 0; i < nLength; i++)
 	{
+		if(m_trxCtx.nRRX == 0)
+		{
+			i += TransferWriteBlockRows<Storage>(reinterpret_cast<const uint8*>(pSrc + i), nLength - i, nDirty);
+			if(i == nLength) break;
+		}
+
 		uint32 nX = (m_trxCtx.nRRX + trxPos.nDSAX) % 2048;
 		uint32 nY = (m_trxCtx.nRRY + trxPos.nDSAY) % 2048;
 
@@ -1018,6 +1056,12 @@ bool CGSHandler::TransferWriteHandlerPSMCT24(const void* pData, uint32 nLength)
 
 	for(unsigned int i = 0; i < nLength; i += 3)
 	{
+		if(m_trxCtx.nRRX == 0)
+		{
+			i += TransferWriteBlockRowsMasked<24, 0, 0x00FFFFFF>(pSrc + i, (nLength - i) / 3) * 3;
+			if(i >= nLength) break;
+		}
+
 		uint32 nX = (m_trxCtx.nRRX + trxPos.nDSAX) % 2048;
 		uint32 nY = (m_trxCtx.nRRY + trxPos.nDSAY) % 2048;
 
@@ -1050,6 +1094,12 @@ bool CGSHandler::TransferWriteHandlerPSMT4(const void* pData, uint32 nLength)
 
 	for(unsigned int i = 0; i < nLength; i++)
 	{
+		if(m_trxCtx.nRRX == 0)
+		{
+			i += TransferWriteBlockRows<CGsPixelFormats::STORAGEPSMT4>(pSrc + i, (nLength - i) * 2, dirty) / 2;
+			if(i == nLength) break;
+		}
+
 		uint8 nPixel[2];
 
 		nPixel[0] = (pSrc[i] >> 0) & 0x0F;
@@ -1092,6 +1142,12 @@ bool CGSHandler::TransferWriteHandlerPSMT4H(const void* pData, uint32 nLength)
 
 	for(unsigned int i = 0; i < nLength; i++)
 	{
+		if(m_trxCtx.nRRX == 0)
+		{
+			i += TransferWriteBlockRowsMasked<4, nShift, nMask>(pSrc + i, (nLength - i) * 2) / 2;
+			if(i == nLength) break;
+		}
+
 		//Pixel 1
 		uint32 nX = (m_trxCtx.nRRX + trxPos.nDSAX) % 2048;
 		uint32 nY = (m_trxCtx.nRRY + trxPos.nDSAY) % 2048;
@@ -1142,6 +1198,12 @@ bool CGSHandler::TransferWriteHandlerPSMT8H(const void* pData, uint32 nLength)
 
 	for(unsigned int i = 0; i < nLength; i++)
 	{
+		if(m_trxCtx.nRRX == 0)
+		{
+			i += TransferWriteBlockRowsMasked<8, 24, 0xFF000000>(pSrc + i, nLength - i);
+			if(i == nLength) break;
+		}
+
 		uint32 nX = (m_trxCtx.nRRX + trxPos.nDSAX) % 2048;
 		uint32 nY = (m_trxCtx.nRRY + trxPos.nDSAY) % 2048;
 
@@ -1162,6 +1224,168 @@ bool CGSHandler::TransferWriteHandlerPSMT8H(const void* pData, uint32 nLength)
 	return true;
 }
 
+//Returns the amount of pixels in a row of blocks if the transfer is at the start of a row
+//of blocks that can be processed with block swizzlers, returns 0 otherwise.
+template <typename Storage>
+uint32 CGSHandler::GetTransferBlockRowPixelCount(uint32 startX, uint32 startY) const
+{
+	auto trxReg = make_convertible<TRXREG>(m_nReg[GS_REG_TRXREG]);
+
+	if(m_trxCtx.nRRX != 0) return 0;
+	if((trxReg.nRRW == 0) || ((trxReg.nRRW % Storage::BLOCKWIDTH) != 0)) return 0;
+	if(((startX % Storage::BLOCKWIDTH) != 0) || ((startX + trxReg.nRRW) > 2048)) return 0;
+
+	uint32 y = (m_trxCtx.nRRY + startY) % 2048;
+	if(((y % Storage::BLOCKHEIGHT) != 0) || ((y + Storage::BLOCKHEIGHT) > 2048)) return 0;
+
+	return trxReg.nRRW * Storage::BLOCKHEIGHT;
+}
+
+//Writes as many complete rows of blocks as possible, returns the amount of pixels consumed
+template <typename Storage>
+uint32 CGSHandler::TransferWriteBlockRows(const uint8* src, uint32 pixelCount, bool& dirty)
+{
+	typedef CGsBlockSwizzler<Storage> Swizzler;
+
+	auto trxPos = make_convertible<TRXPOS>(m_nReg[GS_REG_TRXPOS]);
+	auto trxBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
+
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(m_pRAM, trxBuf.GetDstPtr(), trxBuf.nDstWidth);
+
+	uint32 processed = 0;
+	while(1)
+	{
+		uint32 blockRowPixelCount = GetTransferBlockRowPixelCount<Storage>(trxPos.nDSAX, trxPos.nDSAY);
+		if((blockRowPixelCount == 0) || ((pixelCount - processed) < blockRowPixelCount)) break;
+
+		uint32 width = blockRowPixelCount / Storage::BLOCKHEIGHT;
+		uint32 y = (m_trxCtx.nRRY + trxPos.nDSAY) % 2048;
+		for(uint32 blockX = 0; blockX < width; blockX += Storage::BLOCKWIDTH)
+		{
+			uint32 x = trxPos.nDSAX + blockX;
+			uint32 blockY = y;
+			uint8* block = m_pRAM + indexor.GetColumnAddress(x, blockY);
+
+			alignas(16) uint8 blockBuffer[CGsPixelFormats::BLOCKSIZE];
+			Swizzler::WriteBlock(blockBuffer, src + (blockX * Swizzler::BITSPERPIXEL / 8), width);
+			if(memcmp(block, blockBuffer, CGsPixelFormats::BLOCKSIZE) != 0)
+			{
+				memcpy(block, blockBuffer, CGsPixelFormats::BLOCKSIZE);
+				dirty = true;
+			}
+		}
+
+		src += blockRowPixelCount * Swizzler::BITSPERPIXEL / 8;
+		processed += blockRowPixelCount;
+		m_trxCtx.nRRY += Storage::BLOCKHEIGHT;
+	}
+
+	return processed;
+}
+
+//Same as TransferWriteBlockRows, but for formats that only update some bits
+//of PSMCT32 pixels (PSMCT24, PSMT8H, PSMT4HL and PSMT4HH)
+template <uint32 srcBitsPerPixel, uint32 shift, uint32 mask>
+uint32 CGSHandler::TransferWriteBlockRowsMasked(const uint8* src, uint32 pixelCount)
+{
+	typedef CGsPixelFormats::STORAGEPSMCT32 Storage;
+	typedef CGsBlockSwizzler<Storage> Swizzler;
+
+	auto trxPos = make_convertible<TRXPOS>(m_nReg[GS_REG_TRXPOS]);
+	auto trxBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
+
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(m_pRAM, trxBuf.GetDstPtr(), trxBuf.nDstWidth);
+
+	uint32 processed = 0;
+	while(1)
+	{
+		uint32 blockRowPixelCount = GetTransferBlockRowPixelCount<Storage>(trxPos.nDSAX, trxPos.nDSAY);
+		if((blockRowPixelCount == 0) || ((pixelCount - processed) < blockRowPixelCount)) break;
+
+		uint32 width = blockRowPixelCount / Storage::BLOCKHEIGHT;
+		uint32 y = (m_trxCtx.nRRY + trxPos.nDSAY) % 2048;
+		for(uint32 blockX = 0; blockX < width; blockX += Storage::BLOCKWIDTH)
+		{
+			uint32 x = trxPos.nDSAX + blockX;
+			uint32 blockY = y;
+			auto block = reinterpret_cast<uint32*>(m_pRAM + indexor.GetColumnAddress(x, blockY));
+
+			uint32 blockPixels[Storage::BLOCKHEIGHT][Storage::BLOCKWIDTH];
+			for(uint32 pixelY = 0; pixelY < Storage::BLOCKHEIGHT; pixelY++)
+			{
+				for(uint32 pixelX = 0; pixelX < Storage::BLOCKWIDTH; pixelX++)
+				{
+					uint32 pixelIndex = (pixelY * width) + blockX + pixelX;
+					uint32 pixel = 0;
+					if constexpr(srcBitsPerPixel == 24)
+					{
+						auto srcPixel = src + (pixelIndex * 3);
+						pixel = srcPixel[0] | (srcPixel[1] << 8) | (srcPixel[2] << 16);
+					}
+					else if constexpr(srcBitsPerPixel == 8)
+					{
+						pixel = src[pixelIndex];
+					}
+					else
+					{
+						static_assert(srcBitsPerPixel == 4, "Unsupported source pixel size.");
+						pixel = (src[pixelIndex / 2] >> ((pixelIndex & 1) * 4)) & 0x0F;
+					}
+					blockPixels[pixelY][pixelX] = pixel << shift;
+				}
+			}
+
+			alignas(16) uint32 blockBuffer[Storage::BLOCKWIDTH * Storage::BLOCKHEIGHT];
+			Swizzler::WriteBlock(reinterpret_cast<uint8*>(blockBuffer), reinterpret_cast<const uint8*>(blockPixels), Storage::BLOCKWIDTH);
+			for(uint32 i = 0; i < (Storage::BLOCKWIDTH * Storage::BLOCKHEIGHT); i++)
+			{
+				block[i] = (block[i] & ~mask) | blockBuffer[i];
+			}
+		}
+
+		src += blockRowPixelCount * srcBitsPerPixel / 8;
+		processed += blockRowPixelCount;
+		m_trxCtx.nRRY += Storage::BLOCKHEIGHT;
+	}
+
+	return processed;
+}
+
+//Reads as many complete rows of blocks as possible, returns the amount of pixels produced
+template <typename Storage>
+uint32 CGSHandler::TransferReadBlockRows(uint8* dst, uint32 pixelCount)
+{
+	typedef CGsBlockSwizzler<Storage> Swizzler;
+
+	auto trxPos = make_convertible<TRXPOS>(m_nReg[GS_REG_TRXPOS]);
+	auto trxBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
+
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(GetRam(), trxBuf.GetSrcPtr(), trxBuf.nSrcWidth);
+
+	uint32 processed = 0;
+	while(1)
+	{
+		uint32 blockRowPixelCount = GetTransferBlockRowPixelCount<Storage>(trxPos.nSSAX, trxPos.nSSAY);
+		if((blockRowPixelCount == 0) || ((pixelCount - processed) < blockRowPixelCount)) break;
+
+		uint32 width = blockRowPixelCount / Storage::BLOCKHEIGHT;
+		uint32 y = (m_trxCtx.nRRY + trxPos.nSSAY) % 2048;
+		for(uint32 blockX = 0; blockX < width; blockX += Storage::BLOCKWIDTH)
+		{
+			uint32 x = trxPos.nSSAX + blockX;
+			uint32 blockY = y;
+			const uint8* block = GetRam() + indexor.GetColumnAddress(x, blockY);
+			Swizzler::ReadBlock(dst + (blockX * Swizzler::BITSPERPIXEL / 8), width, block);
+		}
+
+		dst += blockRowPixelCount * Swizzler::BITSPERPIXEL / 8;
+		processed += blockRowPixelCount;
+		m_trxCtx.nRRY += Storage::BLOCKHEIGHT;
+	}
+
+	return processed;
+}
+
 void CGSHandler::TransferReadHandlerInvalid(void*, uint32)
 {
 	assert(0);
@@ -1180,6 +1404,12 @@ void CGSHandler::TransferReadHandlerGeneric(void* buffer, uint32 length)
 	CGsPixelFormats::CPixelIndexor<Storage> indexor(GetRam(), trxBuf.GetSrcPtr(), trxBuf.nSrcWidth);
 	for(uint32 i = 0; i < typedLength; i++)
 	{
+		if(m_trxCtx.nRRX == 0)
+		{
+			i += TransferReadBlockRows<Storage>(reinterpret_cast<uint8*>(typedBuffer + i), typedLength - i);
+			if(i == typedLength) break;
+		}
+
 		uint32 x = (m_trxCtx.nRRX + trxPos.nSSAX) % 2048;
 		uint32 y = (m_trxCtx.nRRY + trxPos.nSSAY) % 2048;
 		auto pixel = indexor.GetPixel(x, y);
@@ -1545,18 +1775,19 @@ bool CGSHandler::ReadCLUT4_16(const TEX0& tex0)
 	return changed;
 }
 
-template <typename Indexor>
+template <typename Storage>
 bool CGSHandler::ReadCLUT8_16(const TEX0& tex0)
 {
 	bool changed = false;
 
-	Indexor indexor(m_pRAM, tex0.GetCLUTPtr(), 1);
+	uint16 colors[16 * 16];
+	CGsBlockSwizzler<Storage>::ReadArea(reinterpret_cast<uint8*>(colors), m_pRAM, tex0.GetCLUTPtr(), 1, 16, 16);
 
 	for(unsigned int j = 0; j < 16; j++)
 	{
 		for(unsigned int i = 0; i < 16; i++)
 		{
-			uint16 color = indexor.GetPixel(i, j);
+			uint16 color = colors[i + (j * 16)];
 
 			uint8 index = i + (j * 16);
 			index = (index & ~0x18) | ((index & 0x08) << 1) | ((index & 0x10) >> 1);
@@ -1664,13 +1895,14 @@ void CGSHandler::ReadCLUT8(const TEX0& tex0)
 	{
 		if(tex0.nCPSM == PSMCT32 || tex0.nCPSM == PSMCT24)
 		{
-			CGsPixelFormats::CPixelIndexorPSMCT32 Indexor(m_pRAM, tex0.GetCLUTPtr(), 1);
+			uint32 colors[16 * 16];
+			CGsBlockSwizzler<CGsPixelFormats::STORAGEPSMCT32>::ReadArea(reinterpret_cast<uint8*>(colors), m_pRAM, tex0.GetCLUTPtr(), 1, 16, 16);
 
 			for(unsigned int j = 0; j < 16; j++)
 			{
 				for(unsigned int i = 0; i < 16; i++)
 				{
-					uint32 color = Indexor.GetPixel(i, j);
+					uint32 color = colors[i + (j * 16)];
 					uint16 colorLo = static_cast<uint16>(color & 0xFFFF);
 					uint16 colorHi = static_cast<uint16>(color >> 16);
 
@@ -1691,11 +1923,11 @@ void CGSHandler::ReadCLUT8(const TEX0& tex0)
 		}
 		else if(tex0.nCPSM == PSMCT16)
 		{
-			changed = ReadCLUT8_16<CGsPixelFormats::CPixelIndexorPSMCT16>(tex0);
+			changed = ReadCLUT8_16<CGsPixelFormats::STORAGEPSMCT16>(tex0);
 		}
 		else if(tex0.nCPSM == PSMCT16S)
 		{
-			changed = ReadCLUT8_16<CGsPixelFormats::CPixelIndexorPSMCT16S>(tex0);
+			changed = ReadCLUT8_16<CGsPixelFormats::STORAGEPSMCT16S>(tex0);
 		}
 		else
 		{
@@ -2162,9 +2394,13 @@ void CGSHandler::WriteToDelayedRegister(uint32 address, uint32 value, DELAYED_RE
 
 void CGSHandler::ThreadProc()
 {
+	CProfiler::GetInstance().SetTraceThreadName("GS");
 	while(!m_threadDone)
 	{
 		m_mailBox.WaitForCall();
+#ifdef PROFILE
+		CProfilerTraceZone profilerZone(m_gsProfilerZone);
+#endif
 		while(m_mailBox.IsPending())
 		{
 			m_mailBox.ReceiveCall();
@@ -11,7 +11,9 @@
 #include "Types.h"
 #include "Convertible.h"
 #include "../MailBox.h"
+#include "../Profiler.h"
 #include "../Integer64.h"
+#include "GsStagingArena.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 
@@ -840,6 +842,9 @@ public:
 	bool GetDrawEnabled() const;
 	void SetDrawEnabled(bool);
 
+	//Disables rasterization for the upcoming frame, transfers and other state changes are still processed
+	void SetFrameSkipped(bool);
+
 	void WritePrivRegister(uint32, uint32);
 	uint32 ReadPrivRegister(uint32);
 
@@ -853,6 +858,9 @@ public:
 	void FeedImageData(const void*, uint32);
 	void ReadImageData(void*, uint32);
 
+	CGsStagingArena::STATS GetImageStagingStats() const;
+	void ResetImageStagingStats();
+
 	inline void WriteRegister(const RegisterWrite& write)
 	{
 		assert(m_writeBufferSize < REGISTERWRITEBUFFER_SIZE);
@@ -860,6 +868,17 @@ public:
 		m_currentWriteBuffer[m_writeBufferSize++] = write;
 	}
 
+	//Reserves space for a contiguous run of register writes in the write buffer.
+	//Returns nullptr if the write buffer doesn't have enough space left.
+	inline RegisterWrite* ReserveRegisterWrites(uint32 count)
+	{
+		assert((m_writeBufferSize + count) <= REGISTERWRITEBUFFER_SIZE);
+		if((m_writeBufferSize + count) > REGISTERWRITEBUFFER_SIZE) return nullptr;
+		auto writes = m_currentWriteBuffer + m_writeBufferSize;
+		m_writeBufferSize += count;
+		return writes;
+	}
+
 	void ProcessWriteBuffer(const CGsPacketMetadata*);
 	void SubmitWriteBuffer();
 	void FlushWriteBuffer();
@@ -1065,6 +1084,15 @@ protected:
 	template <uint32, uint32>
 	bool TransferWriteHandlerPSMT4H(const void*, uint32);
 
+	template <typename Storage>
+	uint32 GetTransferBlockRowPixelCount(uint32, uint32) const;
+	template <typename Storage>
+	uint32 TransferWriteBlockRows(const uint8*, uint32, bool&);
+	template <uint32, uint32, uint32>
+	uint32 TransferWriteBlockRowsMasked(const uint8*, uint32);
+	template <typename Storage>
+	uint32 TransferReadBlockRows(uint8*, uint32);
+
 	void TransferReadHandlerInvalid(void*, uint32);
 	template <typename Storage>
 	void TransferReadHandlerGeneric(void*, uint32);
@@ -1076,7 +1104,7 @@ protected:
 	bool ProcessCLD(const TEX0&);
 	template <typename Indexor>
 	bool ReadCLUT4_16(const TEX0&);
-	template <typename Indexor>
+	template <typename Storage>
 	bool ReadCLUT8_16(const TEX0&);
 	void ReadCLUT4(const TEX0&);
 	void ReadCLUT8(const TEX0&);
@@ -1121,6 +1149,7 @@ protected:
 
 	CRT_MODE m_crtMode;
 	std::thread m_thread;
+	CProfiler::ZoneHandle m_gsProfilerZone = 0;
 	std::recursive_mutex m_registerMutex;
 #ifdef _DEBUG
 	std::atomic<int> m_transferCount;
@@ -1131,10 +1160,14 @@ protected:
 	FrameDumpCallback m_frameDumpCallback;
 	bool m_regsDirty = false;
 	bool m_drawEnabled = true;
+	bool m_frameSkipped = false;
+	bool m_hasPresentedDisplayInfo = false;
+	DISPLAY_INFO m_presentedDisplayInfo;
 	CINTC* m_intc = nullptr;
 	bool m_gsThreaded = true;
 	bool m_flipped = false;
 
 private:
 	CMailBox m_mailBox;
+	CGsStagingArena m_imageStagingArena;
 };
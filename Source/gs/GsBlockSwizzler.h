@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include "Types.h"
+#include "SimdDefs.h"
+#include "GsPixelFormats.h"
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+//Converts whole blocks of pixels between a linear layout and the layout used in GS memory.
+//This is a lot faster than going through CPixelIndexor for every pixel when large images
+//are transferred. 'pitch' is the distance between two rows in the linear buffer, in pixels.
+//For PSMT4, pixels are packed (2 per byte) in the linear buffer.
+template <typename Storage>
+class CGsBlockSwizzler
+{
+public:
+	enum BITSPERPIXEL
+	{
+		BITSPERPIXEL = (CGsPixelFormats::BLOCKSIZE * 8) / (Storage::BLOCKWIDTH * Storage::BLOCKHEIGHT)
+	};
+
+	static void WriteBlock(uint8* block, const uint8* src, uint32 srcPitch)
+	{
+		const auto& blockOffsets = GetBlockOffsets().offsets;
+
+		typedef typename Storage::Unit Unit;
+		auto blockPixels = reinterpret_cast<Unit*>(block);
+		for(uint32 y = 0; y < Storage::BLOCKHEIGHT; y++)
+		{
+			auto srcPixels = reinterpret_cast<const Unit*>(src);
+			for(uint32 x = 0; x < Storage::BLOCKWIDTH; x++)
+			{
+				blockPixels[blockOffsets[y][x]] = srcPixels[x];
+			}
+			src += srcPitch * sizeof(Unit);
+		}
+	}
+
+	static void ReadBlock(uint8* dst, uint32 dstPitch, const uint8* block)
+	{
+		const auto& blockOffsets = GetBlockOffsets().offsets;
+
+		typedef typename Storage::Unit Unit;
+		auto blockPixels = reinterpret_cast<const Unit*>(block);
+		for(uint32 y = 0; y < Storage::BLOCKHEIGHT; y++)
+		{
+			auto dstPixels = reinterpret_cast<Unit*>(dst);
+			for(uint32 x = 0; x < Storage::BLOCKWIDTH; x++)
+			{
+				dstPixels[x] = blockPixels[blockOffsets[y][x]];
+			}
+			dst += dstPitch * sizeof(Unit);
+		}
+	}
+
+	//Reads an area starting at the top-left corner of a buffer, width and height must be multiples of block size
+	static void ReadArea(uint8* dst, uint8* ram, uint32 bufPtr, uint32 bufWidth, uint32 width, uint32 height)
+	{
+		assert((width % Storage::BLOCKWIDTH) == 0);
+		assert((height % Storage::BLOCKHEIGHT) == 0);
+
+		CGsPixelFormats::CPixelIndexor<Storage> indexor(ram, bufPtr, bufWidth);
+		for(uint32 blockY = 0; blockY < height; blockY += Storage::BLOCKHEIGHT)
+		{
+			for(uint32 blockX = 0; blockX < width; blockX += Storage::BLOCKWIDTH)
+			{
+				uint32 x = blockX;
+				uint32 y = blockY;
+				uint8* block = ram + indexor.GetColumnAddress(x, y);
+				ReadBlock(dst + (((blockY * width) + blockX) * BITSPERPIXEL / 8), width, block);
+			}
+		}
+	}
+
+private:
+	struct BLOCKOFFSETTABLE
+	{
+		uint16 offsets[Storage::BLOCKHEIGHT][Storage::BLOCKWIDTH];
+	};
+
+	//Built on first use, initialization of the local static is thread safe
+	static const BLOCKOFFSETTABLE& GetBlockOffsets()
+	{
+		static const auto blockOffsets = BuildBlockOffsetTable();
+		return blockOffsets;
+	}
+
+	static BLOCKOFFSETTABLE BuildBlockOffsetTable()
+	{
+		BLOCKOFFSETTABLE blockOffsets = {};
+
+		//Pixel (0, 0) of a page is always at the beginning of its block, use this to get offsets relative to the block.
+		//Offsets are in units, except for PSMT4 where they are in nibbles.
+		typedef uint32 PageOffsetRow[Storage::PAGEWIDTH];
+		auto pageOffsets = reinterpret_cast<const PageOffsetRow*>(CGsPixelFormats::CPixelIndexor<Storage>::GetPageOffsets());
+		uint32 blockBase = pageOffsets[0][0];
+
+		for(uint32 y = 0; y < Storage::BLOCKHEIGHT; y++)
+		{
+			for(uint32 x = 0; x < Storage::BLOCKWIDTH; x++)
+			{
+				uint32 offset = (pageOffsets[y][x] - blockBase) / sizeof(typename Storage::Unit);
+				assert(offset < (Storage::BLOCKWIDTH * Storage::BLOCKHEIGHT));
+				blockOffsets.offsets[y][x] = static_cast<uint16>(offset);
+			}
+		}
+
+		return blockOffsets;
+	}
+};
+
+//////////////////////////////////////////////
+//PSMT4 (pixels are packed in source/destination)
+
+template <>
+inline void CGsBlockSwizzler<CGsPixelFormats::STORAGEPSMT4>::WriteBlock(uint8* block, const uint8* src, uint32 srcPitch)
+{
+	typedef CGsPixelFormats::STORAGEPSMT4 Storage;
+
+	const auto& blockOffsets = GetBlockOffsets().offsets;
+
+	memset(block, 0, CGsPixelFormats::BLOCKSIZE);
+	for(uint32 y = 0; y < Storage::BLOCKHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::BLOCKWIDTH; x += 2)
+		{
+			uint8 srcPixels = src[x / 2];
+			uint32 nibble0 = blockOffsets[y][x + 0];
+			uint32 nibble1 = blockOffsets[y][x + 1];
+			block[nibble0 / 2] |= (srcPixels & 0x0F) << ((nibble0 & 1) * 4);
+			block[nibble1 / 2] |= (srcPixels >> 4) << ((nibble1 & 1) * 4);
+		}
+		src += srcPitch / 2;
+	}
+}
+
+template <>
+inline void CGsBlockSwizzler<CGsPixelFormats::STORAGEPSMT4>::ReadBlock(uint8* dst, uint32 dstPitch, const uint8* block)
+{
+	typedef CGsPixelFormats::STORAGEPSMT4 Storage;
+
+	const auto& blockOffsets = GetBlockOffsets().offsets;
+
+	for(uint32 y = 0; y < Storage::BLOCKHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::BLOCKWIDTH; x += 2)
+		{
+			uint32 nibble0 = blockOffsets[y][x + 0];
+			uint32 nibble1 = blockOffsets[y][x + 1];
+			uint8 pixel0 = (block[nibble0 / 2] >> ((nibble0 & 1) * 4)) & 0x0F;
+			uint8 pixel1 = (block[nibble1 / 2] >> ((nibble1 & 1) * 4)) & 0x0F;
+			dst[x / 2] = pixel0 | (pixel1 << 4);
+		}
+		dst += dstPitch / 2;
+	}
+}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE) || defined(FRAMEWORK_SIMD_USE_NEON)
+
+//////////////////////////////////////////////
+//32-bits and 16-bits formats share the same column organization (2 rows per 64 bytes column)
+//and can be processed a whole column at a time
+
+class CGsBlockSwizzlerSimd
+{
+public:
+	//A column is 8 pixels wide, first row's pixel pairs are interleaved with second row's
+	static void WriteBlock32(uint8* block, const uint8* src, uint32 srcPitch)
+	{
+		uint32 srcRowSize = srcPitch * 4;
+		for(uint32 column = 0; column < 4; column++)
+		{
+			const uint8* row0 = src;
+			const uint8* row1 = src + srcRowSize;
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+			__m128i row0a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 0x00));
+			__m128i row0b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 0x10));
+			__m128i row1a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 0x00));
+			__m128i row1b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 0x10));
+			auto dst = reinterpret_cast<__m128i*>(block);
+			_mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(row0a, row1a));
+			_mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(row0a, row1a));
+			_mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(row0b, row1b));
+			_mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(row0b, row1b));
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+			uint32x4_t row0a = vld1q_u32(reinterpret_cast<const uint32*>(row0 + 0x00));
+			uint32x4_t row0b = vld1q_u32(reinterpret_cast<const uint32*>(row0 + 0x10));
+			uint32x4_t row1a = vld1q_u32(reinterpret_cast<const uint32*>(row1 + 0x00));
+			uint32x4_t row1b = vld1q_u32(reinterpret_cast<const uint32*>(row1 + 0x10));
+			auto dst = reinterpret_cast<uint32*>(block);
+			vst1q_u32(dst + 0x0, vcombine_u32(vget_low_u32(row0a), vget_low_u32(row1a)));
+			vst1q_u32(dst + 0x4, vcombine_u32(vget_high_u32(row0a), vget_high_u32(row1a)));
+			vst1q_u32(dst + 0x8, vcombine_u32(vget_low_u32(row0b), vget_low_u32(row1b)));
+			vst1q_u32(dst + 0xC, vcombine_u32(vget_high_u32(row0b), vget_high_u32(row1b)));
+#endif
+			src += srcRowSize * 2;
+			block += CGsPixelFormats::COLUMNSIZE;
+		}
+	}
+
+	static void ReadBlock32(uint8* dst, uint32 dstPitch, const uint8* block)
+	{
+		uint32 dstRowSize = dstPitch * 4;
+		for(uint32 column = 0; column < 4; column++)
+		{
+			uint8* row0 = dst;
+			uint8* row1 = dst + dstRowSize;
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+			auto src = reinterpret_cast<const __m128i*>(block);
+			__m128i col0 = _mm_loadu_si128(src + 0);
+			__m128i col1 = _mm_loadu_si128(src + 1);
+			__m128i col2 = _mm_loadu_si128(src + 2);
+			__m128i col3 = _mm_loadu_si128(src + 3);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row0 + 0x00), _mm_unpacklo_epi64(col0, col1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row0 + 0x10), _mm_unpacklo_epi64(col2, col3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row1 + 0x00), _mm_unpackhi_epi64(col0, col1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row1 + 0x10), _mm_unpackhi_epi64(col2, col3));
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+			auto src = reinterpret_cast<const uint32*>(block);
+			uint32x4_t col0 = vld1q_u32(src + 0x0);
+			uint32x4_t col1 = vld1q_u32(src + 0x4);
+			uint32x4_t col2 = vld1q_u32(src + 0x8);
+			uint32x4_t col3 = vld1q_u32(src + 0xC);
+			vst1q_u32(reinterpret_cast<uint32*>(row0 + 0x00), vcombine_u32(vget_low_u32(col0), vget_low_u32(col1)));
+			vst1q_u32(reinterpret_cast<uint32*>(row0 + 0x10), vcombine_u32(vget_low_u32(col2), vget_low_u32(col3)));
+			vst1q_u32(reinterpret_cast<uint32*>(row1 + 0x00), vcombine_u32(vget_high_u32(col0), vget_high_u32(col1)));
+			vst1q_u32(reinterpret_cast<uint32*>(row1 + 0x10), vcombine_u32(vget_high_u32(col2), vget_high_u32(col3)));
+#endif
+			dst += dstRowSize * 2;
+			block += CGsPixelFormats::COLUMNSIZE;
+		}
+	}
+
+	//A column is 16 pixels wide, pixels 'x' and 'x + 8' of a row are stored side by side
+	//and those pairs are interleaved with the second row's pairs
+	static void WriteBlock16(uint8* block, const uint8* src, uint32 srcPitch)
+	{
+		uint32 srcRowSize = srcPitch * 2;
+		for(uint32 column = 0; column < 4; column++)
+		{
+			const uint8* row0 = src;
+			const uint8* row1 = src + srcRowSize;
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+			__m128i row0a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 0x00));
+			__m128i row0b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 0x10));
+			__m128i row1a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 0x00));
+			__m128i row1b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 0x10));
+			__m128i pairs0a = _mm_unpacklo_epi16(row0a, row0b);
+			__m128i pairs0b = _mm_unpackhi_epi16(row0a, row0b);
+			__m128i pairs1a = _mm_unpacklo_epi16(row1a, row1b);
+			__m128i pairs1b = _mm_unpackhi_epi16(row1a, row1b);
+			auto dst = reinterpret_cast<__m128i*>(block);
+			_mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(pairs0a, pairs1a));
+			_mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(pairs0a, pairs1a));
+			_mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(pairs0b, pairs1b));
+			_mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(pairs0b, pairs1b));
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+			uint16x8_t row0a = vld1q_u16(reinterpret_cast<const uint16*>(row0 + 0x00));
+			uint16x8_t row0b = vld1q_u16(reinterpret_cast<const uint16*>(row0 + 0x10));
+			uint16x8_t row1a = vld1q_u16(reinterpret_cast<const uint16*>(row1 + 0x00));
+			uint16x8_t row1b = vld1q_u16(reinterpret_cast<const uint16*>(row1 + 0x10));
+			uint16x8x2_t pairs0 = vzipq_u16(row0a, row0b);
+			uint16x8x2_t pairs1 = vzipq_u16(row1a, row1b);
+			auto dst = reinterpret_cast<uint16*>(block);
+			vst1q_u16(dst + 0x00, vcombine_u16(vget_low_u16(pairs0.val[0]), vget_low_u16(pairs1.val[0])));
+			vst1q_u16(dst + 0x08, vcombine_u16(vget_high_u16(pairs0.val[0]), vget_high_u16(pairs1.val[0])));
+			vst1q_u16(dst + 0x10, vcombine_u16(vget_low_u16(pairs0.val[1]), vget_low_u16(pairs1.val[1])));
+			vst1q_u16(dst + 0x18, vcombine_u16(vget_high_u16(pairs0.val[1]), vget_high_u16(pairs1.val[1])));
+#endif
+			src += srcRowSize * 2;
+			block += CGsPixelFormats::COLUMNSIZE;
+		}
+	}
+
+	static void ReadBlock16(uint8* dst, uint32 dstPitch, const uint8* block)
+	{
+		uint32 dstRowSize = dstPitch * 2;
+		for(uint32 column = 0; column < 4; column++)
+		{
+			uint8* row0 = dst;
+			uint8* row1 = dst + dstRowSize;
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+			auto src = reinterpret_cast<const __m128i*>(block);
+			__m128i col0 = _mm_loadu_si128(src + 0);
+			__m128i col1 = _mm_loadu_si128(src + 1);
+			__m128i col2 = _mm_loadu_si128(src + 2);
+			__m128i col3 = _mm_loadu_si128(src + 3);
+			__m128i pairs0a = _mm_unpacklo_epi64(col0, col1);
+			__m128i pairs1a = _mm_unpackhi_epi64(col0, col1);
+			__m128i pairs0b = _mm_unpacklo_epi64(col2, col3);
+			__m128i pairs1b = _mm_unpackhi_epi64(col2, col3);
+			DeinterleaveRow16(row0, pairs0a, pairs0b);
+			DeinterleaveRow16(row1, pairs1a, pairs1b);
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+			auto src = reinterpret_cast<const uint16*>(block);
+			uint16x8_t col0 = vld1q_u16(src + 0x00);
+			uint16x8_t col1 = vld1q_u16(src + 0x08);
+			uint16x8_t col2 = vld1q_u16(src + 0x10);
+			uint16x8_t col3 = vld1q_u16(src + 0x18);
+			uint16x8x2_t pixels0 = vuzpq_u16(vcombine_u16(vget_low_u16(col0), vget_low_u16(col1)), vcombine_u16(vget_low_u16(col2), vget_low_u16(col3)));
+			uint16x8x2_t pixels1 = vuzpq_u16(vcombine_u16(vget_high_u16(col0), vget_high_u16(col1)), vcombine_u16(vget_high_u16(col2), vget_high_u16(col3)));
+			vst1q_u16(reinterpret_cast<uint16*>(row0 + 0x00), pixels0.val[0]);
+			vst1q_u16(reinterpret_cast<uint16*>(row0 + 0x10), pixels0.val[1]);
+			vst1q_u16(reinterpret_cast<uint16*>(row1 + 0x00), pixels1.val[0]);
+			vst1q_u16(reinterpret_cast<uint16*>(row1 + 0x10), pixels1.val[1]);
+#endif
+			dst += dstRowSize * 2;
+			block += CGsPixelFormats::COLUMNSIZE;
+		}
+	}
+
+private:
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+	//Splits (a0, b0, a1, b1, ...), (a4, b4, a5, b5, ...) into (a0, a1, ..., a7), (b0, b1, ..., b7)
+	static void DeinterleaveRow16(uint8* row, __m128i pairsA, __m128i pairsB)
+	{
+		__m128i temp0 = _mm_unpacklo_epi16(pairsA, pairsB);
+		__m128i temp1 = _mm_unpackhi_epi16(pairsA, pairsB);
+		__m128i temp2 = _mm_unpacklo_epi16(temp0, temp1);
+		__m128i temp3 = _mm_unpackhi_epi16(temp0, temp1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + 0x00), _mm_unpacklo_epi16(temp2, temp3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + 0x10), _mm_unpackhi_epi16(temp2, temp3));
+	}
+#endif
+};
+
+#define GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(storage, bits)                                                                     \
+	template <>                                                                                                                 \
+	inline void CGsBlockSwizzler<CGsPixelFormats::storage>::WriteBlock(uint8* block, const uint8* src, uint32 srcPitch)        \
+	{                                                                                                                           \
+		CGsBlockSwizzlerSimd::WriteBlock##bits(block, src, srcPitch);                                                           \
+	}                                                                                                                           \
+	template <>                                                                                                                 \
+	inline void CGsBlockSwizzler<CGsPixelFormats::storage>::ReadBlock(uint8* dst, uint32 dstPitch, const uint8* block)         \
+	{                                                                                                                           \
+		CGsBlockSwizzlerSimd::ReadBlock##bits(dst, dstPitch, block);                                                            \
+	}
+
+GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(STORAGEPSMCT32, 32)
+GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(STORAGEPSMZ32, 32)
+GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(STORAGEPSMCT16, 16)
+GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(STORAGEPSMCT16S, 16)
+GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(STORAGEPSMZ16, 16)
+GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION(STORAGEPSMZ16S, 16)
+
+#undef GS_BLOCKSWIZZLER_SIMD_SPECIALIZATION
+
+#endif
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+#include "GsStagingArena.h"
+
+CGsStagingArena::~CGsStagingArena()
+{
+	if(m_currentChunk)
+	{
+		ReleaseChunk(m_currentChunk);
+	}
+	//Every allocation is expected to have been released at this point. Chunks that are still
+	//referenced belong to calls that were dropped and will never release them, free them as well.
+	for(auto chunk : m_chunks)
+	{
+		assert(chunk->refCount == 0);
+		delete chunk;
+	}
+}
+
+CGsStagingArena::ALLOCATION* CGsStagingArena::Allocate(uint32 size)
+{
+	uint32 headerSize = GetAllocationHeaderSize();
+	uint32 dataSize = (size + ALLOCATION_PADDING + ALLOCATION_ALIGNMENT - 1) & ~(ALLOCATION_ALIGNMENT - 1);
+	uint32 allocationSize = headerSize + dataSize;
+
+	if(!m_currentChunk || ((m_currentChunk->used + allocationSize) > m_currentChunk->capacity))
+	{
+		if(m_currentChunk)
+		{
+			ReleaseChunk(m_currentChunk);
+		}
+		m_currentChunk = AcquireChunk(allocationSize);
+	}
+
+	auto chunk = m_currentChunk;
+	auto allocationMemory = chunk->memory.get() + chunk->used;
+	chunk->used += allocationSize;
+	chunk->refCount++;
+
+	auto allocation = new(allocationMemory) ALLOCATION();
+	allocation->chunk = chunk;
+	allocation->size = size;
+	memset(allocationMemory + headerSize + size, 0, ALLOCATION_PADDING);
+
+	m_stats.allocationCount++;
+	m_stats.byteCount += size;
+
+	return allocation;
+}
+
+void CGsStagingArena::Release(ALLOCATION* allocation)
+{
+	auto chunk = allocation->chunk;
+	allocation->~ALLOCATION();
+	ReleaseChunk(chunk);
+}
+
+uint8* CGsStagingArena::GetData(ALLOCATION* allocation)
+{
+	return reinterpret_cast<uint8*>(allocation) + GetAllocationHeaderSize();
+}
+
+CGsStagingArena::STATS CGsStagingArena::GetStats() const
+{
+	return m_stats;
+}
+
+void CGsStagingArena::ResetStats()
+{
+	m_stats = STATS();
+}
+
+uint32 CGsStagingArena::GetAllocationHeaderSize()
+{
+	return (sizeof(ALLOCATION) + ALLOCATION_ALIGNMENT - 1) & ~(ALLOCATION_ALIGNMENT - 1);
+}
+
+CGsStagingArena::CHUNK* CGsStagingArena::AcquireChunk(uint32 minSize)
+{
+	CHUNK* chunk = nullptr;
+	if(minSize <= CHUNK_SIZE)
+	{
+		std::lock_guard<std::mutex> chunksLock(m_chunksMutex);
+		if(!m_freeChunks.empty())
+		{
+			chunk = m_freeChunks.back();
+			m_freeChunks.pop_back();
+			m_stats.chunkReuseCount++;
+		}
+	}
+	if(!chunk)
+	{
+		//Allocations bigger than the chunk size get a chunk of their own that won't be recycled
+		chunk = new CHUNK();
+		chunk->capacity = std::max<uint32>(minSize, CHUNK_SIZE);
+		chunk->memory = std::make_unique<uint8[]>(chunk->capacity);
+		m_stats.chunkAllocationCount++;
+		std::lock_guard<std::mutex> chunksLock(m_chunksMutex);
+		m_chunks.push_back(chunk);
+	}
+	assert(chunk->refCount == 0);
+	chunk->used = 0;
+	chunk->refCount = 1;
+	return chunk;
+}
+
+void CGsStagingArena::ReleaseChunk(CHUNK* chunk)
+{
+	assert(chunk->refCount != 0);
+	if(--chunk->refCount != 0) return;
+	std::lock_guard<std::mutex> chunksLock(m_chunksMutex);
+	if((chunk->capacity == CHUNK_SIZE) && (m_freeChunks.size() < MAX_FREE_CHUNKS))
+	{
+		m_freeChunks.push_back(chunk);
+		return;
+	}
+	auto chunkIterator = std::find(std::begin(m_chunks), std::end(m_chunks), chunk);
+	assert(chunkIterator != std::end(m_chunks));
+	m_chunks.erase(chunkIterator);
+	delete chunk;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Types.h"
+
+//Staging memory for data sent from the EE thread to the GS thread.
+//Allocations are carved out of large chunks that are recycled once every allocation made in
+//them has been released. Allocate must always be called from the same (producer) thread,
+//Release can be called from any thread.
+class CGsStagingArena
+{
+private:
+	struct CHUNK;
+
+public:
+	enum
+	{
+		CHUNK_SIZE = 0x100000,
+		MAX_FREE_CHUNKS = 8,
+		//Allocations are followed by that many zeroed bytes to allow readers to go
+		//beyond the actual length of the buffer (ie.: PSMCT24 transfer handlers)
+		ALLOCATION_PADDING = 0x10,
+		ALLOCATION_ALIGNMENT = 0x10,
+	};
+
+	struct STATS
+	{
+		uint32 allocationCount = 0;
+		uint32 chunkAllocationCount = 0;
+		uint32 chunkReuseCount = 0;
+		uint64 byteCount = 0;
+	};
+
+	struct ALLOCATION
+	{
+		CHUNK* chunk = nullptr;
+		uint32 size = 0;
+	};
+
+	CGsStagingArena() = default;
+	CGsStagingArena(const CGsStagingArena&) = delete;
+	virtual ~CGsStagingArena();
+
+	CGsStagingArena& operator=(const CGsStagingArena&) = delete;
+
+	ALLOCATION* Allocate(uint32);
+	void Release(ALLOCATION*);
+
+	static uint8* GetData(ALLOCATION*);
+
+	//Only valid on the producer thread
+	STATS GetStats() const;
+	void ResetStats();
+
+private:
+	struct CHUNK
+	{
+		std::unique_ptr<uint8[]> memory;
+		uint32 capacity = 0;
+		uint32 used = 0;
+		//The arena holds a reference on the chunk it's currently allocating from
+		std::atomic<uint32> refCount{0};
+	};
+
+	static uint32 GetAllocationHeaderSize();
+
+	CHUNK* AcquireChunk(uint32);
+	void ReleaseChunk(CHUNK*);
+
+	CHUNK* m_currentChunk = nullptr;
+
+	//Guards both lists, m_chunks holds every chunk owned by the arena (in use or free)
+	std::mutex m_chunksMutex;
+	std::vector<CHUNK*> m_chunks;
+	std::vector<CHUNK*> m_freeChunks;
+
+	STATS m_stats;
+};
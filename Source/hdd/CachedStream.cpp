@@ -0,0 +1,143 @@
+#include "CachedStream.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace Hdd;
+
+CCachedStream::CCachedStream(std::unique_ptr<Framework::CStream> baseStream)
+    : m_baseStream(std::move(baseStream))
+    , m_chunks(CHUNK_COUNT)
+{
+	m_baseStream->Seek(0, Framework::STREAM_SEEK_END);
+	m_baseStreamSize = m_baseStream->Tell();
+	m_baseStream->Seek(0, Framework::STREAM_SEEK_SET);
+	m_chunkSlots.reserve(CHUNK_COUNT);
+}
+
+void CCachedStream::Seek(int64 position, Framework::STREAM_SEEK_DIRECTION whence)
+{
+	switch(whence)
+	{
+	case Framework::STREAM_SEEK_SET:
+		m_position = position;
+		break;
+	case Framework::STREAM_SEEK_CUR:
+		m_position += position;
+		break;
+	case Framework::STREAM_SEEK_END:
+		m_position = m_baseStreamSize + position;
+		break;
+	}
+	m_isEof = false;
+}
+
+uint64 CCachedStream::Tell()
+{
+	return m_position;
+}
+
+uint64 CCachedStream::Read(void* buffer, uint64 length)
+{
+	auto outBuffer = reinterpret_cast<uint8*>(buffer);
+	uint64 readAmount = 0;
+	while(readAmount != length)
+	{
+		if(m_position >= m_baseStreamSize)
+		{
+			m_isEof = true;
+			break;
+		}
+		uint64 chunkIndex = m_position / CHUNK_SIZE;
+		uint64 chunkOffset = m_position % CHUNK_SIZE;
+		const auto& chunk = GetChunk(chunkIndex);
+		if(chunkOffset >= chunk.size)
+		{
+			m_isEof = true;
+			break;
+		}
+		uint64 copySize = std::min<uint64>(length - readAmount, chunk.size - chunkOffset);
+		memcpy(outBuffer + readAmount, chunk.data.data() + chunkOffset, copySize);
+		readAmount += copySize;
+		m_position += copySize;
+	}
+	return readAmount;
+}
+
+uint64 CCachedStream::Write(const void*, uint64)
+{
+	assert(false);
+	return 0;
+}
+
+bool CCachedStream::IsEOF()
+{
+	return m_isEof;
+}
+
+uint64 CCachedStream::GetHitCount() const
+{
+	return m_hitCount;
+}
+
+uint64 CCachedStream::GetMissCount() const
+{
+	return m_missCount;
+}
+
+const CCachedStream::CHUNK& CCachedStream::GetChunk(uint64 chunkIndex)
+{
+	bool sequential = (chunkIndex == (m_lastChunkIndex + 1));
+	m_lastChunkIndex = chunkIndex;
+
+	auto slotIterator = m_chunkSlots.find(chunkIndex);
+	if(slotIterator == std::end(m_chunkSlots))
+	{
+		m_missCount++;
+		//Read ahead a few chunks if the previous access was right before this one
+		FillChunks(chunkIndex, sequential ? PREFETCH_CHUNK_COUNT : 1);
+		slotIterator = m_chunkSlots.find(chunkIndex);
+		assert(slotIterator != std::end(m_chunkSlots));
+	}
+	else
+	{
+		m_hitCount++;
+	}
+
+	auto& chunk = m_chunks[slotIterator->second];
+	chunk.lastUse = ++m_useCounter;
+	return chunk;
+}
+
+CCachedStream::CHUNK& CCachedStream::AllocateChunk(uint64 chunkIndex)
+{
+	auto chunkIterator = std::min_element(std::begin(m_chunks), std::end(m_chunks),
+	                                      [](const CHUNK& lhs, const CHUNK& rhs) { return lhs.lastUse < rhs.lastUse; });
+	auto& chunk = *chunkIterator;
+	if(chunk.index != ~0ULL)
+	{
+		m_chunkSlots.erase(chunk.index);
+	}
+	chunk.index = chunkIndex;
+	chunk.lastUse = ++m_useCounter;
+	chunk.size = 0;
+	chunk.data.resize(CHUNK_SIZE);
+	m_chunkSlots[chunkIndex] = chunkIterator - std::begin(m_chunks);
+	return chunk;
+}
+
+void CCachedStream::FillChunks(uint64 firstChunkIndex, uint32 chunkCount)
+{
+	//Chunks are contiguous in the base stream, only seek once
+	m_baseStream->Seek(firstChunkIndex * CHUNK_SIZE, Framework::STREAM_SEEK_SET);
+	for(uint32 i = 0; i < chunkCount; i++)
+	{
+		uint64 chunkIndex = firstChunkIndex + i;
+		uint64 chunkPosition = chunkIndex * CHUNK_SIZE;
+		if(chunkPosition >= m_baseStreamSize) break;
+		if(m_chunkSlots.find(chunkIndex) != std::end(m_chunkSlots)) break;
+		auto& chunk = AllocateChunk(chunkIndex);
+		uint64 chunkSize = std::min<uint64>(CHUNK_SIZE, m_baseStreamSize - chunkPosition);
+		chunk.size = m_baseStream->Read(chunk.data.data(), chunkSize);
+	}
+}
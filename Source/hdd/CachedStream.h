@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Stream.h"
+
+namespace Hdd
+{
+	//Read-only stream that keeps recently used chunks of the underlying image
+	//in memory and reads ahead when accesses are sequential.
+	class CCachedStream : public Framework::CStream
+	{
+	public:
+		enum
+		{
+			CHUNK_SIZE = 0x10000,
+			CHUNK_COUNT = 64,
+			PREFETCH_CHUNK_COUNT = 4,
+		};
+
+		CCachedStream(std::unique_ptr<Framework::CStream>);
+		virtual ~CCachedStream() = default;
+
+		void Seek(int64, Framework::STREAM_SEEK_DIRECTION) override;
+		uint64 Tell() override;
+		uint64 Read(void*, uint64) override;
+		uint64 Write(const void*, uint64) override;
+		bool IsEOF() override;
+
+		uint64 GetHitCount() const;
+		uint64 GetMissCount() const;
+
+	private:
+		struct CHUNK
+		{
+			uint64 index = ~0ULL;
+			uint64 lastUse = 0;
+			uint64 size = 0;
+			std::vector<uint8> data;
+		};
+
+		const CHUNK& GetChunk(uint64);
+		CHUNK& AllocateChunk(uint64);
+		void FillChunks(uint64, uint32);
+
+		std::unique_ptr<Framework::CStream> m_baseStream;
+		uint64 m_baseStreamSize = 0;
+
+		std::vector<CHUNK> m_chunks;
+		std::unordered_map<uint64, size_t> m_chunkSlots;
+		uint64 m_useCounter = 0;
+		uint64 m_lastChunkIndex = ~0ULL;
+
+		uint64 m_position = 0;
+		bool m_isEof = false;
+
+		uint64 m_hitCount = 0;
+		uint64 m_missCount = 0;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include "Stream.h"
 #include "HddDefs.h"
 #include "ApaDefs.h"
@@ -21,6 +22,11 @@ namespace Hdd
 		PFS_INODE ReadInode(uint32, uint32);
 
 	private:
+		enum
+		{
+			MAX_CACHED_INODE_COUNT = 0x400,
+		};
+
 		bool TryGetInodeFromPath(const char*, PFS_INODE&);
 
 		Framework::CStream& m_stream;
@@ -28,6 +34,8 @@ namespace Hdd
 		APA_HEADER m_partitionHeader = {};
 		PFS_SUPERBLOCK m_superBlock = {};
 		uint32 m_inodeScale = 0;
+
+		std::unordered_map<uint64, PFS_INODE> m_inodeCache;
 	};
 
 	class CPfsFileReader : public Framework::CStream
@@ -43,11 +51,17 @@ namespace Hdd
 		bool IsEOF() override;
 
 	private:
+		void UpdateSegment();
+
 		CPfsReader& m_reader;
 		Framework::CStream& m_stream;
 		PFS_INODE m_inode;
 
 		uint64 m_position = 0;
+
+		//Segment containing the last read position
+		uint32 m_segmentIndex = 1;
+		uint64 m_segmentStart = 0;
 		bool m_isEof = false;
 	};
 
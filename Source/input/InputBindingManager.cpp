@@ -21,6 +21,9 @@
 
 #define DEFAULT_ANALOG_SENSITIVITY (1.0f)
 
+//Published value of buttons that are not bound to anything
+#define UNBOUND_BINDING_VALUE (~0U)
+
 // clang-format off
 uint32 CInputBindingManager::m_buttonDefaultValue[PS2::CControllerInfo::MAX_BUTTONS] =
 {
@@ -186,6 +189,25 @@ void CInputBindingManager::OnInputEventReceived(const BINDINGTARGET& target, uin
 			binding->ProcessEvent(target, bindingValue);
 		}
 	}
+	PublishBindingValues();
+	m_lastInputEventTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CInputBindingManager::PublishBindingValue(uint32 pad, uint32 button)
+{
+	const auto& binding = m_bindings[pad][button];
+	m_publishedValues[pad][button].store(binding ? binding->GetValue() : UNBOUND_BINDING_VALUE, std::memory_order_relaxed);
+}
+
+void CInputBindingManager::PublishBindingValues()
+{
+	for(unsigned int pad = 0; pad < MAX_PADS; pad++)
+	{
+		for(unsigned int button = 0; button < PS2::CControllerInfo::MAX_BUTTONS; button++)
+		{
+			PublishBindingValue(pad, button);
+		}
+	}
 }
 
 void CInputBindingManager::Reload()
@@ -356,6 +378,20 @@ void CInputBindingManager::ResetBindingValues()
 			binding->SetValue(m_buttonDefaultValue[button]);
 		}
 	}
+	PublishBindingValues();
+}
+
+bool CInputBindingManager::GetPublishedBindingValue(uint32 pad, PS2::CControllerInfo::BUTTON button, uint32& value) const
+{
+	assert(pad < MAX_PADS);
+	assert(button < PS2::CControllerInfo::MAX_BUTTONS);
+	value = m_publishedValues[pad][button].load(std::memory_order_relaxed);
+	return value != UNBOUND_BINDING_VALUE;
+}
+
+uint64 CInputBindingManager::GetLastInputEventTime() const
+{
+	return m_lastInputEventTime;
 }
 
 void CInputBindingManager::SetSimpleBinding(uint32 pad, PS2::CControllerInfo::BUTTON button, const BINDINGTARGET& binding)
@@ -365,6 +401,7 @@ void CInputBindingManager::SetSimpleBinding(uint32 pad, PS2::CControllerInfo::BU
 		throw std::exception();
 	}
 	m_bindings[pad][button] = std::make_shared<CSimpleBinding>(binding);
+	PublishBindingValue(pad, button);
 }
 
 void CInputBindingManager::SetPovHatBinding(uint32 pad, PS2::CControllerInfo::BUTTON button, const BINDINGTARGET& binding, uint32 refValue)
@@ -374,6 +411,7 @@ void CInputBindingManager::SetPovHatBinding(uint32 pad, PS2::CControllerInfo::BU
 		throw std::exception();
 	}
 	m_bindings[pad][button] = std::make_shared<CPovHatBinding>(binding, refValue);
+	PublishBindingValue(pad, button);
 }
 
 void CInputBindingManager::SetSimulatedAxisBinding(uint32 pad, PS2::CControllerInfo::BUTTON button, const BINDINGTARGET& binding1, const BINDINGTARGET& binding2)
@@ -383,6 +421,7 @@ void CInputBindingManager::SetSimulatedAxisBinding(uint32 pad, PS2::CControllerI
 		throw std::exception();
 	}
 	m_bindings[pad][button] = std::make_shared<CSimulatedAxisBinding>(binding1, binding2);
+	PublishBindingValue(pad, button);
 }
 
 void CInputBindingManager::ResetBinding(uint32 pad, PS2::CControllerInfo::BUTTON button)
@@ -392,6 +431,7 @@ void CInputBindingManager::ResetBinding(uint32 pad, PS2::CControllerInfo::BUTTON
 		throw std::exception();
 	}
 	m_bindings[pad][button].reset();
+	PublishBindingValue(pad, button);
 }
 
 ////////////////////////////////////////////////
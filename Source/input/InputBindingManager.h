@@ -96,6 +96,12 @@ public:
 	uint32 GetBindingValue(uint32, PS2::CControllerInfo::BUTTON) const;
 	void ResetBindingValues();
 
+	//Binding values are published after every input event, these can be read from any thread.
+	//Returns false if the button is not bound.
+	bool GetPublishedBindingValue(uint32, PS2::CControllerInfo::BUTTON, uint32&) const;
+	//Time at which the last published input event was received (steady clock, in microseconds)
+	uint64 GetLastInputEventTime() const;
+
 	const CBinding* GetBinding(uint32, PS2::CControllerInfo::BUTTON) const;
 	void SetSimpleBinding(uint32, PS2::CControllerInfo::BUTTON, const BINDINGTARGET&);
 	void SetPovHatBinding(uint32, PS2::CControllerInfo::BUTTON, const BINDINGTARGET&, uint32);
@@ -191,6 +197,8 @@ private:
 	};
 
 	void OnInputEventReceived(const BINDINGTARGET&, uint32);
+	void PublishBindingValue(uint32, uint32);
+	void PublishBindingValues();
 
 	static uint32 m_buttonDefaultValue[PS2::CControllerInfo::MAX_BUTTONS];
 	static const char* m_padPreferenceName[MAX_PADS];
@@ -208,5 +216,8 @@ private:
 	BindingPtr m_bindings[MAX_PADS][PS2::CControllerInfo::MAX_BUTTONS];
 	MotorBindingPtr m_motorBindings[MAX_PADS];
 
+	std::atomic<uint32> m_publishedValues[MAX_PADS][PS2::CControllerInfo::MAX_BUTTONS];
+	std::atomic<uint64> m_lastInputEventTime = 0;
+
 	ProviderConnectionMap m_providersConnection;
 };
@@ -1,30 +1,22 @@
 #include "PH_GenericInput.h"
 #include <array>
+#include <chrono>
 #include <utility>
 
 void CPH_GenericInput::Update(uint8* ram)
 {
 	using MotorPair = std::pair<uint8, uint8>;
 	std::array<MotorPair, CInputBindingManager::MAX_PADS> motorInfo;
+	bool pollingEnabled = IsPollingEnabled();
 	for(auto* interface : m_interfaces)
 	{
+		//Polled interfaces get their states when the game reads them, possibly on another thread
+		if(!pollingEnabled || !interface->HasPollHandler())
+		{
+			UpdateInterface(interface, ram);
+		}
 		for(unsigned int pad = 0; pad < CInputBindingManager::MAX_PADS; pad++)
 		{
-			for(unsigned int buttonIdx = 0; buttonIdx < PS2::CControllerInfo::MAX_BUTTONS; buttonIdx++)
-			{
-				auto button = static_cast<PS2::CControllerInfo::BUTTON>(buttonIdx);
-				const auto& binding = m_bindingManager.GetBinding(pad, button);
-				if(!binding) continue;
-				uint32 value = binding->GetValue();
-				if(PS2::CControllerInfo::IsAxis(button))
-				{
-					interface->SetAxisState(pad, button, value & 0xFF, ram);
-				}
-				else
-				{
-					interface->SetButtonState(pad, button, value != 0, ram);
-				}
-			}
 			// Only Sio2 currently provides vibration information
 			MotorPair motors{0, 0};
 			interface->GetVibration(pad, motors.first, motors.second);
@@ -43,6 +35,43 @@ void CPH_GenericInput::Update(uint8* ram)
 	}
 }
 
+void CPH_GenericInput::Poll(CPadInterface* interface, uint8* ram)
+{
+	UpdateInterface(interface, ram);
+}
+
+void CPH_GenericInput::UpdateInterface(CPadInterface* interface, uint8* ram)
+{
+	//Values are read from the binding manager's published values, input providers
+	//might be updating bindings on other threads while this runs.
+	for(unsigned int pad = 0; pad < CInputBindingManager::MAX_PADS; pad++)
+	{
+		for(unsigned int buttonIdx = 0; buttonIdx < PS2::CControllerInfo::MAX_BUTTONS; buttonIdx++)
+		{
+			auto button = static_cast<PS2::CControllerInfo::BUTTON>(buttonIdx);
+			uint32 value = 0;
+			if(!m_bindingManager.GetPublishedBindingValue(pad, button, value)) continue;
+			if(PS2::CControllerInfo::IsAxis(button))
+			{
+				interface->SetAxisState(pad, button, value & 0xFF, ram);
+			}
+			else
+			{
+				interface->SetButtonState(pad, button, value != 0, ram);
+			}
+		}
+	}
+
+	//Measure latency the first time a new input event reaches the game
+	uint64 inputEventTime = m_bindingManager.GetLastInputEventTime();
+	uint64 lastConsumedInputEventTime = m_lastConsumedInputEventTime;
+	if((inputEventTime > lastConsumedInputEventTime) && m_lastConsumedInputEventTime.compare_exchange_strong(lastConsumedInputEventTime, inputEventTime))
+	{
+		uint64 currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		RecordInputLatency(currentTime - inputEventTime);
+	}
+}
+
 CInputBindingManager& CPH_GenericInput::GetBindingManager()
 {
 	return m_bindingManager;
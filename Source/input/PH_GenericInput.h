@@ -10,11 +10,15 @@ public:
 	virtual ~CPH_GenericInput() = default;
 
 	void Update(uint8*) override;
+	void Poll(CPadInterface*, uint8*) override;
 
 	CInputBindingManager& GetBindingManager();
 
 	static FactoryFunction GetFactoryFunction();
 
 private:
+	void UpdateInterface(CPadInterface*, uint8*);
+
 	CInputBindingManager m_bindingManager;
+	std::atomic<uint64> m_lastConsumedInputEventTime = 0;
 };
@@ -43,6 +43,12 @@ namespace Iop
 			{
 				throw std::runtime_error("Renaming not supported.");
 			}
+			//Return true if files returned by GetFile don't share state with anything else
+			//and can be read or written from another thread.
+			virtual bool IsAsyncIoSupported() const
+			{
+				return false;
+			}
 		};
 
 		typedef std::shared_ptr<CDevice> DevicePtr;
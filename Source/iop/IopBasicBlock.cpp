@@ -0,0 +1,18 @@
+#include "IopBasicBlock.h"
+#include "offsetof_def.h"
+
+void CIopBasicBlock::SetIsIdleLoopBlock()
+{
+	m_isIdleLoopBlock = true;
+}
+
+void CIopBasicBlock::CompileEpilog(CMipsJitter* jitter, bool loopsOnItself)
+{
+	if(m_isIdleLoopBlock)
+	{
+		jitter->PushCst(MIPS_EXCEPTION_IDLE);
+		jitter->PullRel(offsetof(CMIPS, m_State.nHasException));
+	}
+
+	CBasicBlock::CompileEpilog(jitter, loopsOnItself);
+}
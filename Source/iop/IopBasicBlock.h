@@ -0,0 +1,17 @@
+#pragma once
+
+#include "BasicBlock.h"
+
+class CIopBasicBlock : public CBasicBlock
+{
+public:
+	using CBasicBlock::CBasicBlock;
+
+	void SetIsIdleLoopBlock();
+
+protected:
+	void CompileEpilog(CMipsJitter*, bool) override;
+
+private:
+	bool m_isIdleLoopBlock = false;
+};
@@ -0,0 +1,47 @@
+#include "IopExecutor.h"
+#include "IopBasicBlock.h"
+#include "../Log.h"
+#include "../MipsIdleLoopUtils.h"
+
+#define LOG_NAME ("iop_executor")
+
+CIopExecutor::CIopExecutor(CMIPS& context, uint32 maxAddress)
+    : CGenericMipsExecutor(context, maxAddress, BLOCK_CATEGORY_PS2_IOP)
+{
+}
+
+CIopExecutor::IdleLoopBlockSet CIopExecutor::GetDetectedIdleLoopBlocks() const
+{
+	std::lock_guard<std::mutex> detectedIdleLoopBlocksLock(m_detectedIdleLoopBlocksMutex);
+	return m_detectedIdleLoopBlocks;
+}
+
+void CIopExecutor::SetIdleLoopDetectionEnabled(bool idleLoopDetectionEnabled)
+{
+	m_idleLoopDetectionEnabled = idleLoopDetectionEnabled;
+}
+
+void CIopExecutor::Reset()
+{
+	{
+		std::lock_guard<std::mutex> detectedIdleLoopBlocksLock(m_detectedIdleLoopBlocksMutex);
+		m_detectedIdleLoopBlocks.clear();
+	}
+	CGenericMipsExecutor::Reset();
+}
+
+BasicBlockPtr CIopExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end)
+{
+	auto result = std::make_shared<CIopBasicBlock>(context, start, end, m_blockCategory);
+	if(m_idleLoopDetectionEnabled && MipsIdleLoopUtils::IsIdleLoopBlock(context, start, end, false))
+	{
+		result->SetIsIdleLoopBlock();
+		std::lock_guard<std::mutex> detectedIdleLoopBlocksLock(m_detectedIdleLoopBlocksMutex);
+		if(m_detectedIdleLoopBlocks.insert(start).second)
+		{
+			CLog::GetInstance().Print(LOG_NAME, "Detected idle loop block at 0x%08X.\r\n", start);
+		}
+	}
+	result->Compile();
+	return result;
+}
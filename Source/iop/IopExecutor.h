@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mutex>
+#include <set>
+#include "../GenericMipsExecutor.h"
+
+class CIopExecutor : public CGenericMipsExecutor<BlockLookupOneWay>
+{
+public:
+	using IdleLoopBlockSet = std::set<uint32>;
+
+	CIopExecutor(CMIPS&, uint32);
+	virtual ~CIopExecutor() = default;
+
+	//Can be called from any thread
+	IdleLoopBlockSet GetDetectedIdleLoopBlocks() const;
+
+	void SetIdleLoopDetectionEnabled(bool);
+
+	void Reset() override;
+
+	BasicBlockPtr BlockFactory(CMIPS&, uint32, uint32) override;
+
+private:
+	mutable std::mutex m_detectedIdleLoopBlocksMutex;
+	IdleLoopBlockSet m_detectedIdleLoopBlocks;
+	bool m_idleLoopDetectionEnabled = true;
+};
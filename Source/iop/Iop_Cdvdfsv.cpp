@@ -132,6 +132,16 @@ void CCdvdfsv::SetOpticalMedia(COpticalMedia* opticalMedia)
 	m_opticalMedia = opticalMedia;
 }
 
+void CCdvdfsv::SetTurboIoEnabled(bool turboIoEnabled)
+{
+	m_turboIoEnabled = turboIoEnabled;
+}
+
+int32 CCdvdfsv::GetCommandDelay(uint64 delay) const
+{
+	return static_cast<int32>(m_turboIoEnabled ? CCdvdman::COMMAND_TURBO_DELAY : delay);
+}
+
 void CCdvdfsv::LoadState(Framework::CZipArchiveReader& archive)
 {
 	auto registerFile = CRegisterStateFile(*archive.BeginReadFile(STATE_FILENAME));
@@ -409,7 +419,7 @@ void CCdvdfsv::Read(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 
 	assert(m_pendingCommand == COMMAND_NONE);
 	m_pendingCommand = COMMAND_READ;
-	m_pendingCommandDelay = CCdvdman::COMMAND_READ_BASE_DELAY + (count * CCdvdman::COMMAND_READ_SECTOR_DELAY);
+	m_pendingCommandDelay = GetCommandDelay(CCdvdman::COMMAND_READ_BASE_DELAY + (count * CCdvdman::COMMAND_READ_SECTOR_DELAY));
 	m_pendingReadSector = sector;
 	m_pendingReadCount = count;
 	m_pendingReadAddr = dstAddr & 0x1FFFFFFF;
@@ -432,7 +442,7 @@ void CCdvdfsv::ReadIopMem(uint32* args, uint32 argsSize, uint32* ret, uint32 ret
 
 	assert(m_pendingCommand == COMMAND_NONE);
 	m_pendingCommand = COMMAND_READIOP;
-	m_pendingCommandDelay = COMMAND_DEFAULT_DELAY;
+	m_pendingCommandDelay = GetCommandDelay(COMMAND_DEFAULT_DELAY);
 	m_pendingReadSector = sector;
 	m_pendingReadCount = count;
 	m_pendingReadAddr = dstAddr & 0x1FFFFFFF;
@@ -465,7 +475,7 @@ bool CCdvdfsv::StreamCmd(uint32* args, uint32 argsSize, uint32* ret, uint32 retS
 	case 2:
 		//Read
 		m_pendingCommand = COMMAND_STREAM_READ;
-		m_pendingCommandDelay = COMMAND_DEFAULT_DELAY;
+		m_pendingCommandDelay = GetCommandDelay(COMMAND_DEFAULT_DELAY);
 		m_pendingReadSector = 0;
 		m_pendingReadCount = count;
 		m_pendingReadAddr = dstAddr & (PS2::EE_RAM_SIZE - 1);
@@ -521,7 +531,7 @@ bool CCdvdfsv::NDiskReady(uint32* args, uint32 argsSize, uint32* ret, uint32 ret
 	{
 		//Delay command (required by Downhill Domination)
 		m_pendingCommand = COMMAND_NDISKREADY;
-		m_pendingCommandDelay = COMMAND_DEFAULT_DELAY;
+		m_pendingCommandDelay = GetCommandDelay(COMMAND_DEFAULT_DELAY);
 		ret[0x00] = 2;
 		return false;
 	}
@@ -557,7 +567,7 @@ void CCdvdfsv::ReadChain(uint32* args, uint32 argsSize, uint32* ret, uint32 retS
 
 	//DBZ: Budokai Tenkaichi hangs in its loading screen if this command's result is not delayed.
 	m_pendingCommand = COMMAND_READCHAIN;
-	m_pendingCommandDelay = COMMAND_DEFAULT_DELAY;
+	m_pendingCommandDelay = GetCommandDelay(COMMAND_DEFAULT_DELAY);
 }
 
 void CCdvdfsv::SearchFile(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, uint8* ram)
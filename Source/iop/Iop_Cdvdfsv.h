@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include "Iop_Module.h"
 #include "Iop_SifMan.h"
 #include "../SifModuleAdapter.h"
@@ -23,6 +24,7 @@ namespace Iop
 
 		void CountTicks(uint32, CSifMan*);
 		void SetOpticalMedia(COpticalMedia*);
+		void SetTurboIoEnabled(bool);
 
 		void LoadState(Framework::CZipArchiveReader&) override;
 		void SaveState(Framework::CZipArchiveWriter&) const override;
@@ -66,6 +68,8 @@ namespace Iop
 		void ReadChain(uint32*, uint32, uint32*, uint32, uint8*);
 		void SearchFile(uint32*, uint32, uint32*, uint32, uint8*);
 
+		int32 GetCommandDelay(uint64) const;
+
 		CCdvdman& m_cdvdman;
 		uint8* m_iopRam = nullptr;
 		COpticalMedia* m_opticalMedia = nullptr;
@@ -75,6 +79,8 @@ namespace Iop
 		uint32 m_pendingReadSector = 0;
 		uint32 m_pendingReadCount = 0;
 		uint32 m_pendingReadAddr = 0;
+		//Set by the EE thread, read by the IOP thread
+		std::atomic<bool> m_turboIoEnabled = false;
 
 		bool m_streaming = false;
 		uint32 m_streamPos = 0;
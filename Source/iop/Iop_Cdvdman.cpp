@@ -47,6 +47,7 @@ using namespace Iop;
 const uint64 CCdvdman::COMMAND_READ_BASE_DELAY = TimeUtils::UsecsToCycles(PS2::IOP_CLOCK_OVER_FREQ, 100);
 const uint64 CCdvdman::COMMAND_READ_SECTOR_DELAY = TimeUtils::UsecsToCycles(PS2::IOP_CLOCK_OVER_FREQ, 500);
 const uint64 CCdvdman::COMMAND_SEEK_DELAY = TimeUtils::UsecsToCycles(PS2::IOP_CLOCK_OVER_FREQ, 100);
+const uint64 CCdvdman::COMMAND_TURBO_DELAY = TimeUtils::UsecsToCycles(PS2::IOP_CLOCK_OVER_FREQ, 10);
 
 CCdvdman::CCdvdman(CIopBios& bios, uint8* ram)
     : m_bios(bios)
@@ -434,6 +435,11 @@ void CCdvdman::SetOpticalMedia(COpticalMedia* opticalMedia)
 	m_opticalMedia = opticalMedia;
 }
 
+void CCdvdman::SetTurboIoEnabled(bool turboIoEnabled)
+{
+	m_turboIoEnabled = turboIoEnabled;
+}
+
 uint32 CCdvdman::CdInit(uint32 mode)
 {
 	CLog::GetInstance().Print(LOG_NAME, FUNCTION_CDINIT "(mode = %d);\r\n", mode);
@@ -482,7 +488,7 @@ uint32 CCdvdman::CdRead(uint32 startSector, uint32 sectorCount, uint32 bufferPtr
 		}
 	}
 	m_pendingCommand = COMMAND_READ;
-	m_pendingCommandDelay = COMMAND_READ_BASE_DELAY + (sectorCount * COMMAND_READ_SECTOR_DELAY);
+	m_pendingCommandDelay = m_turboIoEnabled ? COMMAND_TURBO_DELAY : COMMAND_READ_BASE_DELAY + (sectorCount * COMMAND_READ_SECTOR_DELAY);
 	m_status = CDVD_STATUS_READING;
 	return 1;
 }
@@ -493,7 +499,7 @@ uint32 CCdvdman::CdSeek(uint32 sector)
 	                          sector);
 	assert(m_pendingCommand == COMMAND_NONE);
 	m_pendingCommand = COMMAND_SEEK;
-	m_pendingCommandDelay = COMMAND_SEEK_DELAY;
+	m_pendingCommandDelay = m_turboIoEnabled ? COMMAND_TURBO_DELAY : COMMAND_SEEK_DELAY;
 	return 1;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include "Iop_Module.h"
 #include "../OpticalMedia.h"
 #include "zip/ZipArchiveWriter.h"
@@ -51,6 +52,7 @@ namespace Iop
 
 		void CountTicks(uint32);
 		void SetOpticalMedia(COpticalMedia*);
+		void SetTurboIoEnabled(bool);
 
 		void LoadState(Framework::CZipArchiveReader&) override;
 		void SaveState(Framework::CZipArchiveWriter&) const override;
@@ -70,6 +72,8 @@ namespace Iop
 		static const uint64 COMMAND_READ_BASE_DELAY;
 		static const uint64 COMMAND_READ_SECTOR_DELAY;
 		static const uint64 COMMAND_SEEK_DELAY;
+		//Commands still complete asynchronously in turbo I/O mode, but as soon as possible
+		static const uint64 COMMAND_TURBO_DELAY;
 
 	private:
 		enum COMMAND : uint32
@@ -118,6 +122,8 @@ namespace Iop
 		uint32 m_streamBufferSize = 0;
 		COMMAND m_pendingCommand = COMMAND_NONE;
 		int32 m_pendingCommandDelay = 0;
+		//Set by the EE thread, read by the IOP thread
+		std::atomic<bool> m_turboIoEnabled = false;
 	};
 
 	typedef std::shared_ptr<CCdvdman> CdvdmanPtr;
@@ -27,8 +27,24 @@ CFileIoHandler2200::CFileIoHandler2200(CIoman* ioman, CSifMan& sifMan)
 	memset(m_pendingReply.buffer.data(), 0, PENDINGREPLY::REPLY_BUFFER_SIZE);
 }
 
+CFileIoHandler2200::~CFileIoHandler2200()
+{
+	//Completion handler refers to this handler, make sure it won't be called
+	if(m_asyncReadPending)
+	{
+		m_ioman->CancelAsyncRequests();
+	}
+}
+
 bool CFileIoHandler2200::Invoke(uint32 method, uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, uint8* ram)
 {
+	//Finish any read still in progress, replies are then handled as if the read was synchronous
+	if(m_asyncReadPending)
+	{
+		m_ioman->CompleteAsyncRequests();
+		assert(!m_asyncReadPending);
+	}
+
 	switch(method)
 	{
 	case COMMANDID_OPEN:
@@ -119,6 +135,9 @@ void CFileIoHandler2200::LoadState(Framework::CZipArchiveReader& archive)
 
 void CFileIoHandler2200::SaveState(Framework::CZipArchiveWriter& archive) const
 {
+	//Asynchronous requests are expected to be completed before saving
+	assert(!m_asyncReadPending);
+
 	{
 		auto registerFile = std::make_unique<CRegisterStateFile>(STATE_XML);
 		registerFile->SetRegister32(STATE_RESULTPTR0, m_resultPtr[0]);
@@ -134,6 +153,10 @@ void CFileIoHandler2200::SaveState(Framework::CZipArchiveWriter& archive) const
 
 void CFileIoHandler2200::ProcessCommands(CSifMan* sifMan)
 {
+	if(m_asyncReadPending)
+	{
+		m_ioman->ProcessAsyncRequests();
+	}
 	if(m_pendingReply.valid)
 	{
 		uint8* eeRam = nullptr;
@@ -201,29 +224,36 @@ uint32 CFileIoHandler2200::InvokeRead(uint32* args, uint32 argsSize, uint32* ret
 	assert(retSize == 4);
 	auto command = reinterpret_cast<READCOMMAND*>(args);
 	uint32 readAddress = command->buffer & (PS2::EE_RAM_SIZE - 1);
-	auto result = m_ioman->Read(command->fd, command->size, reinterpret_cast<void*>(ram + readAddress));
+	uint32 fileId = command->fd;
 
 	READREPLY reply;
 	reply.header.commandId = COMMANDID_READ;
 	CopyHeader(reply.header, command->header);
-	reply.result = result;
+	reply.result = 0;
 	reply.unknown2 = 0;
 	reply.unknown3 = 0;
 	reply.unknown4 = 0;
 
-	//If we have a pending reply for another file operation, just send that one right away.
-	//This can happen in Star Wars: Clone Wars when loading a specific level.
-	if(m_pendingReply.valid && (m_pendingReply.fileId != command->fd))
+	//Read from host on a worker thread if possible. The reply is delayed until the read completes,
+	//the EE thread waiting for it will stay blocked on its semaphore meanwhile.
+	bool asyncReadStarted = m_ioman->ReadAsync(fileId, command->size,
+	                                           [this, ram, readAddress, reply, fileId](uint32 result, const std::vector<uint8>& data) mutable {
+		                                           m_asyncReadPending = false;
+		                                           if(!data.empty())
+		                                           {
+			                                           memcpy(ram + readAddress, data.data(), data.size());
+		                                           }
+		                                           reply.result = result;
+		                                           SetReadReply(ram, reply, fileId);
+	                                           });
+	if(asyncReadStarted)
 	{
-		SendPendingReply(ram);
-		assert(!m_pendingReply.valid);
+		m_asyncReadPending = true;
+		return 1;
 	}
 
-	//Delay read reply to next frame.
-	//Some games, like Shadow of the Colossus, seem to rely on the delay to
-	//work properly (probably because it causes EE threads to be rescheduled).
-	m_pendingReply.SetReply(reply);
-	m_pendingReply.fileId = command->fd;
+	reply.result = m_ioman->Read(fileId, command->size, reinterpret_cast<void*>(ram + readAddress));
+	SetReadReply(ram, reply, fileId);
 	return 1;
 }
 
@@ -235,7 +265,12 @@ uint32 CFileIoHandler2200::InvokeWrite(uint32* args, uint32 argsSize, uint32* re
 
 	assert(command->unalignedSize == 0);
 	uint32 writeAddress = command->buffer & (PS2::EE_RAM_SIZE - 1);
-	auto result = m_ioman->Write(command->fd, command->size, reinterpret_cast<const void*>(ram + writeAddress));
+	//Asynchronous writes complete in the background, failures are only logged
+	uint32 result = command->size;
+	if(!m_ioman->WriteAsync(command->fd, command->size, reinterpret_cast<const void*>(ram + writeAddress)))
+	{
+		result = m_ioman->Write(command->fd, command->size, reinterpret_cast<const void*>(ram + writeAddress));
+	}
 
 	PrepareGenericReply(ram, command->header, COMMANDID_WRITE, result);
 	SendSifReply();
@@ -525,6 +560,23 @@ void CFileIoHandler2200::PrepareGenericReply(uint8* ram, const COMMANDHEADER& he
 	}
 }
 
+void CFileIoHandler2200::SetReadReply(uint8* ram, const READREPLY& reply, uint32 fileId)
+{
+	//If we have a pending reply for another file operation, just send that one right away.
+	//This can happen in Star Wars: Clone Wars when loading a specific level.
+	if(m_pendingReply.valid && (m_pendingReply.fileId != fileId))
+	{
+		SendPendingReply(ram);
+		assert(!m_pendingReply.valid);
+	}
+
+	//Delay read reply to next frame.
+	//Some games, like Shadow of the Colossus, seem to rely on the delay to
+	//work properly (probably because it causes EE threads to be rescheduled).
+	m_pendingReply.SetReply(reply);
+	m_pendingReply.fileId = fileId;
+}
+
 void CFileIoHandler2200::SendPendingReply(uint8* ram)
 {
 	//Send response
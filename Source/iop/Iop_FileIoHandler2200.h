@@ -11,6 +11,7 @@ namespace Iop
 	{
 	public:
 		CFileIoHandler2200(CIoman*, CSifMan&);
+		virtual ~CFileIoHandler2200();
 
 		bool Invoke(uint32, uint32*, uint32, uint32*, uint32, uint8*) override;
 
@@ -310,11 +311,13 @@ namespace Iop
 
 		void CopyHeader(REPLYHEADER&, const COMMANDHEADER&);
 		void PrepareGenericReply(uint8*, const COMMANDHEADER&, COMMANDID, uint32);
+		void SetReadReply(uint8*, const READREPLY&, uint32);
 		void SendPendingReply(uint8*);
 		void SendSifReply();
 
 		CSifMan& m_sifMan;
 		uint32 m_resultPtr[2];
 		PENDINGREPLY m_pendingReply;
+		bool m_asyncReadPending = false;
 	};
 };
@@ -102,6 +102,12 @@ CIoman::CIoman(CIopBios& bios, uint8* ram)
     , m_nextFileHandle(3)
 {
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_IOP_FILEIO_STDLOGGING, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_IOP_FILEIO_ASYNC, true);
+
+	if(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_IOP_FILEIO_ASYNC))
+	{
+		m_asyncIoEngine = std::make_unique<Ioman::CAsyncIoEngine>();
+	}
 
 	//Insert standard files if requested.
 	if(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_IOP_FILEIO_STDLOGGING)
@@ -127,6 +133,11 @@ CIoman::CIoman(CIopBios& bios, uint8* ram)
 
 CIoman::~CIoman()
 {
+	if(m_asyncIoEngine)
+	{
+		CancelAsyncRequests();
+		m_asyncIoEngine.reset();
+	}
 	m_files.clear();
 	m_devices.clear();
 }
@@ -1007,6 +1018,7 @@ int32 CIoman::AllocateFileHandle()
 void CIoman::FreeFileHandle(uint32 handle)
 {
 	assert(m_files.find(handle) != std::end(m_files));
+	WaitAsyncRequests(handle);
 	m_files.erase(handle);
 }
 
@@ -1027,15 +1039,139 @@ Framework::CStream* CIoman::GetFileStream(uint32 handle)
 	{
 		throw std::runtime_error("Invalid file handle.");
 	}
+	//Wait for requests on that file to keep operations in order
+	WaitAsyncRequests(handle);
 	return file->second.stream;
 }
 
 void CIoman::SetFileStream(uint32 handle, Framework::CStream* stream)
 {
+	WaitAsyncRequests(handle);
 	m_files.erase(handle);
 	m_files[handle] = {stream};
 }
 
+bool CIoman::ReadAsync(uint32 handle, uint32 size, AsyncReadCompletionHandler completionHandler)
+{
+	std::string deviceName;
+	auto stream = GetAsyncFileStream(handle, deviceName);
+	if(!stream) return false;
+
+	CLog::GetInstance().Print(LOG_NAME, "ReadAsync(handle = %d, size = 0x%X);\r\n", handle, size);
+
+	ASYNCREQUEST request;
+	request.requestId = m_asyncIoEngine->Read(deviceName, stream, size);
+	request.handle = handle;
+	request.size = size;
+	request.completionHandler = std::move(completionHandler);
+	m_asyncRequests.push_back(std::move(request));
+	return true;
+}
+
+bool CIoman::WriteAsync(uint32 handle, uint32 size, const void* buffer)
+{
+	std::string deviceName;
+	auto stream = GetAsyncFileStream(handle, deviceName);
+	if(!stream) return false;
+
+	CLog::GetInstance().Print(LOG_NAME, "WriteAsync(handle = %d, size = 0x%X);\r\n", handle, size);
+
+	ASYNCREQUEST request;
+	request.requestId = m_asyncIoEngine->Write(deviceName, stream, buffer, size);
+	request.handle = handle;
+	request.size = size;
+	m_asyncRequests.push_back(std::move(request));
+	return true;
+}
+
+void CIoman::ProcessAsyncRequests()
+{
+	//Requests are finished in submission order
+	while(!m_asyncRequests.empty() && m_asyncIoEngine->IsComplete(m_asyncRequests.front().requestId))
+	{
+		auto request = std::move(m_asyncRequests.front());
+		m_asyncRequests.pop_front();
+		FinishAsyncRequest(request);
+	}
+}
+
+void CIoman::CompleteAsyncRequests()
+{
+	while(!m_asyncRequests.empty())
+	{
+		auto request = std::move(m_asyncRequests.front());
+		m_asyncRequests.pop_front();
+		FinishAsyncRequest(request);
+	}
+}
+
+void CIoman::CancelAsyncRequests()
+{
+	//Requests still get executed, but their completion handlers are not called
+	for(const auto& request : m_asyncRequests)
+	{
+		m_asyncIoEngine->Release(request.requestId);
+	}
+	m_asyncRequests.clear();
+}
+
+Ioman::CAsyncIoEngine::DeviceStatsMap CIoman::GetAsyncIoStats() const
+{
+	if(!m_asyncIoEngine) return Ioman::CAsyncIoEngine::DeviceStatsMap();
+	return m_asyncIoEngine->GetDeviceStats();
+}
+
+void CIoman::ResetAsyncIoStats()
+{
+	if(!m_asyncIoEngine) return;
+	m_asyncIoEngine->ResetDeviceStats();
+}
+
+Framework::CStream* CIoman::GetAsyncFileStream(uint32 handle, std::string& deviceName)
+{
+	if(!m_asyncIoEngine) return nullptr;
+	if((handle == FID_STDOUT) || (handle == FID_STDERR)) return nullptr;
+	auto fileIterator = m_files.find(handle);
+	if(fileIterator == std::end(m_files)) return nullptr;
+	const auto& file = fileIterator->second;
+	if(!file.stream || (file.descPtr != 0)) return nullptr;
+	try
+	{
+		auto pathInfo = SplitPath(file.path.c_str());
+		auto deviceIterator = m_devices.find(pathInfo.deviceName);
+		if(deviceIterator == std::end(m_devices)) return nullptr;
+		if(!deviceIterator->second->IsAsyncIoSupported()) return nullptr;
+		deviceName = pathInfo.deviceName;
+	}
+	catch(const std::exception&)
+	{
+		return nullptr;
+	}
+	return file.stream;
+}
+
+void CIoman::WaitAsyncRequests(uint32 handle)
+{
+	if(!m_asyncIoEngine) return;
+	auto fileIterator = m_files.find(handle);
+	if(fileIterator == std::end(m_files)) return;
+	m_asyncIoEngine->WaitStream(fileIterator->second.stream);
+}
+
+void CIoman::FinishAsyncRequest(const ASYNCREQUEST& request)
+{
+	std::vector<uint8> data;
+	uint32 result = m_asyncIoEngine->Release(request.requestId, &data);
+	if(request.completionHandler)
+	{
+		request.completionHandler(result, data);
+	}
+	else if(result != request.size)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "%s: Asynchronous write on handle %d failed.\r\n", __FUNCTION__, request.handle);
+	}
+}
+
 //IOP Invoke
 void CIoman::Invoke(CMIPS& context, unsigned int functionId)
 {
@@ -1114,6 +1250,7 @@ void CIoman::SaveState(Framework::CZipArchiveWriter& archive) const
 
 void CIoman::LoadState(Framework::CZipArchiveReader& archive)
 {
+	CancelAsyncRequests();
 	LoadMountedDevicesState(archive);
 	LoadFilesState(archive);
 	LoadUserDevicesState(archive);
@@ -1121,6 +1258,9 @@ void CIoman::LoadState(Framework::CZipArchiveReader& archive)
 
 void CIoman::SaveFilesState(Framework::CZipArchiveWriter& archive) const
 {
+	//Requests must be completed before saving, the stream positions wouldn't be right otherwise
+	assert(m_asyncRequests.empty());
+
 	auto fileStateFile = std::make_unique<CXmlStateFile>(STATE_FILES_FILENAME, STATE_FILES_FILESNODE);
 	auto filesStateNode = fileStateFile->GetRoot();
 
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include "Iop_Module.h"
 #include "Ioman_Defs.h"
 #include "Ioman_Device.h"
+#include "ioman/AsyncIoEngine.h"
 #include "Stream.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 
+#define PREF_IOP_FILEIO_ASYNC ("iop.fileio.async")
+
 class CIopBios;
 
 namespace Iop
@@ -33,6 +38,8 @@ namespace Iop
 		{
 		};
 
+		typedef std::function<void(uint32, const std::vector<uint8>&)> AsyncReadCompletionHandler;
+
 		CIoman(CIopBios&, uint8*);
 		virtual ~CIoman();
 
@@ -78,6 +85,17 @@ namespace Iop
 		Framework::CStream* GetFileStream(uint32);
 		void SetFileStream(uint32, Framework::CStream*);
 
+		//Reads and writes on files from devices that allow it can be done on worker threads.
+		//These return false if the file doesn't support it, the synchronous version must be used then.
+		//Read completion handlers are called by ProcessAsyncRequests or CompleteAsyncRequests.
+		bool ReadAsync(uint32, uint32, AsyncReadCompletionHandler);
+		bool WriteAsync(uint32, uint32, const void*);
+		void ProcessAsyncRequests();
+		void CompleteAsyncRequests();
+		void CancelAsyncRequests();
+		Ioman::CAsyncIoEngine::DeviceStatsMap GetAsyncIoStats() const;
+		void ResetAsyncIoStats();
+
 	private:
 		struct FileInfo
 		{
@@ -137,6 +155,15 @@ namespace Iop
 		typedef std::map<std::string, uint32> UserDeviceMapType;
 		typedef std::map<std::string, std::string> MountedDeviceMapType;
 
+		struct ASYNCREQUEST
+		{
+			Ioman::CAsyncIoEngine::RequestId requestId = 0;
+			uint32 handle = 0;
+			uint32 size = 0;
+			AsyncReadCompletionHandler completionHandler;
+		};
+		typedef std::deque<ASYNCREQUEST> AsyncRequestQueue;
+
 		void PrepareOpenThunk();
 		Framework::CStream* OpenInternal(uint32, const char*);
 		int32 AllocateFileHandle();
@@ -145,6 +172,10 @@ namespace Iop
 
 		static Framework::STREAM_SEEK_DIRECTION ConvertWhence(uint32);
 
+		Framework::CStream* GetAsyncFileStream(uint32, std::string&);
+		void WaitAsyncRequests(uint32);
+		void FinishAsyncRequest(const ASYNCREQUEST&);
+
 		void InvokeUserDeviceMethod(CMIPS&, uint32, size_t offset, uint32 arg0 = 0, uint32 arg1 = 0, uint32 arg2 = 0);
 
 		bool IsUserDeviceFileHandle(int32) const;
@@ -167,6 +198,8 @@ namespace Iop
 		uint8* m_ram;
 		uint32 m_nextFileHandle;
 		uint32 m_openThunkPtr = 0;
+		std::unique_ptr<Ioman::CAsyncIoEngine> m_asyncIoEngine;
+		AsyncRequestQueue m_asyncRequests;
 	};
 
 	typedef std::shared_ptr<CIoman> IomanPtr;
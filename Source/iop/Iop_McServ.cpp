@@ -35,6 +35,7 @@ using namespace Iop;
 #define SEPARATOR_CHAR '/'
 
 #define CMD_DELAY_DEFAULT 100000
+#define CMD_DELAY_TURBO 1000
 
 #define STATE_MEMCARDS_FILE ("iop_mcserv/memcards.xml")
 #define STATE_MEMCARDS_NODE "Memorycards"
@@ -185,6 +186,11 @@ void CMcServ::CountTicks(uint32 ticks, CSifMan* sifMan)
 	}
 }
 
+void CMcServ::SetTurboIoEnabled(bool turboIoEnabled)
+{
+	m_turboIoEnabled = turboIoEnabled;
+}
+
 void CMcServ::Invoke(CMIPS& context, unsigned int functionId)
 {
 	switch(functionId)
@@ -293,7 +299,7 @@ bool CMcServ::Invoke(uint32 method, uint32* args, uint32 argsSize, uint32* ret,
 		auto moduleData = reinterpret_cast<MODULEDATA*>(m_ram + m_moduleDataAddr);
 		assert(moduleData->pendingCommand == CMD_ID_NONE);
 		moduleData->pendingCommand = method;
-		moduleData->pendingCommandDelay = CMD_DELAY_DEFAULT;
+		moduleData->pendingCommandDelay = m_turboIoEnabled ? CMD_DELAY_TURBO : CMD_DELAY_DEFAULT;
 	}
 
 	return false;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <regex>
@@ -141,6 +142,7 @@ namespace Iop
 		void SaveState(Framework::CZipArchiveWriter&) const override;
 
 		void CountTicks(uint32, CSifMan*);
+		void SetTurboIoEnabled(bool);
 
 	private:
 		struct MODULEDATA
@@ -246,6 +248,9 @@ namespace Iop
 		// a given slot has already been read,
 		// or if it is a newly inserted card.
 		bool m_knownMemoryCards[MAX_PORTS];
+
+		//Set by the EE thread, read by the IOP thread
+		std::atomic<bool> m_turboIoEnabled = false;
 	};
 
 	typedef std::shared_ptr<CMcServ> McServPtr;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <assert.h>
 #include <cstring>
 #include "Iop_RootCounters.h"
@@ -81,6 +82,8 @@ unsigned int CRootCounters::GetCounterIdByAddress(uint32 address)
 void CRootCounters::Reset()
 {
 	memset(&m_counter, 0, sizeof(m_counter));
+	m_totalTicks = 0;
+	m_nextEventTicks = ~0ULL;
 }
 
 void CRootCounters::LoadState(Framework::CZipArchiveReader& archive)
@@ -94,11 +97,14 @@ void CRootCounters::LoadState(Framework::CZipArchiveReader& archive)
 		counter.mode <<= registerFile.GetRegister32((counterPrefix + "MODE").c_str());
 		counter.target = registerFile.GetRegister32((counterPrefix + "TGT").c_str());
 		counter.clockRemain = registerFile.GetRegister32((counterPrefix + "REM").c_str());
+		counter.baseTicks = m_totalTicks;
 	}
+	UpdateNextEventTicks();
 }
 
 void CRootCounters::SaveState(Framework::CZipArchiveWriter& archive)
 {
+	SyncCounters();
 	auto registerFile = std::make_unique<CRegisterStateFile>(STATE_REGS_XML);
 	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
 	{
@@ -114,72 +120,140 @@ void CRootCounters::SaveState(Framework::CZipArchiveWriter& archive)
 
 void CRootCounters::Update(unsigned int ticks)
 {
-	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
+	m_totalTicks += ticks;
+	if(m_totalTicks < m_nextEventTicks) return;
+	SyncCounters();
+}
+
+bool CRootCounters::IsCounterRunning(unsigned int i) const
+{
+	const auto& counter = m_counter[i];
+	return !(i == 2 && counter.mode.en);
+}
+
+uint32 CRootCounters::GetCounterClockRatio(unsigned int i) const
+{
+	const auto& counter = m_counter[i];
+	uint32 clockRatio = 1;
+	if(i == 0 && counter.mode.clc)
 	{
-		auto& counter = m_counter[i];
-		if(i == 2 && counter.mode.en) continue;
-		//Compute count increment
-		uint32 clockRatio = 1;
-		if(i == 0 && counter.mode.clc)
-		{
-			clockRatio = m_pixelClocks;
-		}
-		if(((i == 1) || (i == 3)) && counter.mode.clc)
-		{
-			clockRatio = m_hsyncClocks;
-		}
-		if(i == 2 && (counter.mode.div != COUNTER_SCALE_1))
+		clockRatio = m_pixelClocks;
+	}
+	if(((i == 1) || (i == 3)) && counter.mode.clc)
+	{
+		clockRatio = m_hsyncClocks;
+	}
+	if(i == 2 && (counter.mode.div != COUNTER_SCALE_1))
+	{
+		assert(counter.mode.div == COUNTER_SCALE_8);
+		clockRatio = 8;
+	}
+	if(
+	    ((i == 4) || (i == 5)) &&
+	    (counter.mode.div != COUNTER_SCALE_1))
+	{
+		switch(counter.mode.div)
 		{
-			assert(counter.mode.div == COUNTER_SCALE_8);
+		case COUNTER_SCALE_8:
 			clockRatio = 8;
+			break;
+		case COUNTER_SCALE_16:
+			clockRatio = 16;
+			break;
+		case COUNTER_SCALE_256:
+			clockRatio = 256;
+			break;
 		}
-		if(
-		    ((i == 4) || (i == 5)) &&
-		    (counter.mode.div != COUNTER_SCALE_1))
-		{
-			switch(counter.mode.div)
-			{
-			case COUNTER_SCALE_8:
-				clockRatio = 8;
-				break;
-			case COUNTER_SCALE_16:
-				clockRatio = 16;
-				break;
-			case COUNTER_SCALE_256:
-				clockRatio = 256;
-				break;
-			}
-		}
-		uint32 totalTicks = counter.clockRemain + ticks;
-		uint64 countAdd = totalTicks / clockRatio;
-		counter.clockRemain = totalTicks % clockRatio;
-		//Update count
-		uint64 counterMax = 0;
-		if(g_counterSizes[i] == 16)
-		{
-			counterMax = counter.mode.tar ? static_cast<uint16>(counter.target) : 0xFFFF;
-		}
-		else
+	}
+	return clockRatio;
+}
+
+uint64 CRootCounters::GetCounterMax(unsigned int i) const
+{
+	const auto& counter = m_counter[i];
+	if(g_counterSizes[i] == 16)
+	{
+		return counter.mode.tar ? static_cast<uint16>(counter.target) : 0xFFFF;
+	}
+	else
+	{
+		return counter.mode.tar ? counter.target : 0xFFFFFFFF;
+	}
+}
+
+uint32 CRootCounters::GetCounterCount(unsigned int i) const
+{
+	//No counter can reach its maximum value before the next event, so the
+	//current count can be derived from the elapsed ticks alone
+	assert(m_totalTicks < m_nextEventTicks);
+	const auto& counter = m_counter[i];
+	if(!IsCounterRunning(i)) return counter.count;
+	uint64 totalTicks = counter.clockRemain + (m_totalTicks - counter.baseTicks);
+	uint64 count = static_cast<uint64>(counter.count) + (totalTicks / GetCounterClockRatio(i));
+	return (g_counterSizes[i] == 16) ? static_cast<uint16>(count) : static_cast<uint32>(count);
+}
+
+void CRootCounters::SyncCounter(unsigned int i)
+{
+	auto& counter = m_counter[i];
+	uint64 elapsedTicks = m_totalTicks - counter.baseTicks;
+	counter.baseTicks = m_totalTicks;
+	if(!IsCounterRunning(i)) return;
+	//Compute count increment
+	uint32 clockRatio = GetCounterClockRatio(i);
+	uint64 totalTicks = counter.clockRemain + elapsedTicks;
+	uint64 countAdd = totalTicks / clockRatio;
+	counter.clockRemain = static_cast<uint32>(totalTicks % clockRatio);
+	//Update count
+	uint64 counterMax = GetCounterMax(i);
+	uint64 counterTemp = static_cast<uint64>(counter.count) + countAdd;
+	if(counterTemp >= counterMax)
+	{
+		counterTemp -= counterMax;
+		if(counter.mode.iq1 && counter.mode.iq2)
 		{
-			counterMax = counter.mode.tar ? counter.target : 0xFFFFFFFF;
+			m_intc.AssertLine(g_counterInterruptLines[i]);
 		}
-		uint64 counterTemp = static_cast<uint64>(counter.count) + countAdd;
-		if(counterTemp >= counterMax)
+	}
+	if(g_counterSizes[i] == 16)
+	{
+		counter.count = static_cast<uint16>(counterTemp);
+	}
+	else
+	{
+		counter.count = static_cast<uint32>(counterTemp);
+	}
+}
+
+void CRootCounters::SyncCounters()
+{
+	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
+	{
+		SyncCounter(i);
+	}
+	UpdateNextEventTicks();
+}
+
+void CRootCounters::UpdateNextEventTicks()
+{
+	//Find the earliest time at which a counter will reach its maximum value
+	m_nextEventTicks = ~0ULL;
+	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
+	{
+		if(!IsCounterRunning(i)) continue;
+		const auto& counter = m_counter[i];
+		uint64 counterMax = GetCounterMax(i);
+		//If the counter is already past its maximum value, it wraps on the next update
+		uint64 eventTicks = counter.baseTicks + 1;
+		if(counterMax > counter.count)
 		{
-			counterTemp -= counterMax;
-			if(counter.mode.iq1 && counter.mode.iq2)
+			uint64 ticksToEvent = (counterMax - counter.count) * GetCounterClockRatio(i);
+			if(ticksToEvent > counter.clockRemain)
 			{
-				m_intc.AssertLine(g_counterInterruptLines[i]);
+				eventTicks = counter.baseTicks + ticksToEvent - counter.clockRemain;
 			}
 		}
-		if(g_counterSizes[i] == 16)
-		{
-			counter.count = static_cast<uint16>(counterTemp);
-		}
-		else
-		{
-			counter.count = static_cast<uint32>(counterTemp);
-		}
+		m_nextEventTicks = std::min(m_nextEventTicks, eventTicks);
 	}
 }
 
@@ -191,10 +265,15 @@ uint32 CRootCounters::ReadRegister(uint32 address)
 	unsigned int counterId = GetCounterIdByAddress(address);
 	unsigned int registerId = address & 0x0F;
 	assert(counterId < MAX_COUNTERS);
+	//Counts only need to be brought up to date if an event is due
+	if(m_totalTicks >= m_nextEventTicks)
+	{
+		SyncCounters();
+	}
 	switch(registerId)
 	{
 	case CNT_COUNT:
-		return m_counter[counterId].count;
+		return GetCounterCount(counterId);
 		break;
 	case CNT_MODE:
 		return m_counter[counterId].mode;
@@ -214,6 +293,7 @@ uint32 CRootCounters::WriteRegister(uint32 address, uint32 value)
 	unsigned int counterId = GetCounterIdByAddress(address);
 	unsigned int registerId = address & 0x0F;
 	assert(counterId < MAX_COUNTERS);
+	SyncCounters();
 	COUNTER& counter = m_counter[counterId];
 	switch(registerId)
 	{
@@ -227,6 +307,7 @@ uint32 CRootCounters::WriteRegister(uint32 address, uint32 value)
 		counter.target = value;
 		break;
 	}
+	UpdateNextEventTicks();
 	return 0;
 }
 
@@ -95,12 +95,16 @@ namespace Iop
 		static const uint32 g_counterMaxScales[MAX_COUNTERS];
 
 	private:
+		//Counters are only brought up to date when they are accessed or when one of them
+		//reaches its maximum value. In between, count and clockRemain hold the state of the
+		//counter at baseTicks.
 		struct COUNTER
 		{
 			uint32 count;
 			MODE mode;
 			uint32 target;
 			uint32 clockRemain;
+			uint64 baseTicks;
 		};
 
 		void DisassembleRead(uint32);
@@ -108,7 +112,17 @@ namespace Iop
 
 		static unsigned int GetCounterIdByAddress(uint32);
 
+		bool IsCounterRunning(unsigned int) const;
+		uint32 GetCounterClockRatio(unsigned int) const;
+		uint64 GetCounterMax(unsigned int) const;
+		uint32 GetCounterCount(unsigned int) const;
+		void SyncCounter(unsigned int);
+		void SyncCounters();
+		void UpdateNextEventTicks();
+
 		COUNTER m_counter[MAX_COUNTERS];
+		uint64 m_totalTicks = 0;
+		uint64 m_nextEventTicks = ~0ULL;
 		unsigned int m_hsyncClocks;
 		unsigned int m_pixelClocks;
 		Iop::CIntc& m_intc;
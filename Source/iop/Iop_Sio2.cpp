@@ -126,11 +126,13 @@ void CSio2::SetButtonState(unsigned int padNumber, PS2::CControllerInfo::BUTTON
 
 	auto& padState = m_padState[padNumber];
 	auto buttonMask = static_cast<uint16>(GetButtonMask(button));
-	padState.buttonState &= ~buttonMask;
+	//Button bits are active low, update the state in a single write
+	uint16 buttonState = padState.buttonState & ~buttonMask;
 	if(!pressed)
 	{
-		padState.buttonState |= buttonMask;
+		buttonState |= buttonMask;
 	}
+	padState.buttonState = buttonState;
 }
 
 void CSio2::SetAxisState(unsigned int padNumber, PS2::CControllerInfo::BUTTON axis, uint8 axisValue, uint8* ram)
@@ -340,6 +342,7 @@ void CSio2::ProcessController(unsigned int portId, size_t outputOffset, uint32 d
 			break;
 		case 0x42: //Read Data
 			assert(dstSize == 5 || dstSize == 9 || dstSize == 21);
+			Poll();
 			//Pad data goes here
 			m_outputBuffer[outputOffset + 0x03] = static_cast<uint8>(padState.buttonState >> 8);
 			m_outputBuffer[outputOffset + 0x04] = static_cast<uint8>(padState.buttonState & 0xFF);
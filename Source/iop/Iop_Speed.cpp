@@ -10,7 +10,7 @@
 using namespace Iop;
 
 // clang-format off
-const uint16 CSpeed::m_eepromData[] =
+const uint16 CSpeed::m_defaultEepromData[m_eepRomDataSize] =
 {
 	//MAC address
 	0x1122, 0x1122, 0x4466,
@@ -22,6 +22,7 @@ const uint16 CSpeed::m_eepromData[] =
 CSpeed::CSpeed(CIntc& intc)
     : m_intc(intc)
 {
+	memcpy(m_eepromData, m_defaultEepromData, sizeof(m_eepromData));
 }
 
 void CSpeed::Reset()
@@ -43,16 +44,42 @@ void CSpeed::Reset()
 	memset(m_smapBdRx, 0, sizeof(m_smapBdRx));
 }
 
+void CSpeed::SetMacAddress(const uint8* macAddress)
+{
+	//Needs to be set before the SMAP driver reads the EEPROM to have any effect
+	uint16 checksum = 0;
+	for(uint32 i = 0; i < 3; i++)
+	{
+		m_eepromData[i] = macAddress[(i * 2) + 0] | (macAddress[(i * 2) + 1] << 8);
+		checksum += m_eepromData[i];
+	}
+	m_eepromData[3] = checksum;
+}
+
 void CSpeed::SetEthernetFrameTxHandler(const EthernetFrameTxHandler& ethernetFrameTxHandler)
 {
 	m_ethernetFrameTxHandler = ethernetFrameTxHandler;
 }
 
+void CSpeed::SetEthernetFrameRxReadyHandler(const EthernetFrameRxReadyHandler& ethernetFrameRxReadyHandler)
+{
+	m_ethernetFrameRxReadyHandler = ethernetFrameRxReadyHandler;
+}
+
+bool CSpeed::CanRxEthernetFrame() const
+{
+	//We only have space for a single frame, the previous one must have been consumed
+	if(m_pendingRx || (m_rxFrameCount != 0)) return false;
+	auto& bdRx = reinterpret_cast<const SMAP_BD*>(m_smapBdRx)[m_rxIndex];
+	return (bdRx.ctrlStat & SMAP_BD_RX_EMPTY) != 0;
+}
+
 void CSpeed::RxEthernetFrame(const uint8* frameData, uint32 frameSize)
 {
 	assert(!m_pendingRx);
 
-	m_rxBuffer.resize(frameSize);
+	//FIFO is read 32 bits at a time, make sure there's enough room for the last word
+	m_rxBuffer.resize((frameSize + 3) & ~3);
 	memcpy(m_rxBuffer.data(), frameData, frameSize);
 
 	auto& bdRx = reinterpret_cast<SMAP_BD*>(m_smapBdRx)[m_rxIndex];
@@ -62,7 +89,7 @@ void CSpeed::RxEthernetFrame(const uint8* frameData, uint32 frameSize)
 	bdRx.pointer = 0;
 
 	m_rxIndex++;
-	m_rxIndex %= SMAP_BD_SIZE;
+	m_rxIndex %= SMAP_BD_COUNT;
 
 	m_pendingRx = true;
 	m_rxDelay = 100000;
@@ -331,6 +358,10 @@ void CSpeed::CountTicks(uint32 ticks)
 			m_rxFrameCount++;
 		}
 	}
+	else if(m_ethernetFrameRxReadyHandler && CanRxEthernetFrame())
+	{
+		m_ethernetFrameRxReadyHandler();
+	}
 }
 
 void CSpeed::LogRead(uint32 address)
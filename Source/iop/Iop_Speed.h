@@ -14,12 +14,17 @@ namespace Iop
 	{
 	public:
 		typedef std::function<void(const uint8*, uint32)> EthernetFrameTxHandler;
+		typedef std::function<void()> EthernetFrameRxReadyHandler;
 
 		CSpeed(CIntc&);
 
 		void Reset();
 
+		void SetMacAddress(const uint8*);
+
 		void SetEthernetFrameTxHandler(const EthernetFrameTxHandler&);
+		void SetEthernetFrameRxReadyHandler(const EthernetFrameRxReadyHandler&);
+		bool CanRxEthernetFrame() const;
 		void RxEthernetFrame(const uint8*, uint32);
 
 		uint32 ReadRegister(uint32);
@@ -127,6 +132,7 @@ namespace Iop
 		void LogBdWrite(const char*, uint32, uint32, uint32);
 
 		EthernetFrameTxHandler m_ethernetFrameTxHandler;
+		EthernetFrameRxReadyHandler m_ethernetFrameRxReadyHandler;
 
 		CIntc& m_intc;
 
@@ -138,7 +144,8 @@ namespace Iop
 		uint32 m_intrMask = 0;
 		uint32 m_eepRomReadIndex = 0;
 		static const uint32 m_eepRomDataSize = 4;
-		static const uint16 m_eepromData[];
+		static const uint16 m_defaultEepromData[m_eepRomDataSize];
+		uint16 m_eepromData[m_eepRomDataSize];
 		std::vector<uint8> m_txBuffer;
 		std::vector<uint8> m_rxBuffer;
 		uint32 m_rxFifoPtr = 0;
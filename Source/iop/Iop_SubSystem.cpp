@@ -1,6 +1,6 @@
 #include "Iop_SubSystem.h"
 #include "IopBios.h"
-#include "GenericMipsExecutor.h"
+#include "IopExecutor.h"
 #include "../psx/PsxBios.h"
 #include "../states/MemoryStateFile.h"
 #include "../states/RegisterStateFile.h"
@@ -50,7 +50,7 @@ CSubSystem::CSubSystem(bool ps2Mode)
 		m_bios = std::make_shared<CPsxBios>(m_cpu, m_ram, PS2::IOP_BASE_RAM_SIZE);
 	}
 
-	m_cpu.m_executor = std::make_unique<CGenericMipsExecutor<BlockLookupOneWay>>(m_cpu, (IOP_RAM_SIZE * 4), BLOCK_CATEGORY_PS2_IOP);
+	m_cpu.m_executor = std::make_unique<CIopExecutor>(m_cpu, (IOP_RAM_SIZE * 4));
 
 	//Read memory map
 	m_cpu.m_pMemoryMap->InsertReadMap((0 * IOP_RAM_SIZE), (0 * IOP_RAM_SIZE) + IOP_RAM_SIZE - 1, m_ram, 0x01);
@@ -363,7 +363,7 @@ void CSubSystem::CheckPendingInterrupts()
 
 bool CSubSystem::IsCpuIdle()
 {
-	return m_bios->IsIdle();
+	return m_bios->IsIdle() || m_isIdle;
 }
 
 void CSubSystem::CountTicks(int ticks)
@@ -401,6 +401,7 @@ void CSubSystem::CountTicks(int ticks)
 int CSubSystem::ExecuteCpu(int quota)
 {
 	int executed = 0;
+	m_isIdle = false;
 	CheckPendingInterrupts();
 	if(!m_cpu.m_State.nHasException)
 	{
@@ -422,6 +423,12 @@ int CSubSystem::ExecuteCpu(int quota)
 			m_cpu.m_State.nHasException = MIPS_EXCEPTION_NONE;
 		}
 		break;
+		case MIPS_EXCEPTION_IDLE:
+		{
+			m_isIdle = true;
+			m_cpu.m_State.nHasException = MIPS_EXCEPTION_NONE;
+		}
+		break;
 		}
 		assert(m_cpu.m_State.nHasException == MIPS_EXCEPTION_NONE);
 	}
@@ -77,5 +77,6 @@ namespace Iop
 
 		int m_dmaUpdateTicks = 0;
 		int m_spuIrqUpdateTicks = 0;
+		bool m_isIdle = false;
 	};
 }
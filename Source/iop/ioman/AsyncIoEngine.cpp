@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include "AsyncIoEngine.h"
+#include "Log.h"
+
+#define LOG_NAME "iop_ioman_async"
+
+using namespace Iop::Ioman;
+
+CAsyncIoEngine::CAsyncIoEngine(uint32 workerCount)
+{
+	assert(workerCount != 0);
+	for(uint32 i = 0; i < workerCount; i++)
+	{
+		m_workers.emplace_back([this]() { WorkerProc(); });
+	}
+}
+
+CAsyncIoEngine::~CAsyncIoEngine()
+{
+	WaitAll();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_workAvailableCondition.notify_all();
+	for(auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+CAsyncIoEngine::RequestId CAsyncIoEngine::Read(const std::string& device, Framework::CStream* stream, uint32 size)
+{
+	auto request = std::make_shared<REQUEST>();
+	request->operation = OPERATION_READ;
+	request->device = device;
+	request->stream = stream;
+	request->size = size;
+	return Submit(std::move(request));
+}
+
+CAsyncIoEngine::RequestId CAsyncIoEngine::Write(const std::string& device, Framework::CStream* stream, const void* buffer, uint32 size)
+{
+	auto request = std::make_shared<REQUEST>();
+	request->operation = OPERATION_WRITE;
+	request->device = device;
+	request->stream = stream;
+	request->size = size;
+	request->data.resize(size);
+	memcpy(request->data.data(), buffer, size);
+	return Submit(std::move(request));
+}
+
+bool CAsyncIoEngine::IsComplete(RequestId requestId) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto requestIterator = m_requests.find(requestId);
+	if(requestIterator == std::end(m_requests)) return true;
+	return requestIterator->second->complete;
+}
+
+void CAsyncIoEngine::Wait(RequestId requestId)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_completeCondition.wait(lock,
+	                         [&]() {
+		                         auto requestIterator = m_requests.find(requestId);
+		                         return (requestIterator == std::end(m_requests)) || requestIterator->second->complete;
+	                         });
+}
+
+void CAsyncIoEngine::WaitStream(Framework::CStream* stream)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_completeCondition.wait(lock,
+	                         [&]() {
+		                         return std::none_of(std::begin(m_requests), std::end(m_requests),
+		                                             [&](const auto& requestPair) {
+			                                             const auto& request = requestPair.second;
+			                                             return (request->stream == stream) && !request->complete;
+		                                             });
+	                         });
+}
+
+void CAsyncIoEngine::WaitAll()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_completeCondition.wait(lock,
+	                         [&]() {
+		                         return std::all_of(std::begin(m_requests), std::end(m_requests),
+		                                            [](const auto& requestPair) { return requestPair.second->complete; });
+	                         });
+}
+
+uint32 CAsyncIoEngine::Release(RequestId requestId, std::vector<uint8>* data)
+{
+	Wait(requestId);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto requestIterator = m_requests.find(requestId);
+	if(requestIterator == std::end(m_requests))
+	{
+		assert(false);
+		return RESULT_ERROR;
+	}
+	auto request = requestIterator->second;
+	m_requests.erase(requestIterator);
+	if(data)
+	{
+		(*data) = std::move(request->data);
+	}
+	return request->result;
+}
+
+CAsyncIoEngine::DeviceStatsMap CAsyncIoEngine::GetDeviceStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_deviceStats;
+}
+
+void CAsyncIoEngine::ResetDeviceStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_deviceStats.clear();
+}
+
+uint64 CAsyncIoEngine::GetTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CAsyncIoEngine::RequestId CAsyncIoEngine::Submit(RequestPtr request)
+{
+	RequestId requestId = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		requestId = m_nextRequestId++;
+		//Skip 0 to keep it available as an invalid id
+		if(m_nextRequestId == 0) m_nextRequestId = 1;
+		request->id = requestId;
+		request->submitTime = GetTimestamp();
+		m_requests[requestId] = request;
+		m_pendingRequests.push_back(std::move(request));
+	}
+	m_workAvailableCondition.notify_one();
+	return requestId;
+}
+
+void CAsyncIoEngine::WorkerProc()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(1)
+	{
+		//Take the oldest request whose device isn't already used by another worker,
+		//this keeps requests made on the same device in order.
+		auto requestIterator = std::end(m_pendingRequests);
+		m_workAvailableCondition.wait(lock,
+		                              [&]() {
+			                              requestIterator = std::find_if(std::begin(m_pendingRequests), std::end(m_pendingRequests),
+			                                                             [&](const auto& request) { return m_busyDevices.count(request->device) == 0; });
+			                              return m_quit || (requestIterator != std::end(m_pendingRequests));
+		                              });
+		if(requestIterator == std::end(m_pendingRequests))
+		{
+			assert(m_quit);
+			break;
+		}
+
+		auto request = *requestIterator;
+		m_pendingRequests.erase(requestIterator);
+		m_busyDevices.insert(request->device);
+
+		lock.unlock();
+		ExecuteRequest(*request);
+		uint64 latency = GetTimestamp() - request->submitTime;
+		lock.lock();
+
+		request->complete = true;
+		m_busyDevices.erase(request->device);
+		UpdateStats(*request, latency);
+
+		m_completeCondition.notify_all();
+		m_workAvailableCondition.notify_all();
+	}
+}
+
+void CAsyncIoEngine::ExecuteRequest(REQUEST& request)
+{
+	try
+	{
+		switch(request.operation)
+		{
+		case OPERATION_READ:
+			request.data.resize(request.size);
+			if(request.stream->IsEOF())
+			{
+				request.result = 0;
+			}
+			else
+			{
+				request.result = static_cast<uint32>(request.stream->Read(request.data.data(), request.size));
+			}
+			request.data.resize(request.result);
+			break;
+		case OPERATION_WRITE:
+			request.result = static_cast<uint32>(request.stream->Write(request.data.data(), request.size));
+			request.data.clear();
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Request on device '%s' failed: %s\r\n", request.device.c_str(), exception.what());
+		request.result = RESULT_ERROR;
+		request.data.clear();
+	}
+}
+
+void CAsyncIoEngine::UpdateStats(const REQUEST& request, uint64 latency)
+{
+	auto& stats = m_deviceStats[request.device];
+	switch(request.operation)
+	{
+	case OPERATION_READ:
+		stats.readCount++;
+		break;
+	case OPERATION_WRITE:
+		stats.writeCount++;
+		break;
+	}
+	if(request.result != RESULT_ERROR)
+	{
+		stats.byteCount += request.result;
+	}
+	stats.totalLatency += latency;
+	stats.maxLatency = std::max(stats.maxLatency, latency);
+	uint32 bucket = 0;
+	while((bucket < (LATENCY_BUCKET_COUNT - 1)) && (latency >= (1ULL << bucket)))
+	{
+		bucket++;
+	}
+	stats.latencyHistogram[bucket]++;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Stream.h"
+
+namespace Iop
+{
+	namespace Ioman
+	{
+		//Runs host file reads and writes on worker threads.
+		//Requests made on the same device are executed in the order they were submitted,
+		//devices are expected not to share any state between their streams.
+		class CAsyncIoEngine
+		{
+		public:
+			typedef uint32 RequestId;
+
+			enum
+			{
+				DEFAULT_WORKER_COUNT = 2,
+				LATENCY_BUCKET_COUNT = 16,
+			};
+
+			enum : uint32
+			{
+				RESULT_ERROR = ~0U,
+			};
+
+			//Latency histogram buckets are powers of two in microseconds (< 1us, < 2us, < 4us, ...),
+			//the last bucket holds all requests that took longer.
+			struct DEVICE_STATS
+			{
+				uint64 readCount = 0;
+				uint64 writeCount = 0;
+				uint64 byteCount = 0;
+				uint64 totalLatency = 0;
+				uint64 maxLatency = 0;
+				std::array<uint64, LATENCY_BUCKET_COUNT> latencyHistogram = {};
+			};
+			typedef std::map<std::string, DEVICE_STATS> DeviceStatsMap;
+
+			CAsyncIoEngine(uint32 = DEFAULT_WORKER_COUNT);
+			virtual ~CAsyncIoEngine();
+
+			RequestId Read(const std::string&, Framework::CStream*, uint32);
+			RequestId Write(const std::string&, Framework::CStream*, const void*, uint32);
+
+			bool IsComplete(RequestId) const;
+			void Wait(RequestId);
+			void WaitStream(Framework::CStream*);
+			void WaitAll();
+
+			//Waits for the request to complete and removes it, returns the number of bytes
+			//transferred (or RESULT_ERROR). Data of read requests is moved in the output vector.
+			uint32 Release(RequestId, std::vector<uint8>* = nullptr);
+
+			DeviceStatsMap GetDeviceStats() const;
+			void ResetDeviceStats();
+
+		private:
+			enum OPERATION
+			{
+				OPERATION_READ,
+				OPERATION_WRITE,
+			};
+
+			struct REQUEST
+			{
+				RequestId id = 0;
+				OPERATION operation = OPERATION_READ;
+				std::string device;
+				Framework::CStream* stream = nullptr;
+				std::vector<uint8> data;
+				uint32 size = 0;
+				uint32 result = RESULT_ERROR;
+				bool complete = false;
+				uint64 submitTime = 0;
+			};
+			typedef std::shared_ptr<REQUEST> RequestPtr;
+
+			static uint64 GetTimestamp();
+
+			RequestId Submit(RequestPtr);
+			void WorkerProc();
+			void ExecuteRequest(REQUEST&);
+			void UpdateStats(const REQUEST&, uint64);
+
+			mutable std::mutex m_mutex;
+			std::condition_variable m_workAvailableCondition;
+			std::condition_variable m_completeCondition;
+			std::deque<RequestPtr> m_pendingRequests;
+			std::map<RequestId, RequestPtr> m_requests;
+			std::set<std::string> m_busyDevices;
+			DeviceStatsMap m_deviceStats;
+			RequestId m_nextRequestId = 1;
+			bool m_quit = false;
+			std::vector<std::thread> m_workers;
+		};
+	}
+}
@@ -94,3 +94,9 @@ void CDirectoryDevice::Rename(const char* srcDevicePath, const char* dstDevicePa
 	auto dstPath = Iop::PathUtils::MakeHostPath(basePath, dstDevicePath);
 	fs::rename(srcPath, dstPath);
 }
+
+bool CDirectoryDevice::IsAsyncIoSupported() const
+{
+	//Each file gets its own host stream
+	return true;
+}
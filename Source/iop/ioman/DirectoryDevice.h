@@ -16,6 +16,7 @@ namespace Iop
 			DirectoryIteratorPtr GetDirectory(const char*) override;
 			void MakeDirectory(const char*) override;
 			void Rename(const char*, const char*) override;
+			bool IsAsyncIoSupported() const override;
 
 		protected:
 			virtual fs::path GetBasePath() = 0;
@@ -3,6 +3,7 @@
 #include <cstring>
 #include "HardDiskDevice.h"
 #include "hdd/ApaReader.h"
+#include "hdd/CachedStream.h"
 #include "StringUtils.h"
 #include "MemStream.h"
 
@@ -10,7 +11,7 @@ using namespace Iop;
 using namespace Iop::Ioman;
 
 CHardDiskDumpDevice::CHardDiskDumpDevice(std::unique_ptr<Framework::CStream> stream)
-    : m_stream(std::move(stream))
+    : m_stream(std::make_unique<Hdd::CCachedStream>(std::move(stream)))
 {
 }
 
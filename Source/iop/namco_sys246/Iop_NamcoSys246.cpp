@@ -130,6 +130,7 @@ void CSys246::Invoke(CMIPS& context, unsigned int functionId)
 
 void CSys246::ProcessJvsPacket(const uint8* input, uint8* output)
 {
+	Poll();
 	assert(*input == JVS_SYNC);
 	input++;
 	uint8 inDest = *input++;
@@ -8,6 +8,7 @@
 #include "ui_shared/ArcadeUtils.h"
 #include "ui_shared/BootablesProcesses.h"
 #include "ui_shared/StatsManager.h"
+#include "Ps2Const.h"
 #include "QtUtils.h"
 
 #include "openglwindow.h"
@@ -90,7 +91,16 @@ MainWindow::MainWindow(QWidget* parent)
 		QFont courierFont("Courier");
 		m_profileStatsLabel->setFont(courierFont);
 		m_profileStatsLabel->setAlignment(Qt::AlignTop);
+		m_profileStatsLabel->setContextMenuPolicy(Qt::CustomContextMenu);
 		ui->gridLayout->addWidget(m_profileStatsLabel, 0, 1);
+
+		connect(m_profileStatsLabel, &QLabel::customContextMenuRequested, [&](const QPoint& pos) {
+			QMenu contextMenu(this);
+			auto traceAction = contextMenu.addAction("Capture Trace (60 frames)");
+			traceAction->setEnabled(m_virtualMachine != nullptr);
+			connect(traceAction, &QAction::triggered, [this]() { captureTrace(60); });
+			contextMenu.exec(m_profileStatsLabel->mapToGlobal(pos));
+		});
 	}
 #endif
 
@@ -595,11 +605,58 @@ void MainWindow::updateStats()
 	uint32 frames = CStatsManager::GetInstance().GetFrames();
 	uint32 drawCalls = CStatsManager::GetInstance().GetDrawCalls();
 	auto cpuUtilisation = CStatsManager::GetInstance().GetCpuUtilisationInfo();
+	auto frameSkipStats = CStatsManager::GetInstance().GetFrameSkipStats();
+	auto inputLatencyStats = CStatsManager::GetInstance().GetInputLatencyStats();
+	auto asyncIoStats = CStatsManager::GetInstance().GetAsyncIoStats();
+	auto gsImageStagingStats = CStatsManager::GetInstance().GetGsImageStagingStats();
+	auto sifRpcServerStats = CStatsManager::GetInstance().GetSifRpcServerStats();
 	uint32 dcpf = (frames != 0) ? (drawCalls / frames) : 0;
 #ifdef PROFILE
 	m_profileStatsLabel->setText(QString::fromStdString(CStatsManager::GetInstance().GetProfilingInfo()));
 #endif
-	m_fpsLabel->setText(QString("%1%2 f/s, %3 dc/f").arg(frames).arg(unlockedFps ? " (U)" : "").arg(dcpf));
+	auto fpsText = QString("%1%2 f/s, %3 dc/f").arg(frames).arg(unlockedFps ? " (U)" : "").arg(dcpf);
+	if(frameSkipStats.skippedFrames != 0)
+	{
+		fpsText += QString(", %1 skipped").arg(frameSkipStats.skippedFrames);
+	}
+	if(inputLatencyStats.eventCount != 0)
+	{
+		double avgLatencyMs = static_cast<double>(inputLatencyStats.totalLatency) / static_cast<double>(inputLatencyStats.eventCount * 1000);
+		fpsText += QString(", %1 ms input").arg(avgLatencyMs, 0, 'f', 1);
+	}
+	{
+		uint64 ioRequestCount = 0;
+		uint64 ioTotalLatency = 0;
+		for(const auto& deviceStatsPair : asyncIoStats)
+		{
+			ioRequestCount += deviceStatsPair.second.readCount + deviceStatsPair.second.writeCount;
+			ioTotalLatency += deviceStatsPair.second.totalLatency;
+		}
+		if(ioRequestCount != 0)
+		{
+			double avgLatencyMs = static_cast<double>(ioTotalLatency) / static_cast<double>(ioRequestCount * 1000);
+			fpsText += QString(", %1 ms I/O").arg(avgLatencyMs, 0, 'f', 1);
+		}
+	}
+	if((gsImageStagingStats.byteCount != 0) && (frames != 0))
+	{
+		double avgKbPerFrame = static_cast<double>(gsImageStagingStats.byteCount) / static_cast<double>(frames * 1024);
+		fpsText += QString(", %1 KB/f GS uploads").arg(avgKbPerFrame, 0, 'f', 1);
+	}
+	{
+		//Reply latencies are in EE cycles, only report the slowest server
+		uint64 maxReplyLatency = 0;
+		for(const auto& serverStatsPair : sifRpcServerStats)
+		{
+			maxReplyLatency = std::max(maxReplyLatency, serverStatsPair.second.maxReplyLatency);
+		}
+		if(maxReplyLatency != 0)
+		{
+			double maxLatencyMs = static_cast<double>(maxReplyLatency) * 1000.0 / static_cast<double>(PS2::EE_CLOCK_FREQ);
+			fpsText += QString(", %1 ms SIF").arg(maxLatencyMs, 0, 'f', 1);
+		}
+	}
+	m_fpsLabel->setText(fpsText);
 
 	auto eeUsageRatio = CStatsManager::ComputeCpuUsageRatio(cpuUtilisation.eeIdleTicks, cpuUtilisation.eeTotalTicks);
 	m_cpuUsageLabel->setText(QString("EE CPU: %1%").arg(static_cast<int>(eeUsageRatio)));
@@ -666,6 +723,29 @@ void MainWindow::SetupSaveLoadStateSlots()
 	}
 }
 
+#ifdef PROFILE
+
+void MainWindow::captureTrace(uint32 frameCount)
+{
+	auto traceFileName = QString("trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+	auto traceFilePath = CPS2VM::GetTraceDirectoryPath() / QStringToPath(traceFileName);
+	auto future = m_virtualMachine->CaptureTrace(traceFilePath, frameCount);
+	m_msgLabel->setText(QString("Capturing trace for %1 frames...").arg(frameCount));
+	m_continuationChecker->GetContinuationManager().Register(std::move(future),
+	                                                         [this, traceFileName](const bool& succeeded) {
+		                                                         if(succeeded)
+		                                                         {
+			                                                         m_msgLabel->setText(QString("Saved trace to '%1'.").arg(traceFileName));
+		                                                         }
+		                                                         else
+		                                                         {
+			                                                         m_msgLabel->setText(QString("Error capturing trace."));
+		                                                         }
+	                                                         });
+}
+
+#endif
+
 void MainWindow::saveState(int stateSlot)
 {
 	auto stateFilePath = m_virtualMachine->GenerateStatePath(stateSlot);
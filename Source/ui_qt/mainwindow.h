@@ -89,6 +89,9 @@ private:
 	void UpdateCpuUsageLabel();
 	void RegisterPreferences();
 	void saveState(int);
+#ifdef PROFILE
+	void captureTrace(uint32);
+#endif
 	void buildResizeWindowMenu();
 	void resizeWindow(unsigned int, unsigned int);
 	void UpdateGSHandlerLabel();
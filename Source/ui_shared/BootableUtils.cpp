@@ -37,23 +37,14 @@ BootableUtils::BOOTABLE_TYPE BootableUtils::GetBootableType(const fs::path& file
 
 	if(BootableUtils::IsBootableDiscImagePath(filePath))
 	{
-		try
+		DiskUtils::SystemConfigMap systemConfig;
+		if(DiskUtils::TryGetSystemConfig(filePath, &systemConfig))
 		{
-			auto opticalMedia = DiskUtils::CreateOpticalMediaFromPath(filePath, COpticalMedia::CREATE_AUTO_DISABLE_DL_DETECT);
-			auto fileSystem = opticalMedia->GetFileSystem();
-			auto systemConfigFile = std::unique_ptr<Framework::CStream>(fileSystem->Open("SYSTEM.CNF;1"));
-			if(!systemConfigFile) return BootableUtils::BOOTABLE_TYPE::UNKNOWN;
-
-			auto systemConfig = DiskUtils::ParseSystemConfigFile(systemConfigFile.get());
-
 			if(auto bootItemIterator = systemConfig.find("BOOT2"); bootItemIterator != std::end(systemConfig))
 			{
 				return BootableUtils::BOOTABLE_TYPE::PS2_DISC;
 			}
 		}
-		catch(const std::exception&)
-		{
-		}
 	}
 	return BootableUtils::BOOTABLE_TYPE::UNKNOWN;
 }
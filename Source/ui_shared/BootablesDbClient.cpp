@@ -7,7 +7,7 @@
 
 using namespace BootablesDb;
 
-#define DATABASE_VERSION 3
+#define DATABASE_VERSION 4
 
 static const char* g_dbFileName = "bootables.db";
 
@@ -20,7 +20,9 @@ static const char* g_bootablesTableCreateStatement =
     "    coverUrl TEXT DEFAULT '',"
     "    lastBootedTime INTEGER DEFAULT 0,"
     "    overview TEXT DEFAULT '',"
-    "    bootableType INTEGER DEFAULT 0"
+    "    bootableType INTEGER DEFAULT 0,"
+    "    fileSize INTEGER DEFAULT 0,"
+    "    fileTime INTEGER DEFAULT 0"
     ")";
 
 CClient::CClient()
@@ -111,6 +113,58 @@ void CClient::RegisterBootable(const fs::path& path, const char* title, const ch
 	statement.StepNoResult();
 }
 
+//Registers new bootables and updates existing ones in a single transaction
+void CClient::RegisterBootables(const BootableRegistrationList& registrations)
+{
+	if(registrations.empty()) return;
+
+	{
+		Framework::CSqliteStatement statement(m_db, "BEGIN TRANSACTION");
+		statement.StepNoResult();
+	}
+
+	try
+	{
+		Framework::CSqliteStatement insertStatement(m_db, "INSERT OR IGNORE INTO bootables (path, title, discId, bootableType, fileSize, fileTime) VALUES (?,?,?,?,?,?)");
+		Framework::CSqliteStatement updateStatement(m_db, "UPDATE bootables SET discId = ?, bootableType = ?, fileSize = ?, fileTime = ? WHERE path = ?");
+		for(const auto& registration : registrations)
+		{
+			auto path = Framework::PathUtils::GetNativeStringFromPath(registration.path);
+
+			sqlite3_reset(insertStatement);
+			insertStatement.BindText(1, path.c_str(), true);
+			insertStatement.BindText(2, registration.title.c_str(), true);
+			insertStatement.BindText(3, registration.discId.c_str(), true);
+			insertStatement.BindInteger(4, registration.bootableType);
+			sqlite3_bind_int64(insertStatement, 5, registration.fileInfo.fileSize);
+			sqlite3_bind_int64(insertStatement, 6, registration.fileInfo.fileTime);
+			insertStatement.StepNoResult();
+
+			if(sqlite3_changes(m_db) != 0) continue;
+
+			//Already registered, file changed since last scan
+			sqlite3_reset(updateStatement);
+			updateStatement.BindText(1, registration.discId.c_str(), true);
+			updateStatement.BindInteger(2, registration.bootableType);
+			sqlite3_bind_int64(updateStatement, 3, registration.fileInfo.fileSize);
+			sqlite3_bind_int64(updateStatement, 4, registration.fileInfo.fileTime);
+			updateStatement.BindText(5, path.c_str(), true);
+			updateStatement.StepNoResult();
+		}
+	}
+	catch(...)
+	{
+		Framework::CSqliteStatement statement(m_db, "ROLLBACK");
+		statement.StepNoResult();
+		throw;
+	}
+
+	{
+		Framework::CSqliteStatement statement(m_db, "COMMIT");
+		statement.StepNoResult();
+	}
+}
+
 void CClient::UnregisterBootable(const fs::path& path)
 {
 	Framework::CSqliteStatement statement(m_db, "DELETE FROM bootables WHERE path = ?");
@@ -180,6 +234,21 @@ BootableStateList CClient::GetGameStates(std::string discId)
 	return states;
 }
 
+BootableFileInfoMap CClient::GetBootableFileInfos()
+{
+	BootableFileInfoMap fileInfos;
+	Framework::CSqliteStatement statement(m_db, "SELECT path, fileSize, fileTime FROM bootables");
+	while(statement.Step())
+	{
+		auto path = Framework::PathUtils::GetPathFromNativeString(reinterpret_cast<const char*>(sqlite3_column_text(statement, 0)));
+		BootableFileInfo fileInfo;
+		fileInfo.fileSize = sqlite3_column_int64(statement, 1);
+		fileInfo.fileTime = sqlite3_column_int64(statement, 2);
+		fileInfos.emplace(std::move(path), fileInfo);
+	}
+	return fileInfos;
+}
+
 BootableStateList CClient::GetStates()
 {
 	BootableStateList states;
@@ -210,6 +279,8 @@ Bootable CClient::ReadBootable(Framework::CSqliteStatement& statement)
 	bootable.lastBootedTime = sqlite3_column_int(statement, 4);
 	bootable.states = GetGameStates(bootable.discId);
 	bootable.bootableType = static_cast<BootableUtils::BOOTABLE_TYPE>(sqlite3_column_int(statement, 6));
+	bootable.fileSize = sqlite3_column_int64(statement, 7);
+	bootable.fileTime = sqlite3_column_int64(statement, 8);
 	return bootable;
 }
 
@@ -251,6 +322,20 @@ void CClient::UpgradeDb()
 				currentVersion = 3;
 			}
 			break;
+			case 3:
+			{
+				{
+					Framework::CSqliteStatement statement(db, "ALTER TABLE bootables ADD COLUMN fileSize INTEGER DEFAULT 0");
+					statement.StepNoResult();
+				}
+				{
+					Framework::CSqliteStatement statement(db, "ALTER TABLE bootables ADD COLUMN fileTime INTEGER DEFAULT 0");
+					statement.StepNoResult();
+				}
+
+				currentVersion = 4;
+			}
+			break;
 			default:
 				fs::remove(m_dbPath);
 				return;
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include "filesystem_def.h"
 #include "Types.h"
 #include "Singleton.h"
@@ -28,8 +29,28 @@ namespace BootablesDb
 		time_t lastBootedTime = 0;
 		BootableStateList states;
 		BootableUtils::BOOTABLE_TYPE bootableType = BootableUtils::UNKNOWN;
+		uint64 fileSize = 0;
+		int64 fileTime = 0;
 	};
 
+	//Used to detect files that changed since they were last scanned
+	struct BootableFileInfo
+	{
+		uint64 fileSize = 0;
+		int64 fileTime = 0;
+	};
+	using BootableFileInfoMap = std::map<fs::path, BootableFileInfo>;
+
+	struct BootableRegistration
+	{
+		fs::path path;
+		std::string title;
+		std::string discId;
+		BootableUtils::BOOTABLE_TYPE bootableType = BootableUtils::UNKNOWN;
+		BootableFileInfo fileInfo;
+	};
+	using BootableRegistrationList = std::vector<BootableRegistration>;
+
 	class CClient : public CSingleton<CClient>
 	{
 	public:
@@ -49,8 +70,10 @@ namespace BootablesDb
 		Bootable GetBootable(const fs::path&);
 		std::vector<Bootable> GetBootables(int32_t = SORT_METHOD_NONE);
 		BootableStateList GetStates();
+		BootableFileInfoMap GetBootableFileInfos();
 
 		void RegisterBootable(const fs::path&, const char*, const char*, BootableUtils::BOOTABLE_TYPE);
+		void RegisterBootables(const BootableRegistrationList&);
 		void UnregisterBootable(const fs::path&);
 
 		void SetDiscId(const fs::path&, const char*);
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <thread>
 #include "AppConfig.h"
 #include "BootablesProcesses.h"
 #include "BootablesDbClient.h"
@@ -9,6 +10,7 @@
 #include "StringUtils.h"
 #include "string_format.h"
 #include "StdStreamUtils.h"
+#include "ThreadPool.h"
 #include "http/HttpClientFactory.h"
 #ifdef __ANDROID__
 #include "android/ContentUtils.h"
@@ -22,6 +24,9 @@
 
 //#define SCAN_LOG
 
+//Disc images are probed in parallel, mostly waiting on I/O
+#define SCAN_MAX_THREAD_COUNT 8
+
 static void BootableLog(const char* format, ...)
 {
 #ifdef SCAN_LOG
@@ -54,6 +59,50 @@ bool DoesBootableExist(const fs::path& filePath)
 	return fs::exists(filePath);
 }
 
+//Only looks at the extension, disc images still need to be probed
+static BootableUtils::BOOTABLE_TYPE GetBootableTypeFromPath(const fs::path& path)
+{
+	auto extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	if(extension == ".elf") return BootableUtils::PS2_ELF;
+	if(extension == ".arcadedef") return BootableUtils::PS2_ARCADE;
+	if(BootableUtils::IsBootableDiscImagePath(path)) return BootableUtils::PS2_DISC;
+	return BootableUtils::UNKNOWN;
+}
+
+static BootablesDb::BootableFileInfo GetBootableFileInfo(const fs::path& path)
+{
+	BootablesDb::BootableFileInfo fileInfo;
+	std::error_code errorCode;
+	auto fileSize = fs::file_size(path, errorCode);
+	if(!errorCode)
+	{
+		fileInfo.fileSize = fileSize;
+	}
+	auto fileTime = fs::last_write_time(path, errorCode);
+	if(!errorCode)
+	{
+		fileInfo.fileTime = fileTime.time_since_epoch().count();
+	}
+	return fileInfo;
+}
+
+static bool TryProbeBootable(BootablesDb::BootableRegistration& registration)
+{
+	try
+	{
+		if(registration.bootableType == BootableUtils::PS2_DISC)
+		{
+			return DiskUtils::TryGetDiskId(registration.path, &registration.discId);
+		}
+		return true;
+	}
+	catch(...)
+	{
+		return false;
+	}
+}
+
 bool TryRegisterBootable(const fs::path& path)
 {
 	try
@@ -63,16 +112,18 @@ bool TryRegisterBootable(const fs::path& path)
 			return false;
 		}
 
-		auto bootableType = BootableUtils::GetBootableType(path);
-		if(bootableType == BootableUtils::UNKNOWN)
+		BootablesDb::BootableRegistration registration;
+		registration.path = path;
+		registration.title = path.filename().string();
+		registration.bootableType = GetBootableTypeFromPath(path);
+		registration.fileInfo = GetBootableFileInfo(path);
+		if(registration.bootableType == BootableUtils::UNKNOWN)
 			return false;
 
-		std::string serial;
-		if(bootableType == BootableUtils::PS2_DISC)
-			if(!DiskUtils::TryGetDiskId(path, &serial))
-				return false;
+		if(!TryProbeBootable(registration))
+			return false;
 
-		BootablesDb::CClient::GetInstance().RegisterBootable(path, path.filename().string().c_str(), serial.c_str(), bootableType);
+		BootablesDb::CClient::GetInstance().RegisterBootables({registration});
 		return true;
 	}
 	catch(...)
@@ -94,10 +145,8 @@ bool TryUpdateLastBootedTime(const fs::path& path)
 	}
 }
 
-void ScanBootables(const fs::path& parentPath, bool recursive)
+static void CollectBootablePaths(const fs::path& parentPath, bool recursive, std::vector<fs::path>& paths)
 {
-	BootableLog("Entering ScanBootables(path = '%s', recursive = %d);\r\n",
-	            parentPath.string().c_str(), static_cast<int>(recursive));
 	try
 	{
 		std::error_code ec;
@@ -116,12 +165,16 @@ void ScanBootables(const fs::path& parentPath, bool recursive)
 				if(recursive && fs::is_directory(path))
 				{
 					BootableLog("is directory.\r\n");
-					ScanBootables(path, recursive);
+					CollectBootablePaths(path, recursive, paths);
+					continue;
+				}
+				if(GetBootableTypeFromPath(path) == BootableUtils::UNKNOWN)
+				{
+					BootableLog("not bootable.\r\n");
 					continue;
 				}
-				BootableLog("registering... ");
-				bool success = TryRegisterBootable(path);
-				BootableLog("result = %d\r\n", static_cast<int>(success));
+				BootableLog("candidate.\r\n");
+				paths.push_back(path);
 			}
 			catch(const std::exception& exception)
 			{
@@ -134,6 +187,75 @@ void ScanBootables(const fs::path& parentPath, bool recursive)
 	{
 		BootableLog("Caught an exception while trying to list directory: %s\r\n", exception.what());
 	}
+}
+
+void ScanBootables(const fs::path& parentPath, bool recursive)
+{
+	BootableLog("Entering ScanBootables(path = '%s', recursive = %d);\r\n",
+	            parentPath.string().c_str(), static_cast<int>(recursive));
+
+	std::vector<fs::path> paths;
+	CollectBootablePaths(parentPath, recursive, paths);
+
+	//Skip files that didn't change since they were last registered
+	BootablesDb::BootableRegistrationList registrations;
+	{
+		auto knownFileInfos = BootablesDb::CClient::GetInstance().GetBootableFileInfos();
+		for(const auto& path : paths)
+		{
+			BootablesDb::BootableRegistration registration;
+			registration.path = path;
+			registration.title = path.filename().string();
+			registration.bootableType = GetBootableTypeFromPath(path);
+			registration.fileInfo = GetBootableFileInfo(path);
+			auto knownFileInfoIterator = knownFileInfos.find(path);
+			if(knownFileInfoIterator != std::end(knownFileInfos))
+			{
+				const auto& knownFileInfo = knownFileInfoIterator->second;
+				if(
+				    (knownFileInfo.fileSize == registration.fileInfo.fileSize) &&
+				    (knownFileInfo.fileTime == registration.fileInfo.fileTime))
+				{
+					continue;
+				}
+			}
+			registrations.push_back(std::move(registration));
+		}
+	}
+
+	BootableLog("Probing %d bootables (%d found).\r\n", registrations.size(), paths.size());
+
+	//Not using vector<bool> since results are written from multiple threads
+	std::vector<uint8> probeResults(registrations.size(), false);
+	{
+		unsigned int threadCount = std::clamp<unsigned int>(std::thread::hardware_concurrency(), 1, SCAN_MAX_THREAD_COUNT);
+		Framework::CThreadPool threadPool(threadCount);
+		for(size_t i = 0; i < registrations.size(); i++)
+		{
+			threadPool.Enqueue(
+			    [&registrations, &probeResults, i]() {
+				    probeResults[i] = TryProbeBootable(registrations[i]);
+			    });
+		}
+	}
+
+	BootablesDb::BootableRegistrationList validRegistrations;
+	for(size_t i = 0; i < registrations.size(); i++)
+	{
+		BootableLog("Probed '%s', result = %d\r\n", registrations[i].path.string().c_str(), static_cast<int>(probeResults[i]));
+		if(!probeResults[i]) continue;
+		validRegistrations.push_back(std::move(registrations[i]));
+	}
+
+	try
+	{
+		BootablesDb::CClient::GetInstance().RegisterBootables(validRegistrations);
+	}
+	catch(const std::exception& exception)
+	{
+		BootableLog("Caught an exception while trying to register bootables: %s\r\n", exception.what());
+	}
+
 	BootableLog("Exiting ScanBootables(path = '%s', recursive = %d);\r\n",
 	            parentPath.string().c_str(), static_cast<int>(recursive));
 }
@@ -1,4 +1,5 @@
 
+#include <cmath>
 #include "StatsManager.h"
 #include "string_format.h"
 #include "PS2VM.h"
@@ -12,6 +13,66 @@ void CStatsManager::OnNewFrame(CPS2VM* virtualMachine)
 		m_cpuUtilisation.eeIdleTicks += cpuUtilisation.eeIdleTicks;
 		m_cpuUtilisation.iopTotalTicks += cpuUtilisation.iopTotalTicks;
 		m_cpuUtilisation.iopIdleTicks += cpuUtilisation.iopIdleTicks;
+
+		auto schedulerStats = virtualMachine->GetSchedulerStats();
+		m_schedulerStats.sliceCount += schedulerStats.sliceCount;
+		m_schedulerStats.sliceTicks += schedulerStats.sliceTicks;
+		m_schedulerStats.maxSliceTicks = std::max(m_schedulerStats.maxSliceTicks, schedulerStats.maxSliceTicks);
+		m_schedulerStats.sifSyncCount += schedulerStats.sifSyncCount;
+
+		auto frameSkipStats = virtualMachine->GetFrameSkipStats();
+		m_frameSkipStats.renderedFrames += frameSkipStats.renderedFrames;
+		m_frameSkipStats.skippedFrames += frameSkipStats.skippedFrames;
+
+		auto framePacingStats = virtualMachine->GetFramePacingStats();
+		m_framePacingStats.frameCount += framePacingStats.frameCount;
+		m_framePacingStats.lateFrameCount += framePacingStats.lateFrameCount;
+		m_framePacingStats.intervalErrorSum += framePacingStats.intervalErrorSum;
+		m_framePacingStats.intervalErrorSquaredSum += framePacingStats.intervalErrorSquaredSum;
+		m_framePacingStats.maxIntervalError = std::max(m_framePacingStats.maxIntervalError, framePacingStats.maxIntervalError);
+		m_framePacingStats.maxDeadlineError = std::max(m_framePacingStats.maxDeadlineError, framePacingStats.maxDeadlineError);
+
+		auto inputLatencyStats = virtualMachine->GetInputLatencyStats();
+		m_inputLatencyStats.eventCount += inputLatencyStats.eventCount;
+		m_inputLatencyStats.totalLatency += inputLatencyStats.totalLatency;
+		m_inputLatencyStats.maxLatency = std::max(m_inputLatencyStats.maxLatency, inputLatencyStats.maxLatency);
+
+		auto gsImageStagingStats = virtualMachine->GetGsImageStagingStats();
+		m_gsImageStagingStats.allocationCount += gsImageStagingStats.allocationCount;
+		m_gsImageStagingStats.chunkAllocationCount += gsImageStagingStats.chunkAllocationCount;
+		m_gsImageStagingStats.chunkReuseCount += gsImageStagingStats.chunkReuseCount;
+		m_gsImageStagingStats.byteCount += gsImageStagingStats.byteCount;
+
+		for(const auto& serverStatsPair : virtualMachine->GetSifRpcServerStats())
+		{
+			const auto& serverStats = serverStatsPair.second;
+			auto& stats = m_sifRpcServerStats[serverStatsPair.first];
+			stats.callCount += serverStats.callCount;
+			stats.deferredReplyCount += serverStats.deferredReplyCount;
+			stats.totalReplyLatency += serverStats.totalReplyLatency;
+			stats.maxReplyLatency = std::max(stats.maxReplyLatency, serverStats.maxReplyLatency);
+		}
+
+		auto vuProgramCacheStats = virtualMachine->GetVuProgramCacheStats();
+		m_vuProgramCacheStats.programHits += vuProgramCacheStats.programHits;
+		m_vuProgramCacheStats.programMisses += vuProgramCacheStats.programMisses;
+		m_vuProgramCacheStats.blockHits += vuProgramCacheStats.blockHits;
+		m_vuProgramCacheStats.blockCompiles += vuProgramCacheStats.blockCompiles;
+
+		for(const auto& deviceStatsPair : virtualMachine->GetAsyncIoStats())
+		{
+			const auto& deviceStats = deviceStatsPair.second;
+			auto& stats = m_asyncIoStats[deviceStatsPair.first];
+			stats.readCount += deviceStats.readCount;
+			stats.writeCount += deviceStats.writeCount;
+			stats.byteCount += deviceStats.byteCount;
+			stats.totalLatency += deviceStats.totalLatency;
+			stats.maxLatency = std::max(stats.maxLatency, deviceStats.maxLatency);
+			for(uint32 i = 0; i < Iop::Ioman::CAsyncIoEngine::LATENCY_BUCKET_COUNT; i++)
+			{
+				stats.latencyHistogram[i] += deviceStats.latencyHistogram[i];
+			}
+		}
 	}
 
 #ifdef PROFILE
@@ -20,6 +81,8 @@ void CStatsManager::OnNewFrame(CPS2VM* virtualMachine)
 	auto zones = CProfiler::GetInstance().GetStats();
 	for(auto& zone : zones)
 	{
+		//Zones only used for tracing (ie.: on other threads) never accumulate time
+		if((zone.totalTime == 0) && (m_profilerZones.find(zone.name) == std::end(m_profilerZones))) continue;
 		auto& zoneInfo = m_profilerZones[zone.name];
 		zoneInfo.currentValue += zone.totalTime;
 		if(zone.totalTime != 0)
@@ -64,6 +127,54 @@ CPS2VM::CPU_UTILISATION_INFO CStatsManager::GetCpuUtilisationInfo()
 	return m_cpuUtilisation;
 }
 
+CPS2VM::SCHEDULER_STATS CStatsManager::GetSchedulerStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_schedulerStats;
+}
+
+CPS2VM::FRAME_SKIP_STATS CStatsManager::GetFrameSkipStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_frameSkipStats;
+}
+
+CFrameLimiter::PACING_STATS CStatsManager::GetFramePacingStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_framePacingStats;
+}
+
+CPadHandler::INPUT_LATENCY_STATS CStatsManager::GetInputLatencyStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_inputLatencyStats;
+}
+
+CGsStagingArena::STATS CStatsManager::GetGsImageStagingStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_gsImageStagingStats;
+}
+
+CSIF::RpcServerStatsMap CStatsManager::GetSifRpcServerStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_sifRpcServerStats;
+}
+
+CVuExecutor::PROGRAM_CACHE_STATS CStatsManager::GetVuProgramCacheStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_vuProgramCacheStats;
+}
+
+Iop::Ioman::CAsyncIoEngine::DeviceStatsMap CStatsManager::GetAsyncIoStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_asyncIoStats;
+}
+
 #ifdef PROFILE
 
 std::string CStatsManager::GetProfilingInfo()
@@ -107,6 +218,86 @@ std::string CStatsManager::GetProfilingInfo()
 		result += string_format("IOP Usage: %6.2f%%\r\n", iopUsageRatio);
 	}
 
+	if(m_schedulerStats.sliceCount != 0)
+	{
+		float avgSliceTicks = static_cast<float>(m_schedulerStats.sliceTicks) / static_cast<float>(m_schedulerStats.sliceCount);
+		float avgSlicesPerFrame = (m_frames != 0) ? static_cast<float>(m_schedulerStats.sliceCount) / static_cast<float>(m_frames) : 0;
+		float avgSifSyncsPerFrame = (m_frames != 0) ? static_cast<float>(m_schedulerStats.sifSyncCount) / static_cast<float>(m_frames) : 0;
+
+		result += string_format("Slices:    %6.2f/frame (avg %d ticks, max %d ticks)\r\n", avgSlicesPerFrame, static_cast<int>(avgSliceTicks), m_schedulerStats.maxSliceTicks);
+		result += string_format("SIF Syncs: %6.2f/frame\r\n", avgSifSyncsPerFrame);
+	}
+
+	if(int32 skipperFrames = m_frameSkipStats.renderedFrames + m_frameSkipStats.skippedFrames; skipperFrames != 0)
+	{
+		float skippedRatio = static_cast<float>(m_frameSkipStats.skippedFrames) / static_cast<float>(skipperFrames);
+		result += string_format("Frameskip: %6.2f%% (%d skipped, %d rendered)\r\n", skippedRatio * 100.f, m_frameSkipStats.skippedFrames, m_frameSkipStats.renderedFrames);
+	}
+
+	if(m_framePacingStats.frameCount != 0)
+	{
+		double frameCount = static_cast<double>(m_framePacingStats.frameCount);
+		double meanIntervalError = static_cast<double>(m_framePacingStats.intervalErrorSum) / frameCount;
+		double intervalErrorVariance = (static_cast<double>(m_framePacingStats.intervalErrorSquaredSum) / frameCount) - (meanIntervalError * meanIntervalError);
+		float intervalJitter = static_cast<float>(sqrt(std::max(intervalErrorVariance, 0.0)));
+
+		result += string_format("Pacing:    %6.2fus jitter (max %dus, %d late)\r\n", intervalJitter,
+		                        static_cast<int>(m_framePacingStats.maxIntervalError), m_framePacingStats.lateFrameCount);
+	}
+
+	if(m_inputLatencyStats.eventCount != 0)
+	{
+		float avgLatencyMs = static_cast<float>(m_inputLatencyStats.totalLatency) / static_cast<float>(m_inputLatencyStats.eventCount * 1000);
+		float maxLatencyMs = static_cast<float>(m_inputLatencyStats.maxLatency) / 1000.f;
+		result += string_format("Input:     %6.2fms latency (max %6.2fms)\r\n", avgLatencyMs, maxLatencyMs);
+	}
+
+	if(m_gsImageStagingStats.allocationCount != 0)
+	{
+		float avgKbPerFrame = (m_frames != 0) ? static_cast<float>(m_gsImageStagingStats.byteCount) / static_cast<float>(m_frames * 1024) : 0;
+		float avgTransfersPerFrame = (m_frames != 0) ? static_cast<float>(m_gsImageStagingStats.allocationCount) / static_cast<float>(m_frames) : 0;
+
+		result += string_format("GS Images: %6.2fKB/frame (%6.2f xfers/frame, %d chunks allocated, %d reused)\r\n", avgKbPerFrame, avgTransfersPerFrame,
+		                        m_gsImageStagingStats.chunkAllocationCount, m_gsImageStagingStats.chunkReuseCount);
+	}
+
+	for(const auto& serverStatsPair : m_sifRpcServerStats)
+	{
+		const auto& serverStats = serverStatsPair.second;
+		//Latencies are in EE cycles
+		static const double cyclesPerMs = static_cast<double>(PS2::EE_CLOCK_FREQ) / 1000.0;
+		float avgCallsPerFrame = (m_frames != 0) ? static_cast<float>(serverStats.callCount) / static_cast<float>(m_frames) : 0;
+		float avgLatencyMs = (serverStats.deferredReplyCount != 0) ? static_cast<float>(static_cast<double>(serverStats.totalReplyLatency) / (serverStats.deferredReplyCount * cyclesPerMs)) : 0;
+		float maxLatencyMs = static_cast<float>(static_cast<double>(serverStats.maxReplyLatency) / cyclesPerMs);
+
+		result += string_format("SIF %08X: %6.2f calls/frame (%d deferred, avg %6.2fms, max %6.2fms)\r\n", serverStatsPair.first,
+		                        avgCallsPerFrame, serverStats.deferredReplyCount, avgLatencyMs, maxLatencyMs);
+	}
+
+	if(int32 programLookups = m_vuProgramCacheStats.programHits + m_vuProgramCacheStats.programMisses; programLookups != 0)
+	{
+		float programHitRatio = static_cast<float>(m_vuProgramCacheStats.programHits) / static_cast<float>(programLookups);
+		float avgProgramLookupsPerFrame = (m_frames != 0) ? static_cast<float>(programLookups) / static_cast<float>(m_frames) : 0;
+		float avgBlockCompilesPerFrame = (m_frames != 0) ? static_cast<float>(m_vuProgramCacheStats.blockCompiles) / static_cast<float>(m_frames) : 0;
+
+		result += string_format("VU Progs:  %6.2f/frame (%6.2f%% hits)\r\n", avgProgramLookupsPerFrame, programHitRatio * 100.f);
+		result += string_format("VU Blocks: %6.2f compiled/frame (%d reused)\r\n", avgBlockCompilesPerFrame, m_vuProgramCacheStats.blockHits);
+	}
+
+	for(const auto& deviceStatsPair : m_asyncIoStats)
+	{
+		const auto& deviceStats = deviceStatsPair.second;
+		uint64 requestCount = deviceStats.readCount + deviceStats.writeCount;
+		if(requestCount == 0) continue;
+		//Latencies are in microseconds
+		float avgKbPerFrame = (m_frames != 0) ? static_cast<float>(deviceStats.byteCount) / static_cast<float>(m_frames * 1024) : 0;
+		float avgLatencyMs = static_cast<float>(deviceStats.totalLatency) / static_cast<float>(requestCount * 1000);
+		float maxLatencyMs = static_cast<float>(deviceStats.maxLatency) / 1000.f;
+
+		result += string_format("IO %-6s: %6.2fKB/frame (%d reads, %d writes, avg %6.2fms, max %6.2fms)\r\n", deviceStatsPair.first.c_str(), avgKbPerFrame,
+		                        static_cast<int>(deviceStats.readCount), static_cast<int>(deviceStats.writeCount), avgLatencyMs, maxLatencyMs);
+	}
+
 	return result;
 }
 
@@ -118,6 +309,14 @@ void CStatsManager::ClearStats()
 	m_frames = 0;
 	m_drawCalls = 0;
 	m_cpuUtilisation = CPS2VM::CPU_UTILISATION_INFO();
+	m_schedulerStats = CPS2VM::SCHEDULER_STATS();
+	m_frameSkipStats = CPS2VM::FRAME_SKIP_STATS();
+	m_framePacingStats = CFrameLimiter::PACING_STATS();
+	m_inputLatencyStats = CPadHandler::INPUT_LATENCY_STATS();
+	m_gsImageStagingStats = CGsStagingArena::STATS();
+	m_sifRpcServerStats.clear();
+	m_vuProgramCacheStats = CVuExecutor::PROGRAM_CACHE_STATS();
+	m_asyncIoStats.clear();
 #ifdef PROFILE
 	for(auto& zonePair : m_profilerZones)
 	{
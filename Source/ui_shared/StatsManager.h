@@ -18,6 +18,14 @@ public:
 	uint32 GetFrames();
 	uint32 GetDrawCalls();
 	CPS2VM::CPU_UTILISATION_INFO GetCpuUtilisationInfo();
+	CPS2VM::SCHEDULER_STATS GetSchedulerStats();
+	CPS2VM::FRAME_SKIP_STATS GetFrameSkipStats();
+	CFrameLimiter::PACING_STATS GetFramePacingStats();
+	CPadHandler::INPUT_LATENCY_STATS GetInputLatencyStats();
+	CGsStagingArena::STATS GetGsImageStagingStats();
+	CSIF::RpcServerStatsMap GetSifRpcServerStats();
+	CVuExecutor::PROGRAM_CACHE_STATS GetVuProgramCacheStats();
+	Iop::Ioman::CAsyncIoEngine::DeviceStatsMap GetAsyncIoStats();
 #ifdef PROFILE
 	std::string GetProfilingInfo();
 #endif
@@ -31,6 +39,14 @@ private:
 	uint32 m_drawCalls = 0;
 
 	CPS2VM::CPU_UTILISATION_INFO m_cpuUtilisation;
+	CPS2VM::SCHEDULER_STATS m_schedulerStats;
+	CPS2VM::FRAME_SKIP_STATS m_frameSkipStats;
+	CFrameLimiter::PACING_STATS m_framePacingStats;
+	CPadHandler::INPUT_LATENCY_STATS m_inputLatencyStats;
+	CGsStagingArena::STATS m_gsImageStagingStats;
+	CSIF::RpcServerStatsMap m_sifRpcServerStats;
+	CVuExecutor::PROGRAM_CACHE_STATS m_vuProgramCacheStats;
+	Iop::Ioman::CAsyncIoEngine::DeviceStatsMap m_asyncIoStats;
 
 #ifdef PROFILE
 	struct ZONEINFO
@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "PS2VM.h"
+#include "PS2VM_Preferences.h"
+#include "AppConfig.h"
+#include "PH_InputReplay.h"
+#include "StdStreamUtils.h"
+#include "filesystem_def.h"
+#include "ee/PS2OS.h"
+#include "gs/GSH_Null.h"
+#include "iop/Iop_Ioman.h"
+
+//Runs a game for a fixed number of frames from a saved state, replaying recorded inputs,
+//and reports frame time statistics as JSON. Meant to be used to catch performance regressions.
+
+#define DEFAULT_FRAME_COUNT 1800
+#define DEFAULT_TIMEOUT 600
+
+struct BENCHMARK_OPTIONS
+{
+	fs::path executablePath;
+	fs::path discPath;
+	fs::path statePath;
+	fs::path inputPath;
+	fs::path outputPath;
+	fs::path blockStatsPath;
+	fs::path idleLoopsPath;
+	uint32 frameCount = DEFAULT_FRAME_COUNT;
+	uint32 timeout = DEFAULT_TIMEOUT;
+	double maxP95FrameTime = 0;
+};
+
+static double ToMilliseconds(uint64 time)
+{
+	return static_cast<double>(time) / 1000000.0;
+}
+
+//Nearest-rank percentile, values must be sorted
+static uint64 GetPercentile(const std::vector<uint64>& values, double percentile)
+{
+	assert(!values.empty());
+	size_t rank = static_cast<size_t>(std::ceil((percentile / 100.0) * values.size()));
+	rank = std::clamp<size_t>(rank, 1, values.size());
+	return values[rank - 1];
+}
+
+static std::string EscapeJsonString(const std::string& input)
+{
+	std::string result;
+	for(auto character : input)
+	{
+		switch(character)
+		{
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		default:
+			if(static_cast<uint8>(character) < 0x20)
+			{
+				char escapedCharacter[8];
+				snprintf(escapedCharacter, sizeof(escapedCharacter), "\\u%04x", character);
+				result += escapedCharacter;
+			}
+			else
+			{
+				result += character;
+			}
+			break;
+		}
+	}
+	return result;
+}
+
+static void WriteReport(FILE* output, const BENCHMARK_OPTIONS& options, const CPS2VM::BenchmarkFrameArray& frames, double& p95FrameTime)
+{
+	std::vector<uint64> frameTimes;
+	frameTimes.reserve(frames.size());
+	CPS2VM::BENCHMARK_FRAME totals;
+	for(const auto& frame : frames)
+	{
+		frameTimes.push_back(frame.frameTime);
+		totals.frameTime += frame.frameTime;
+		totals.eeTime += frame.eeTime;
+		totals.iopTime += frame.iopTime;
+		totals.vuTime += frame.vuTime;
+		totals.gsSyncTime += frame.gsSyncTime;
+		totals.spuTime += frame.spuTime;
+		totals.jitTime += frame.jitTime;
+	}
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	double totalTime = ToMilliseconds(totals.frameTime);
+	double frameCount = static_cast<double>(frames.size());
+	p95FrameTime = ToMilliseconds(GetPercentile(frameTimes, 95));
+
+	auto bootPath = options.discPath.empty() ? options.executablePath : options.discPath;
+
+	fprintf(output, "{\n");
+	fprintf(output, "\t\"boot\": \"%s\",\n", EscapeJsonString(bootPath.string()).c_str());
+	fprintf(output, "\t\"state\": \"%s\",\n", EscapeJsonString(options.statePath.string()).c_str());
+	fprintf(output, "\t\"input\": \"%s\",\n", EscapeJsonString(options.inputPath.string()).c_str());
+	fprintf(output, "\t\"frameCount\": %d,\n", static_cast<uint32>(frames.size()));
+	fprintf(output, "\t\"totalTimeMs\": %0.3f,\n", totalTime);
+	fprintf(output, "\t\"averageFps\": %0.3f,\n", (totalTime != 0) ? (frameCount * 1000.0 / totalTime) : 0);
+	fprintf(output, "\t\"frameTimeMs\": {\n");
+	fprintf(output, "\t\t\"mean\": %0.3f,\n", totalTime / frameCount);
+	fprintf(output, "\t\t\"min\": %0.3f,\n", ToMilliseconds(frameTimes.front()));
+	fprintf(output, "\t\t\"p50\": %0.3f,\n", ToMilliseconds(GetPercentile(frameTimes, 50)));
+	fprintf(output, "\t\t\"p95\": %0.3f,\n", p95FrameTime);
+	fprintf(output, "\t\t\"p99\": %0.3f,\n", ToMilliseconds(GetPercentile(frameTimes, 99)));
+	fprintf(output, "\t\t\"max\": %0.3f\n", ToMilliseconds(frameTimes.back()));
+	fprintf(output, "\t},\n");
+	fprintf(output, "\t\"zoneTotalMs\": {\n");
+	fprintf(output, "\t\t\"ee\": %0.3f,\n", ToMilliseconds(totals.eeTime));
+	fprintf(output, "\t\t\"iop\": %0.3f,\n", ToMilliseconds(totals.iopTime));
+	fprintf(output, "\t\t\"vu\": %0.3f,\n", ToMilliseconds(totals.vuTime));
+	fprintf(output, "\t\t\"gsSync\": %0.3f,\n", ToMilliseconds(totals.gsSyncTime));
+	fprintf(output, "\t\t\"spu\": %0.3f,\n", ToMilliseconds(totals.spuTime));
+	fprintf(output, "\t\t\"jit\": %0.3f\n", ToMilliseconds(totals.jitTime));
+	fprintf(output, "\t},\n");
+	fprintf(output, "\t\"frames\": [\n");
+	for(size_t i = 0; i < frames.size(); i++)
+	{
+		const auto& frame = frames[i];
+		fprintf(output, "\t\t{\"frame\": %0.3f, \"ee\": %0.3f, \"iop\": %0.3f, \"vu\": %0.3f, \"gsSync\": %0.3f, \"spu\": %0.3f, \"jit\": %0.3f}%s\n",
+		        ToMilliseconds(frame.frameTime), ToMilliseconds(frame.eeTime), ToMilliseconds(frame.iopTime),
+		        ToMilliseconds(frame.vuTime), ToMilliseconds(frame.gsSyncTime), ToMilliseconds(frame.spuTime),
+		        ToMilliseconds(frame.jitTime), ((i + 1) == frames.size()) ? "" : ",");
+	}
+	fprintf(output, "\t]\n");
+	fprintf(output, "}\n");
+}
+
+static void PrintUsage()
+{
+	printf("Usage: Benchmark [options] (--elf <path> | --disc <path>)\r\n");
+	printf("Options: \r\n");
+	printf("\t --state <path>\t\t Loads a saved state before starting the benchmark.\r\n");
+	printf("\t --input <path>\t\t Replays an input recording, starting on the first benchmarked frame.\r\n");
+	printf("\t --frames <count>\t Number of frames to run (default is %d).\r\n", DEFAULT_FRAME_COUNT);
+	printf("\t --timeout <seconds>\t Maximum wall time allowed (default is %d).\r\n", DEFAULT_TIMEOUT);
+	printf("\t --output <path>\t Writes the JSON report at <path> instead of the standard output.\r\n");
+	printf("\t --max-p95 <ms>\t\t Fails if the 95th percentile frame time is above this value.\r\n");
+	printf("\t --block-stats <path>\t Instruments compiled blocks and writes a hot block report at <path>.\r\n");
+	printf("\t --idle-loops <path>\t Writes the idle loops detected during the run at <path>, in GameConfig format.\r\n");
+}
+
+int main(int argc, const char** argv)
+{
+	BENCHMARK_OPTIONS options;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if((i + 1) >= argc)
+		{
+			printf("Error: Value must be specified for %s option.\r\n", argv[i]);
+			PrintUsage();
+			return -1;
+		}
+		const char* value = argv[i + 1];
+		if(!strcmp(argv[i], "--elf"))
+		{
+			options.executablePath = value;
+		}
+		else if(!strcmp(argv[i], "--disc"))
+		{
+			options.discPath = value;
+		}
+		else if(!strcmp(argv[i], "--state"))
+		{
+			options.statePath = value;
+		}
+		else if(!strcmp(argv[i], "--input"))
+		{
+			options.inputPath = value;
+		}
+		else if(!strcmp(argv[i], "--output"))
+		{
+			options.outputPath = value;
+		}
+		else if(!strcmp(argv[i], "--frames"))
+		{
+			options.frameCount = strtoul(value, nullptr, 10);
+		}
+		else if(!strcmp(argv[i], "--timeout"))
+		{
+			options.timeout = strtoul(value, nullptr, 10);
+		}
+		else if(!strcmp(argv[i], "--max-p95"))
+		{
+			options.maxP95FrameTime = atof(value);
+		}
+		else if(!strcmp(argv[i], "--block-stats"))
+		{
+			options.blockStatsPath = value;
+		}
+		else if(!strcmp(argv[i], "--idle-loops"))
+		{
+			options.idleLoopsPath = value;
+		}
+		else
+		{
+			printf("Error: Unknown option '%s'.\r\n", argv[i]);
+			PrintUsage();
+			return -1;
+		}
+		i++;
+	}
+
+	if(options.executablePath.empty() == options.discPath.empty())
+	{
+		printf("Error: Either an executable or a disc image must be specified.\r\n");
+		PrintUsage();
+		return -1;
+	}
+
+	if(options.frameCount == 0)
+	{
+		printf("Error: Frame count must be greater than 0.\r\n");
+		return -1;
+	}
+
+	CPS2VM::BenchmarkFrameArray frames;
+
+	try
+	{
+		CInputRecording recording;
+		if(!options.inputPath.empty())
+		{
+			auto inputStream = Framework::CreateInputStdStream(options.inputPath.native());
+			recording.Read(inputStream);
+		}
+
+		//Frame limiter is disabled while the benchmark runs, configuration is not saved.
+		//Preferences need to be registered before being set, VM will keep these values.
+		if(!options.discPath.empty())
+		{
+			CAppConfig::GetInstance().RegisterPreferencePath(PREF_PS2_CDROM0_PATH, "");
+			CAppConfig::GetInstance().SetPreferencePath(PREF_PS2_CDROM0_PATH, options.discPath);
+		}
+		CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_JIT_BLOCKSTATS, false);
+		CAppConfig::GetInstance().SetPreferenceBoolean(PREF_PS2_JIT_BLOCKSTATS, !options.blockStatsPath.empty());
+		//Asynchronous host I/O would make reply timings depend on the host's disk
+		CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_IOP_FILEIO_ASYNC, true);
+		CAppConfig::GetInstance().SetPreferenceBoolean(PREF_IOP_FILEIO_ASYNC, false);
+
+		CPS2VM virtualMachine;
+		virtualMachine.Initialize();
+		virtualMachine.CreateGSHandler(CGSH_Null::GetFactoryFunction());
+		virtualMachine.Reset();
+
+		if(!options.discPath.empty())
+		{
+			virtualMachine.m_ee->m_os->BootFromCDROM();
+		}
+		else
+		{
+			virtualMachine.m_ee->m_os->BootFromFile(options.executablePath);
+		}
+
+		if(!options.statePath.empty())
+		{
+			if(!virtualMachine.LoadState(options.statePath).get())
+			{
+				throw std::runtime_error("Failed to load state.");
+			}
+		}
+
+		//Replay and benchmark both start at the next vblank, inputs stay aligned with frames
+		virtualMachine.CreatePadHandler(CPH_InputReplay::GetFactoryFunction(std::move(recording)));
+
+		auto benchmarkFuture = virtualMachine.RunBenchmark(options.frameCount);
+		virtualMachine.Resume();
+
+		auto waitResult = benchmarkFuture.wait_for(std::chrono::seconds(options.timeout));
+		virtualMachine.Pause();
+		if(waitResult != std::future_status::ready)
+		{
+			virtualMachine.DestroyPadHandler();
+			virtualMachine.DestroyGSHandler();
+			virtualMachine.Destroy();
+			throw std::runtime_error("Benchmark timed out.");
+		}
+		frames = benchmarkFuture.get();
+
+		if(!options.blockStatsPath.empty())
+		{
+			if(!virtualMachine.SaveBlockStatsReport(options.blockStatsPath).get())
+			{
+				fprintf(stderr, "Warning: Failed to save block stats report.\r\n");
+			}
+		}
+
+		if(!options.idleLoopsPath.empty())
+		{
+			if(!virtualMachine.SaveIdleLoopReport(options.idleLoopsPath).get())
+			{
+				fprintf(stderr, "Warning: Failed to save idle loop report.\r\n");
+			}
+		}
+
+		virtualMachine.DestroyPadHandler();
+		virtualMachine.DestroyGSHandler();
+		virtualMachine.Destroy();
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Error: Failed to run benchmark: %s\r\n", exception.what());
+		return -1;
+	}
+
+	FILE* output = stdout;
+	if(!options.outputPath.empty())
+	{
+		output = fopen(options.outputPath.string().c_str(), "wb");
+		if(!output)
+		{
+			printf("Error: Failed to open '%s'.\r\n", options.outputPath.string().c_str());
+			return -1;
+		}
+	}
+
+	double p95FrameTime = 0;
+	WriteReport(output, options, frames, p95FrameTime);
+
+	if(output != stdout)
+	{
+		fclose(output);
+	}
+
+	if((options.maxP95FrameTime != 0) && (p95FrameTime > options.maxP95FrameTime))
+	{
+		fprintf(stderr, "Error: 95th percentile frame time (%0.3fms) is above limit (%0.3fms).\r\n", p95FrameTime, options.maxP95FrameTime);
+		return -1;
+	}
+
+	return 0;
+}
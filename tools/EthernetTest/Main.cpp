@@ -0,0 +1,323 @@
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "EthernetSwitch.h"
+#include "PS2VM.h"
+#include "Test.h"
+
+enum
+{
+	REG_PIO_DIR = 0x1000002C,
+	REG_PIO_DATA = 0x1000002E,
+	REG_SMAP_RXFIFO_RD_PTR = 0x10001034,
+	REG_SMAP_RXFIFO_FRAME_CNT = 0x1000103C,
+	REG_SMAP_RXFIFO_FRAME_DEC = 0x10001040,
+	REG_SMAP_TXFIFO_DATA = 0x10001100,
+	REG_SMAP_RXFIFO_DATA = 0x10001200,
+	REG_SMAP_EMAC3_TXMODE0_HI = 0x10002008,
+	REG_SMAP_BD_TX_BASE = 0x10003000,
+	REG_SMAP_BD_RX_BASE = 0x10003200,
+};
+
+enum
+{
+	SMAP_BD_COUNT = 0x40,
+	SMAP_BD_TX_READY = 0x8000,
+	SMAP_BD_RX_EMPTY = 0x8000,
+	SMAP_TX_BUFFER_BASE = 0x1000,
+};
+
+typedef std::vector<uint8> Frame;
+
+//Virtual machine connected to a switch port through CPS2VM::ConnectEthernetSwitch, its SMAP adapter is driven the same way the SMAP driver would
+class CNode
+{
+public:
+	CNode(const std::shared_ptr<CEthernetSwitch>& ethernetSwitch)
+	{
+		m_virtualMachine.Initialize();
+		TEST_VERIFY(m_virtualMachine.ConnectEthernetSwitch(ethernetSwitch));
+		for(uint32 i = 0; i < SMAP_BD_COUNT; i++)
+		{
+			GetSpeed().WriteRegister(REG_SMAP_BD_RX_BASE + (i * 8), SMAP_BD_RX_EMPTY);
+		}
+		m_macAddress = ReadEepromMacAddress();
+	}
+
+	~CNode()
+	{
+		m_virtualMachine.DisconnectEthernetSwitch();
+		m_virtualMachine.Destroy();
+	}
+
+	CEthernetSwitch::MacAddress GetMacAddress() const
+	{
+		return m_macAddress;
+	}
+
+	CEthernetSwitch::MacAddress ReadEepromMacAddress()
+	{
+		GetSpeed().WriteRegister(REG_PIO_DIR, 0xE1);
+		GetSpeed().ReadRegister(REG_PIO_DATA);
+		uint16 words[3] = {};
+		for(uint32 i = 0; i < 3 * 16; i++)
+		{
+			uint32 bit = (GetSpeed().ReadRegister(REG_PIO_DATA) & 0x10) ? 1 : 0;
+			words[i / 16] |= bit << (15 - (i % 16));
+		}
+		CEthernetSwitch::MacAddress result;
+		memcpy(result.data(), words, result.size());
+		return result;
+	}
+
+	void Send(const Frame& frame)
+	{
+		for(uint32 i = 0; i < frame.size(); i += 4)
+		{
+			uint32 word = 0;
+			memcpy(&word, frame.data() + i, std::min<size_t>(4, frame.size() - i));
+			GetSpeed().WriteRegister(REG_SMAP_TXFIFO_DATA, word);
+		}
+		GetSpeed().WriteRegister(REG_SMAP_BD_TX_BASE + 4, static_cast<uint32>(frame.size()));
+		GetSpeed().WriteRegister(REG_SMAP_BD_TX_BASE + 6, SMAP_TX_BUFFER_BASE);
+		GetSpeed().WriteRegister(REG_SMAP_BD_TX_BASE + 0, SMAP_BD_TX_READY);
+		GetSpeed().WriteRegister(REG_SMAP_EMAC3_TXMODE0_HI, 0x8000);
+	}
+
+	bool TryReceive(Frame& frame, uint32 sliceCount = 10)
+	{
+		for(uint32 i = 0; i < sliceCount; i++)
+		{
+			GetSpeed().CountTicks(0x10000);
+			if(GetSpeed().ReadRegister(REG_SMAP_RXFIFO_FRAME_CNT) != 0)
+			{
+				break;
+			}
+		}
+		if(GetSpeed().ReadRegister(REG_SMAP_RXFIFO_FRAME_CNT) == 0)
+		{
+			return false;
+		}
+		uint32 bdAddress = REG_SMAP_BD_RX_BASE + (m_rxIndex * 8);
+		TEST_VERIFY((GetSpeed().ReadRegister(bdAddress) & SMAP_BD_RX_EMPTY) == 0);
+		uint32 frameSize = GetSpeed().ReadRegister(bdAddress + 4);
+		frame.resize(frameSize);
+		GetSpeed().WriteRegister(REG_SMAP_RXFIFO_RD_PTR, GetSpeed().ReadRegister(bdAddress + 6));
+		for(uint32 i = 0; i < frameSize; i += 4)
+		{
+			uint32 word = GetSpeed().ReadRegister(REG_SMAP_RXFIFO_DATA);
+			memcpy(frame.data() + i, &word, std::min<size_t>(4, frameSize - i));
+		}
+		GetSpeed().WriteRegister(REG_SMAP_RXFIFO_FRAME_DEC, 1);
+		GetSpeed().WriteRegister(bdAddress, SMAP_BD_RX_EMPTY);
+		m_rxIndex = (m_rxIndex + 1) % SMAP_BD_COUNT;
+		return true;
+	}
+
+private:
+	//The virtual machine is never started, its IOP is only accessed from this thread
+	Iop::CSpeed& GetSpeed()
+	{
+		return m_virtualMachine.m_iop->m_speed;
+	}
+
+	CPS2VM m_virtualMachine;
+	CEthernetSwitch::MacAddress m_macAddress;
+	uint32 m_rxIndex = 0;
+};
+
+static Frame MakeFrame(const CEthernetSwitch::MacAddress& dstAddress, const CEthernetSwitch::MacAddress& srcAddress, uint32 payloadSize, uint8 seed)
+{
+	Frame frame(14 + payloadSize);
+	memcpy(frame.data() + 0, dstAddress.data(), 6);
+	memcpy(frame.data() + 6, srcAddress.data(), 6);
+	frame[12] = 0x08;
+	frame[13] = 0x00;
+	for(uint32 i = 0; i < payloadSize; i++)
+	{
+		frame[14 + i] = static_cast<uint8>(seed + i);
+	}
+	return frame;
+}
+
+static const CEthernetSwitch::MacAddress g_broadcastAddress = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static void UnicastTest()
+{
+	auto ethernetSwitch = std::make_shared<CEthernetSwitch>();
+	CNode node0(ethernetSwitch), node1(ethernetSwitch), node2(ethernetSwitch);
+
+	TEST_VERIFY(node0.GetMacAddress() != node1.GetMacAddress());
+	TEST_VERIFY(node0.ReadEepromMacAddress() == node0.GetMacAddress());
+	TEST_VERIFY(node1.ReadEepromMacAddress() == node1.GetMacAddress());
+
+	for(uint32 i = 0; i < 8; i++)
+	{
+		auto frame = MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), 64 + (i * 13), i);
+		node0.Send(frame);
+		Frame rxFrame;
+		TEST_VERIFY(node1.TryReceive(rxFrame));
+		TEST_VERIFY(rxFrame == frame);
+		TEST_VERIFY(!node2.TryReceive(rxFrame));
+		TEST_VERIFY(!node0.TryReceive(rxFrame));
+	}
+
+	auto reply = MakeFrame(node0.GetMacAddress(), node1.GetMacAddress(), 100, 0x80);
+	node1.Send(reply);
+	Frame rxFrame;
+	TEST_VERIFY(node0.TryReceive(rxFrame));
+	TEST_VERIFY(rxFrame == reply);
+}
+
+static void BroadcastTest()
+{
+	auto ethernetSwitch = std::make_shared<CEthernetSwitch>();
+	CNode node0(ethernetSwitch), node1(ethernetSwitch), node2(ethernetSwitch);
+
+	auto frame = MakeFrame(g_broadcastAddress, node0.GetMacAddress(), 46, 0x10);
+	node0.Send(frame);
+	Frame rxFrame;
+	TEST_VERIFY(node1.TryReceive(rxFrame) && (rxFrame == frame));
+	TEST_VERIFY(node2.TryReceive(rxFrame) && (rxFrame == frame));
+	TEST_VERIFY(!node0.TryReceive(rxFrame));
+}
+
+static void LatencyTest()
+{
+	static const uint32 latency = 50000;
+
+	auto ethernetSwitch = std::make_shared<CEthernetSwitch>();
+	ethernetSwitch->SetLatency(latency);
+	CNode node0(ethernetSwitch), node1(ethernetSwitch);
+
+	auto frame = MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), 100, 0x20);
+	auto sendTime = std::chrono::steady_clock::now();
+	node0.Send(frame);
+
+	Frame rxFrame;
+	while(!node1.TryReceive(rxFrame, 1))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	auto receiveTime = std::chrono::steady_clock::now();
+	TEST_VERIFY(rxFrame == frame);
+	TEST_VERIFY((receiveTime - sendTime) >= std::chrono::microseconds(latency));
+}
+
+static void BandwidthTest()
+{
+	static const uint32 frameCount = 8;
+	static const uint32 payloadSize = 1236;
+	static const uint64 bandwidth = 1000000;
+
+	auto ethernetSwitch = std::make_shared<CEthernetSwitch>();
+	ethernetSwitch->SetBandwidth(bandwidth);
+	CNode node0(ethernetSwitch), node1(ethernetSwitch);
+
+	//Each frame takes 10ms to go through the link
+	auto sendTime = std::chrono::steady_clock::now();
+	for(uint32 i = 0; i < frameCount; i++)
+	{
+		node0.Send(MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), payloadSize, i));
+	}
+
+	for(uint32 i = 0; i < frameCount; i++)
+	{
+		Frame rxFrame;
+		while(!node1.TryReceive(rxFrame, 1))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		TEST_VERIFY(rxFrame == MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), payloadSize, i));
+	}
+	auto receiveTime = std::chrono::steady_clock::now();
+	TEST_VERIFY((receiveTime - sendTime) >= std::chrono::milliseconds(10 * frameCount));
+}
+
+static void OverflowTest()
+{
+	static const uint32 frameCount = CEthernetSwitch::PORT_QUEUE_SIZE + 16;
+
+	auto ethernetSwitch = std::make_shared<CEthernetSwitch>();
+	CNode node0(ethernetSwitch), node1(ethernetSwitch);
+
+	for(uint32 i = 0; i < frameCount; i++)
+	{
+		node0.Send(MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), 64, i));
+	}
+
+	//Frames that made it must come out in order, the others were dropped
+	for(uint32 i = 0; i < CEthernetSwitch::PORT_QUEUE_SIZE; i++)
+	{
+		Frame rxFrame;
+		TEST_VERIFY(node1.TryReceive(rxFrame));
+		TEST_VERIFY(rxFrame == MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), 64, i));
+	}
+	Frame rxFrame;
+	TEST_VERIFY(!node1.TryReceive(rxFrame));
+}
+
+static void SharedMemoryTest()
+{
+	if(!CEthernetSwitch::IsSharedMemorySupported())
+	{
+		return;
+	}
+
+	//Both switches refer to the same segment, as if opened from two processes
+	auto switchName = "EthTest" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count() % 100000);
+	auto ethernetSwitch0 = std::make_shared<CEthernetSwitch>(switchName);
+	auto ethernetSwitch1 = std::make_shared<CEthernetSwitch>(switchName);
+	CNode node0(ethernetSwitch0), node1(ethernetSwitch1);
+	TEST_VERIFY(node0.GetMacAddress() != node1.GetMacAddress());
+
+	auto frame = MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), 200, 0x30);
+	node0.Send(frame);
+	Frame rxFrame;
+	TEST_VERIFY(node1.TryReceive(rxFrame));
+	TEST_VERIFY(rxFrame == frame);
+}
+
+static void CaptureTest()
+{
+	auto capturePath = fs::temp_directory_path() / "EthernetTest.pcap";
+
+	auto ethernetSwitch = std::make_shared<CEthernetSwitch>();
+	CNode node0(ethernetSwitch), node1(ethernetSwitch);
+
+	ethernetSwitch->StartCapture(capturePath);
+	auto frame0 = MakeFrame(node1.GetMacAddress(), node0.GetMacAddress(), 100, 0x40);
+	auto frame1 = MakeFrame(g_broadcastAddress, node1.GetMacAddress(), 50, 0x50);
+	node0.Send(frame0);
+	node1.Send(frame1);
+	ethernetSwitch->StopCapture();
+
+	//Global header, then a record header for each frame
+	uint64 expectedSize = 24 + (16 + frame0.size()) + (16 + frame1.size());
+	TEST_VERIFY(fs::file_size(capturePath) == expectedSize);
+	fs::remove(capturePath);
+}
+
+int main(int argc, const char** argv)
+{
+	try
+	{
+		UnicastTest();
+		BroadcastTest();
+		LatencyTest();
+		BandwidthTest();
+		OverflowTest();
+		SharedMemoryTest();
+		CaptureTest();
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Failed: %s\r\n", exception.what());
+		return -1;
+	}
+	return 0;
+}
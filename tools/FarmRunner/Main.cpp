@@ -0,0 +1,295 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PS2VM.h"
+#include "PS2VM_Preferences.h"
+#include "AppConfig.h"
+#include "filesystem_def.h"
+#include "ee/PS2OS.h"
+#include "gs/GSH_Null.h"
+
+//Runs several headless VMs concurrently in the same process to measure throughput
+//when many instances share a host (ie.: test farms, regression runs).
+
+#define DEFAULT_FRAME_COUNT 600
+#define DEFAULT_TIMEOUT 120
+
+struct FARM_JOB
+{
+	fs::path path;
+	uint32 iteration = 0;
+};
+
+struct FARM_JOB_RESULT
+{
+	fs::path path;
+	uint32 slot = 0;
+	uint64 affinityMask = 0;
+	uint32 frameCount = 0;
+	double seconds = 0;
+	bool exited = false;
+	bool timedOut = false;
+	std::string error;
+};
+
+struct FARM_OPTIONS
+{
+	uint32 instanceCount = 1;
+	uint32 frameCount = DEFAULT_FRAME_COUNT;
+	uint32 timeout = DEFAULT_TIMEOUT;
+	uint32 repeatCount = 1;
+	bool pinThreads = false;
+};
+
+static void ScanExecutables(const fs::path& path, std::vector<fs::path>& executables)
+{
+	if(!fs::is_directory(path))
+	{
+		executables.push_back(path);
+		return;
+	}
+	fs::directory_iterator endIterator;
+	for(auto pathIterator = fs::directory_iterator(path);
+	    pathIterator != endIterator; pathIterator++)
+	{
+		auto entryPath = pathIterator->path();
+		if(fs::is_directory(entryPath))
+		{
+			ScanExecutables(entryPath, executables);
+		}
+		else if(entryPath.extension() == ".elf")
+		{
+			executables.push_back(entryPath);
+		}
+	}
+}
+
+static uint64 GetSlotAffinityMask(uint32 slot, const FARM_OPTIONS& options)
+{
+	if(!options.pinThreads) return 0;
+	uint32 cpuCount = std::max<uint32>(std::thread::hardware_concurrency(), 1);
+	cpuCount = std::min<uint32>(cpuCount, 64);
+	//Spread instances evenly, each one gets a disjoint set of CPUs when possible
+	uint32 cpusPerSlot = std::max<uint32>(cpuCount / options.instanceCount, 1);
+	uint64 mask = 0;
+	for(uint32 i = 0; i < cpusPerSlot; i++)
+	{
+		uint32 cpu = ((slot * cpusPerSlot) + i) % cpuCount;
+		mask |= (1ULL << cpu);
+	}
+	return mask;
+}
+
+static FARM_JOB_RESULT ExecuteJob(const FARM_JOB& job, uint32 slot, const FARM_OPTIONS& options)
+{
+	FARM_JOB_RESULT result;
+	result.path = job.path;
+	result.slot = slot;
+	result.affinityMask = GetSlotAffinityMask(slot, options);
+
+	std::atomic<uint32> frameCount = 0;
+	std::atomic<bool> executionOver = false;
+
+	try
+	{
+		CPS2VM virtualMachine;
+		virtualMachine.Initialize();
+		virtualMachine.CreateGSHandler(CGSH_Null::GetFactoryFunction());
+		if(result.affinityMask != 0)
+		{
+			virtualMachine.SetThreadAffinity(result.affinityMask);
+		}
+		auto frameConnection = virtualMachine.OnNewFrame.Connect(
+		    [&frameCount]() {
+			    frameCount++;
+		    });
+		auto exitConnection = virtualMachine.m_ee->m_os->OnRequestExit.Connect(
+		    [&executionOver]() {
+			    executionOver = true;
+		    });
+		virtualMachine.m_ee->m_os->BootFromFile(job.path);
+
+		auto startTime = std::chrono::steady_clock::now();
+		auto timeoutTime = startTime + std::chrono::seconds(options.timeout);
+		virtualMachine.Resume();
+
+		while(!executionOver && (frameCount < options.frameCount))
+		{
+			if(std::chrono::steady_clock::now() >= timeoutTime)
+			{
+				result.timedOut = true;
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		virtualMachine.Pause();
+		auto endTime = std::chrono::steady_clock::now();
+
+		result.frameCount = frameCount;
+		result.seconds = std::chrono::duration<double>(endTime - startTime).count();
+		result.exited = executionOver;
+
+		virtualMachine.DestroyGSHandler();
+		virtualMachine.Destroy();
+	}
+	catch(const std::exception& exception)
+	{
+		result.error = exception.what();
+	}
+
+	return result;
+}
+
+static void PrintUsage()
+{
+	printf("Usage: FarmRunner [options] <elf|directory>...\r\n");
+	printf("Options: \r\n");
+	printf("\t --instances <count>\t Number of VMs running concurrently (default is 1).\r\n");
+	printf("\t --frames <count>\t Number of emulated frames to run for each VM (default is %d).\r\n", DEFAULT_FRAME_COUNT);
+	printf("\t --timeout <seconds>\t Maximum wall time allowed for each VM (default is %d).\r\n", DEFAULT_TIMEOUT);
+	printf("\t --repeat <count>\t Number of times each executable is run (default is 1).\r\n");
+	printf("\t --pin\t\t\t Pins the threads of each VM to a distinct set of host CPUs.\r\n");
+}
+
+static bool ParseCount(int argc, const char** argv, int& i, uint32& value)
+{
+	if((i + 1) >= argc)
+	{
+		printf("Error: Value must be specified for %s option.\r\n", argv[i]);
+		return false;
+	}
+	value = strtoul(argv[i + 1], nullptr, 10);
+	if(value == 0)
+	{
+		printf("Error: Invalid value '%s' for %s option.\r\n", argv[i + 1], argv[i]);
+		return false;
+	}
+	i++;
+	return true;
+}
+
+int main(int argc, const char** argv)
+{
+	if(argc < 2)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	FARM_OPTIONS options;
+	std::vector<fs::path> executables;
+
+	try
+	{
+		for(int i = 1; i < argc; i++)
+		{
+			if(!strcmp(argv[i], "--instances"))
+			{
+				if(!ParseCount(argc, argv, i, options.instanceCount)) return -1;
+			}
+			else if(!strcmp(argv[i], "--frames"))
+			{
+				if(!ParseCount(argc, argv, i, options.frameCount)) return -1;
+			}
+			else if(!strcmp(argv[i], "--timeout"))
+			{
+				if(!ParseCount(argc, argv, i, options.timeout)) return -1;
+			}
+			else if(!strcmp(argv[i], "--repeat"))
+			{
+				if(!ParseCount(argc, argv, i, options.repeatCount)) return -1;
+			}
+			else if(!strcmp(argv[i], "--pin"))
+			{
+				options.pinThreads = true;
+			}
+			else
+			{
+				ScanExecutables(argv[i], executables);
+			}
+		}
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Error: Failed to scan executables: %s\r\n", exception.what());
+		return -1;
+	}
+
+	if(executables.empty())
+	{
+		printf("Error: No executable specified.\r\n");
+		return -1;
+	}
+
+	//All VMs share the same configuration, make sure they run as fast as possible.
+	//The configuration is not saved, so this won't affect the user's settings.
+	//Preference needs to be registered before being set, VM will keep this value.
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE, true);
+	CAppConfig::GetInstance().SetPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE, false);
+
+	std::vector<FARM_JOB> jobs;
+	for(uint32 iteration = 0; iteration < options.repeatCount; iteration++)
+	{
+		for(const auto& executable : executables)
+		{
+			FARM_JOB job;
+			job.path = executable;
+			job.iteration = iteration;
+			jobs.push_back(job);
+		}
+	}
+
+	uint32 workerCount = std::min<uint32>(options.instanceCount, static_cast<uint32>(jobs.size()));
+	printf("Running %d job(s) on %d instance(s)%s.\r\n",
+	       static_cast<uint32>(jobs.size()), workerCount, options.pinThreads ? " with pinned threads" : "");
+
+	std::atomic<uint32> nextJobIndex = 0;
+	std::mutex resultsMutex;
+	std::vector<FARM_JOB_RESULT> results;
+
+	//Each worker owns a slot and runs one VM at a time, pulling jobs until none are left
+	auto farmStartTime = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for(uint32 slot = 0; slot < workerCount; slot++)
+	{
+		workers.emplace_back(
+		    [&, slot]() {
+			    while(1)
+			    {
+				    uint32 jobIndex = nextJobIndex++;
+				    if(jobIndex >= jobs.size()) break;
+				    auto result = ExecuteJob(jobs[jobIndex], slot, options);
+				    std::lock_guard<std::mutex> resultsLock(resultsMutex);
+				    double fps = (result.seconds != 0) ? (result.frameCount / result.seconds) : 0;
+				    printf("[%d] '%s': %d frames in %0.2fs (%0.2f fps)%s%s%s\r\n",
+				           result.slot, result.path.string().c_str(), result.frameCount, result.seconds, fps,
+				           result.exited ? ", exited" : "", result.timedOut ? ", timed out" : "",
+				           result.error.empty() ? "" : (", error: " + result.error).c_str());
+				    results.push_back(std::move(result));
+			    }
+		    });
+	}
+	for(auto& worker : workers)
+	{
+		worker.join();
+	}
+	double farmSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - farmStartTime).count();
+
+	uint64 totalFrameCount = 0;
+	uint32 failedCount = 0;
+	for(const auto& result : results)
+	{
+		totalFrameCount += result.frameCount;
+		if(!result.error.empty()) failedCount++;
+	}
+
+	printf("Total: %d job(s), %d failed, %llu frames in %0.2fs (%0.2f aggregate fps).\r\n",
+	       static_cast<uint32>(results.size()), failedCount, static_cast<unsigned long long>(totalFrameCount),
+	       farmSeconds, (farmSeconds != 0) ? (totalFrameCount / farmSeconds) : 0);
+
+	return (failedCount == 0) ? 0 : -1;
+}
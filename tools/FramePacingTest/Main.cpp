@@ -0,0 +1,224 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include "FrameLimiter.h"
+#include "Test.h"
+
+//Frame rate used by tests, 100 fps gives 10ms frames
+static const uint32 g_frameRate = 100;
+static const auto g_frameDuration = std::chrono::milliseconds(10);
+
+//Waits on the simulated clock end a bit late, like they would on a real system
+static const std::chrono::microseconds g_oversleepTimes[] =
+    {
+        std::chrono::microseconds(0),
+        std::chrono::microseconds(120),
+        std::chrono::microseconds(500),
+        std::chrono::microseconds(30),
+        std::chrono::microseconds(260),
+};
+static const auto g_maxOversleepTime = std::chrono::microseconds(500);
+
+typedef std::vector<CFrameLimiter::TimePoint> TimePointArray;
+
+//Simulated clock, tests don't depend on the load of the machine running them
+class CTestClock
+{
+public:
+	void Attach(CFrameLimiter& frameLimiter)
+	{
+		frameLimiter.SetTimeFunctions(
+		    [this]() { return m_currentTime; },
+		    [this](CFrameLimiter::TimePoint targetTime) { Wait(targetTime); });
+	}
+
+	CFrameLimiter::TimePoint GetTime() const
+	{
+		return m_currentTime;
+	}
+
+	void Advance(CFrameLimiter::Clock::duration duration)
+	{
+		m_currentTime += duration;
+	}
+
+	uint32 GetWaitCount() const
+	{
+		return m_waitCount;
+	}
+
+private:
+	void Wait(CFrameLimiter::TimePoint targetTime)
+	{
+		m_waitCount++;
+		if(targetTime <= m_currentTime) return;
+		auto oversleepTime = g_oversleepTimes[m_oversleepIndex++ % std::size(g_oversleepTimes)];
+		m_currentTime = targetTime + oversleepTime;
+	}
+
+	CFrameLimiter::TimePoint m_currentTime;
+	uint32 m_oversleepIndex = 0;
+	uint32 m_waitCount = 0;
+};
+
+static void RunFrame(CFrameLimiter& frameLimiter, CTestClock& clock, std::chrono::microseconds workDuration)
+{
+	frameLimiter.BeginFrame();
+	clock.Advance(workDuration);
+	frameLimiter.EndFrame();
+}
+
+static int64 ToMicroseconds(CFrameLimiter::Clock::duration duration)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+//Average frame rate must match the target frame rate, wait inaccuracies must not accumulate
+static void DriftTest()
+{
+	static const uint32 frameCount = 100;
+
+	TimePointArray frameEndTimes;
+	CTestClock clock;
+	CFrameLimiter frameLimiter;
+	clock.Attach(frameLimiter);
+	frameLimiter.SetFrameRate(g_frameRate);
+	frameLimiter.SetFrameEndHandler(
+	    [&](CFrameLimiter::TimePoint, CFrameLimiter::TimePoint frameEndTime) {
+		    frameEndTimes.push_back(frameEndTime);
+	    });
+
+	for(uint32 i = 0; i < frameCount; i++)
+	{
+		RunFrame(frameLimiter, clock, std::chrono::milliseconds(2));
+	}
+
+	TEST_VERIFY(frameEndTimes.size() == frameCount);
+	auto totalDuration = frameEndTimes.back() - frameEndTimes.front();
+	auto expectedDuration = g_frameDuration * (frameCount - 1);
+	//Only the oversleep of the first and last frames can show up on the whole run
+	TEST_VERIFY(std::abs(ToMicroseconds(totalDuration - expectedDuration)) <= ToMicroseconds(g_maxOversleepTime));
+
+	auto pacingStats = frameLimiter.GetPacingStats();
+	TEST_VERIFY(pacingStats.frameCount == frameCount);
+}
+
+//Frames must never end before their deadline
+static void DeadlineTest()
+{
+	CTestClock clock;
+	CFrameLimiter frameLimiter;
+	clock.Attach(frameLimiter);
+	frameLimiter.SetFrameRate(g_frameRate);
+	frameLimiter.SetFrameEndHandler(
+	    [&](CFrameLimiter::TimePoint deadline, CFrameLimiter::TimePoint frameEndTime) {
+		    TEST_VERIFY(frameEndTime >= deadline);
+	    });
+
+	for(uint32 i = 0; i < 20; i++)
+	{
+		RunFrame(frameLimiter, clock, std::chrono::milliseconds(i % 5));
+	}
+}
+
+//A long stall must not be followed by a burst of unpaced frames
+static void StallTest()
+{
+	TimePointArray frameEndTimes;
+	CTestClock clock;
+	CFrameLimiter frameLimiter;
+	clock.Attach(frameLimiter);
+	frameLimiter.SetFrameRate(g_frameRate);
+	frameLimiter.SetFrameEndHandler(
+	    [&](CFrameLimiter::TimePoint, CFrameLimiter::TimePoint frameEndTime) {
+		    frameEndTimes.push_back(frameEndTime);
+	    });
+
+	RunFrame(frameLimiter, clock, std::chrono::milliseconds(1));
+	RunFrame(frameLimiter, clock, std::chrono::milliseconds(1));
+	RunFrame(frameLimiter, clock, std::chrono::milliseconds(50));
+	RunFrame(frameLimiter, clock, std::chrono::milliseconds(1));
+	RunFrame(frameLimiter, clock, std::chrono::milliseconds(1));
+
+	TEST_VERIFY(frameEndTimes.size() == 5);
+	//Frames following the stall are paced from the end of the stall
+	TEST_VERIFY((frameEndTimes[3] - frameEndTimes[2]) >= (g_frameDuration / 2));
+	TEST_VERIFY((frameEndTimes[4] - frameEndTimes[3]) >= (g_frameDuration / 2));
+	TEST_VERIFY(frameLimiter.GetPacingStats().lateFrameCount != 0);
+}
+
+//With late latching, work must start as late as possible in the frame
+static void LateLatchTest()
+{
+	static const uint32 warmupFrameCount = 5;
+	static const uint32 frameCount = 20;
+
+	CTestClock clock;
+	CFrameLimiter frameLimiter;
+	clock.Attach(frameLimiter);
+	frameLimiter.SetFrameRate(g_frameRate);
+	frameLimiter.SetLateLatchEnabled(true);
+
+	auto totalLatchDuration = CFrameLimiter::Clock::duration::zero();
+	for(uint32 i = 0; i < frameCount; i++)
+	{
+		auto beginTime = clock.GetTime();
+		frameLimiter.BeginFrame();
+		auto workStartTime = clock.GetTime();
+		clock.Advance(std::chrono::milliseconds(1));
+		frameLimiter.EndFrame();
+		//Skip a few frames to let the frame duration estimate settle
+		if(i >= warmupFrameCount)
+		{
+			totalLatchDuration += workStartTime - beginTime;
+		}
+	}
+
+	//Work takes about a tenth of the frame, most of the frame should be spent waiting before it starts
+	auto averageLatchDuration = totalLatchDuration / (frameCount - warmupFrameCount);
+	TEST_VERIFY(averageLatchDuration >= (g_frameDuration / 2));
+	//Starting late must not make frames miss their deadline
+	TEST_VERIFY(frameLimiter.GetPacingStats().lateFrameCount == 0);
+}
+
+//Without a frame rate, frames are not paced at all
+static void UnlimitedTest()
+{
+	uint32 frameEndCount = 0;
+	CTestClock clock;
+	CFrameLimiter frameLimiter;
+	clock.Attach(frameLimiter);
+	frameLimiter.SetFrameRate(0);
+	frameLimiter.SetFrameEndHandler(
+	    [&](CFrameLimiter::TimePoint, CFrameLimiter::TimePoint) {
+		    frameEndCount++;
+	    });
+
+	for(uint32 i = 0; i < 20; i++)
+	{
+		RunFrame(frameLimiter, clock, std::chrono::microseconds(0));
+	}
+	TEST_VERIFY(clock.GetWaitCount() == 0);
+	TEST_VERIFY(frameEndCount == 0);
+}
+
+int main(int argc, const char** argv)
+{
+	try
+	{
+		DriftTest();
+		DeadlineTest();
+		StallTest();
+		LateLatchTest();
+		UnlimitedTest();
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Failed: %s\r\n", exception.what());
+		return -1;
+	}
+	return 0;
+}
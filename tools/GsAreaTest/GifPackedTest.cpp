@@ -0,0 +1,217 @@
+#include "GifPackedTest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include "ee/GIF.h"
+#include "ee/DMAC.h"
+#include "gs/GSH_Null.h"
+#include "FrameDump.h"
+#include "MIPS.h"
+#include "Ps2Const.h"
+
+//Builds a GIF packet similar to what games send for textured triangle strips (ST, RGBAQ, XYZ2)
+static uint32 BuildStripPacket(uint8* memory, uint32 address, uint32 vertexCount, uint64 regList, uint32 regCount)
+{
+	auto tag = reinterpret_cast<CGIF::TAG*>(memory + address);
+	memset(tag, 0, sizeof(CGIF::TAG));
+	tag->loops = vertexCount;
+	tag->eop = 1;
+	tag->pre = 1;
+	tag->prim = CGSHandler::PRIM_TRIANGLESTRIP | 0x10;
+	tag->cmd = 0;
+	tag->nreg = regCount;
+	tag->regs = regList;
+	address += 0x10;
+
+	for(uint32 i = 0; i < vertexCount; i++)
+	{
+		auto st = reinterpret_cast<uint128*>(memory + address);
+		st->nV0 = 0x3F000000 + i;
+		st->nV1 = 0x3E800000 + i;
+		st->nV2 = 0x3F800000 + i;
+		st->nV3 = 0;
+		auto rgba = reinterpret_cast<uint128*>(memory + address + 0x10);
+		rgba->nV0 = i & 0xFF;
+		rgba->nV1 = (i >> 8) & 0xFF;
+		rgba->nV2 = 0x80;
+		rgba->nV3 = 0x40;
+		auto xyz = reinterpret_cast<uint128*>(memory + address + 0x20);
+		xyz->nV0 = 0x8000 + (i * 0x10);
+		xyz->nV1 = 0x8000 + (i * 0x20);
+		xyz->nV2 = 0x1000 + i;
+		xyz->nV3 = 0;
+		address += 0x30;
+		//Pad with NOPs if needed
+		for(uint32 reg = 3; reg < regCount; reg++)
+		{
+			memset(memory + address, 0, 0x10);
+			address += 0x10;
+		}
+	}
+
+	return address;
+}
+
+static uint64 GetExpectedXyz2(uint32 vertexIndex)
+{
+	uint64 result = (0x8000 + (vertexIndex * 0x10)) & 0xFFFF;
+	result |= static_cast<uint64>((0x8000 + (vertexIndex * 0x20)) & 0xFFFF) << 16;
+	result |= static_cast<uint64>(0x1000 + vertexIndex) << 32;
+	return result;
+}
+
+static uint64 GetExpectedRgbaq(uint32 vertexIndex)
+{
+	uint64 result = vertexIndex & 0xFF;
+	result |= static_cast<uint64>((vertexIndex >> 8) & 0xFF) << 8;
+	result |= static_cast<uint64>(0x80) << 16;
+	result |= static_cast<uint64>(0x40) << 24;
+	result |= static_cast<uint64>(0x3F800000 + vertexIndex) << 32;
+	return result;
+}
+
+//Keeps track of every register write received by the GS
+class CGSH_WriteRecorder : public CGSH_Null
+{
+public:
+	CGSHandler::RegisterWriteList writes;
+	bool recordWrites = true;
+
+protected:
+	void WriteRegisterImpl(uint8 registerId, uint64 value) override
+	{
+		if(recordWrites)
+		{
+			writes.emplace_back(registerId, value);
+		}
+		CGSH_Null::WriteRegisterImpl(registerId, value);
+	}
+};
+
+struct GIF_TEST_CONTEXT
+{
+	GIF_TEST_CONTEXT(bool specialized)
+	    : ram(new uint8[PS2::EE_RAM_SIZE])
+	    , spr(new uint8[PS2::EE_SPR_SIZE])
+	    , ee(MEMORYMAP_ENDIAN_LSBF)
+	    , dmac(ram.get(), spr.get(), nullptr, nullptr, ee)
+	    , gif(gs, dmac, ram.get(), spr.get())
+	{
+		memset(ram.get(), 0, PS2::EE_RAM_SIZE);
+		gs = recorder = new CGSH_WriteRecorder();
+		gs->Initialize();
+		gs->Reset();
+		gif.Reset();
+		gif.SetPackedSpecializationEnabled(specialized);
+	}
+
+	~GIF_TEST_CONTEXT()
+	{
+		gs->Release();
+		delete gs;
+	}
+
+	uint64 GetGsRegister(uint8 reg)
+	{
+		gs->Finish(true);
+		return gs->GetRegisters()[reg];
+	}
+
+	const CGSHandler::RegisterWriteList& GetGsWrites()
+	{
+		gs->Finish(true);
+		return recorder->writes;
+	}
+
+	std::unique_ptr<uint8[]> ram;
+	std::unique_ptr<uint8[]> spr;
+	CMIPS ee;
+	CDMAC dmac;
+	CGSHandler* gs = nullptr;
+	CGSH_WriteRecorder* recorder = nullptr;
+	CGIF gif;
+};
+
+void CGifPackedTest::Execute()
+{
+	CheckStripPacket();
+	CheckPartialPacket();
+	MeasureThroughput();
+}
+
+void CGifPackedTest::CheckStripPacket()
+{
+	//Specialized and generic handlers must produce the exact same sequence of register writes
+	static const uint32 vertexCount = 100;
+	for(uint32 regCount : {3, 4})
+	{
+		uint64 regList = (regCount == 3) ? 0x512 : 0xF512;
+		CGSHandler::RegisterWriteList writes[2];
+		for(uint32 specialized = 0; specialized < 2; specialized++)
+		{
+			GIF_TEST_CONTEXT context(specialized != 0);
+			uint32 end = BuildStripPacket(context.ram.get(), 0, vertexCount, regList, regCount);
+			uint32 processed = context.gif.ProcessSinglePacket(context.ram.get(), PS2::EE_RAM_SIZE, 0, end, CGsPacketMetadata(3));
+			TEST_VERIFY(processed == end);
+			TEST_VERIFY(context.gif.GetActivePath() == 0);
+			TEST_VERIFY(context.GetGsRegister(GS_REG_XYZ2) == GetExpectedXyz2(vertexCount - 1));
+			TEST_VERIFY(context.GetGsRegister(GS_REG_RGBAQ) == GetExpectedRgbaq(vertexCount - 1));
+			writes[specialized] = context.GetGsWrites();
+		}
+		//PRIM, then ST, RGBAQ and XYZ2 for each vertex (NOPs don't write anything)
+		TEST_VERIFY(writes[0].size() == (1 + (vertexCount * 3)));
+		TEST_VERIFY(writes[0] == writes[1]);
+	}
+}
+
+void CGifPackedTest::CheckPartialPacket()
+{
+	//Packet is split in the middle of a loop, specialized handler must resume properly
+	static const uint32 vertexCount = 10;
+	CGSHandler::RegisterWriteList writes[2];
+	for(uint32 specialized = 0; specialized < 2; specialized++)
+	{
+		GIF_TEST_CONTEXT context(specialized != 0);
+		uint32 end = BuildStripPacket(context.ram.get(), 0, vertexCount, 0x512, 3);
+		uint32 split = 0x10 + (0x30 * 4) + 0x10;
+		uint32 processed = context.gif.ProcessSinglePacket(context.ram.get(), PS2::EE_RAM_SIZE, 0, split, CGsPacketMetadata(3));
+		TEST_VERIFY(processed == split);
+		TEST_VERIFY(context.gif.GetActivePath() == 3);
+		processed += context.gif.ProcessSinglePacket(context.ram.get(), PS2::EE_RAM_SIZE, split, end, CGsPacketMetadata(3));
+		TEST_VERIFY(processed == end);
+		TEST_VERIFY(context.gif.GetActivePath() == 0);
+		writes[specialized] = context.GetGsWrites();
+	}
+	TEST_VERIFY(writes[0].size() == (1 + (vertexCount * 3)));
+	TEST_VERIFY(writes[0] == writes[1]);
+}
+
+void CGifPackedTest::MeasureThroughput()
+{
+	static const uint32 vertexCount = 0x7000;
+	static const uint32 iterationCount = 50;
+
+	//Both handlers process the same (ST, RGBAQ, XYZ2) packet
+	for(uint32 specialized = 0; specialized < 2; specialized++)
+	{
+		GIF_TEST_CONTEXT context(specialized != 0);
+		context.recorder->recordWrites = false;
+		uint32 end = BuildStripPacket(context.ram.get(), 0, vertexCount, 0x512, 3);
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for(uint32 i = 0; i < iterationCount; i++)
+		{
+			context.gif.ProcessSinglePacket(context.ram.get(), PS2::EE_RAM_SIZE, 0, end, CGsPacketMetadata(3));
+			context.gs->Finish();
+		}
+		context.gs->Finish(true);
+		auto endTime = std::chrono::high_resolution_clock::now();
+
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+		double megabytes = static_cast<double>(end) * iterationCount / (1024.0 * 1024.0);
+		printf("GIF PACKED (%s): %0.2f MB/s\r\n",
+		       specialized ? "specialized" : "generic",
+		       (duration != 0) ? (megabytes * 1000000.0 / static_cast<double>(duration)) : 0.0);
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Test.h"
+
+class CGifPackedTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	void CheckStripPacket();
+	void CheckPartialPacket();
+	void MeasureThroughput();
+};
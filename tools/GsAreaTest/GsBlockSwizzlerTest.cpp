@@ -0,0 +1,268 @@
+#include "GsBlockSwizzlerTest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "gs/GSH_Null.h"
+#include "gs/GsBlockSwizzler.h"
+#include "gs/GsPixelFormats.h"
+
+static uint32 GetTestPixel(uint32 index)
+{
+	uint32 value = (index + 1) * 0x9E3779B1;
+	return value ^ (value >> 15);
+}
+
+//Swizzles a block with the block swizzler and makes sure every pixel ends up where the pixel indexor expects it
+template <typename Storage>
+static void CheckBlock()
+{
+	typedef CGsBlockSwizzler<Storage> Swizzler;
+	static const uint32 bitsPerPixel = Swizzler::BITSPERPIXEL;
+	static const uint32 pixelCount = Storage::BLOCKWIDTH * Storage::BLOCKHEIGHT;
+
+	std::vector<uint8> ram(CGSHandler::RAMSIZE, 0);
+	std::vector<uint8> src(pixelCount * bitsPerPixel / 8, 0);
+	for(uint32 i = 0; i < pixelCount; i++)
+	{
+		uint32 pixel = GetTestPixel(i);
+		if(bitsPerPixel == 4)
+		{
+			src[i / 2] |= (pixel & 0x0F) << ((i & 1) * 4);
+		}
+		else
+		{
+			memcpy(src.data() + (i * bitsPerPixel / 8), &pixel, bitsPerPixel / 8);
+		}
+	}
+
+	//Use the last block of the first page to make sure block offsets are handled properly
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(ram.data(), 0, 1);
+	uint32 blockX = Storage::PAGEWIDTH - Storage::BLOCKWIDTH;
+	uint32 blockY = Storage::PAGEHEIGHT - Storage::BLOCKHEIGHT;
+	uint32 columnX = blockX;
+	uint32 columnY = blockY;
+	uint8* block = ram.data() + indexor.GetColumnAddress(columnX, columnY);
+
+	Swizzler::WriteBlock(block, src.data(), Storage::BLOCKWIDTH);
+	for(uint32 y = 0; y < Storage::BLOCKHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::BLOCKWIDTH; x++)
+		{
+			uint32 pixelIndex = x + (y * Storage::BLOCKWIDTH);
+			uint32 expected = GetTestPixel(pixelIndex) & ((bitsPerPixel == 32) ? ~0U : ((1 << bitsPerPixel) - 1));
+			TEST_VERIFY(indexor.GetPixel(blockX + x, blockY + y) == expected);
+		}
+	}
+
+	std::vector<uint8> dst(src.size(), 0);
+	Swizzler::ReadBlock(dst.data(), Storage::BLOCKWIDTH, block);
+	TEST_VERIFY(dst == src);
+}
+
+struct SWIZZLER_TEST_CONTEXT
+{
+	SWIZZLER_TEST_CONTEXT()
+	{
+		gs = new CGSH_Null();
+		gs->Initialize();
+		gs->Reset();
+		gs->Finish(true);
+		memset(gs->GetRam(), 0xA5, CGSHandler::RAMSIZE);
+	}
+
+	~SWIZZLER_TEST_CONTEXT()
+	{
+		gs->Release();
+		delete gs;
+	}
+
+	void BeginTransfer(uint32 psm, uint32 bufWidth, uint32 trxDir, uint32 x, uint32 y, uint32 width, uint32 height)
+	{
+		auto bltBuf = make_convertible<CGSHandler::BITBLTBUF>(0);
+		bltBuf.nSrcPsm = psm;
+		bltBuf.nSrcWidth = bufWidth / 0x40;
+		bltBuf.nDstPsm = psm;
+		bltBuf.nDstWidth = bufWidth / 0x40;
+
+		auto trxPos = make_convertible<CGSHandler::TRXPOS>(0);
+		trxPos.nSSAX = x;
+		trxPos.nSSAY = y;
+		trxPos.nDSAX = x;
+		trxPos.nDSAY = y;
+
+		auto trxReg = make_convertible<CGSHandler::TRXREG>(0);
+		trxReg.nRRW = width;
+		trxReg.nRRH = height;
+
+		gs->WriteRegister(CGSHandler::RegisterWrite(GS_REG_BITBLTBUF, bltBuf));
+		gs->WriteRegister(CGSHandler::RegisterWrite(GS_REG_TRXPOS, trxPos));
+		gs->WriteRegister(CGSHandler::RegisterWrite(GS_REG_TRXREG, trxReg));
+		gs->WriteRegister(CGSHandler::RegisterWrite(GS_REG_TRXDIR, trxDir));
+		gs->ProcessWriteBuffer(nullptr);
+	}
+
+	CGSHandler* gs = nullptr;
+};
+
+//Transfers an area through the GS and makes sure the result matches a pixel per pixel transfer
+template <typename Storage>
+static void CheckTransfer(uint32 psm, uint32 srcBitsPerPixel, uint32 shift, uint32 x, uint32 y, uint32 width, uint32 height, bool checkRead)
+{
+	static const uint32 chunkSizes[] = {0x30, 0x4020, 0x390, 0x2010};
+
+	uint32 bufWidth = Storage::PAGEWIDTH * 2;
+	uint32 pixelCount = width * height;
+	uint32 pixelMask = (srcBitsPerPixel == 32) ? ~0U : ((1 << srcBitsPerPixel) - 1);
+	uint32 dataSize = ((pixelCount * srcBitsPerPixel / 8) + 0xF) & ~0xF;
+
+	std::vector<uint8> src(dataSize, 0);
+	for(uint32 i = 0; i < pixelCount; i++)
+	{
+		uint32 pixel = GetTestPixel(i);
+		if(srcBitsPerPixel == 4)
+		{
+			src[i / 2] |= (pixel & 0x0F) << ((i & 1) * 4);
+		}
+		else
+		{
+			memcpy(src.data() + (i * srcBitsPerPixel / 8), &pixel, srcBitsPerPixel / 8);
+		}
+	}
+
+	SWIZZLER_TEST_CONTEXT context;
+	context.BeginTransfer(psm, bufWidth, 0, x, y, width, height);
+	for(uint32 offset = 0, chunkIndex = 0; offset < dataSize; chunkIndex++)
+	{
+		uint32 chunkSize = std::min<uint32>(chunkSizes[chunkIndex % 4], dataSize - offset);
+		context.gs->FeedImageData(src.data() + offset, chunkSize);
+		offset += chunkSize;
+	}
+	context.gs->Finish(true);
+
+	uint32 unitMask = (sizeof(typename Storage::Unit) == 4) ? ~0U : ((1 << (sizeof(typename Storage::Unit) * 8)) - 1);
+	uint32 writeMask = (pixelMask << shift) & unitMask;
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(context.gs->GetRam(), 0, bufWidth / 0x40);
+	for(uint32 i = 0; i < pixelCount; i++)
+	{
+		uint32 pixel = indexor.GetPixel(x + (i % width), y + (i / width));
+		uint32 expected = (0xA5A5A5A5 & ~writeMask) | ((GetTestPixel(i) & pixelMask) << shift);
+		if(psm == CGSHandler::PSMT4) expected &= 0x0F;
+		TEST_VERIFY(pixel == (expected & unitMask));
+	}
+
+	if(checkRead)
+	{
+		std::vector<uint8> dst(dataSize, 0);
+		context.BeginTransfer(psm, bufWidth, 1, x, y, width, height);
+		context.gs->ReadImageData(dst.data(), dataSize);
+		TEST_VERIFY(dst == src);
+	}
+}
+
+void CGsBlockSwizzlerTest::Execute()
+{
+	CheckBlocks();
+	CheckTransfers();
+	MeasureThroughput();
+}
+
+void CGsBlockSwizzlerTest::CheckBlocks()
+{
+	CheckBlock<CGsPixelFormats::STORAGEPSMCT32>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMCT16>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMCT16S>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMZ32>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMZ16>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMZ16S>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMT8>();
+	CheckBlock<CGsPixelFormats::STORAGEPSMT4>();
+}
+
+void CGsBlockSwizzlerTest::CheckTransfers()
+{
+	//Block aligned transfers (with a partial row of blocks at the end) go through block swizzlers,
+	//unaligned ones use the pixel per pixel path. Both must give the same result.
+	for(bool aligned : {true, false})
+	{
+		uint32 x = aligned ? 16 : 3;
+		uint32 y = aligned ? 8 : 1;
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT32>(CGSHandler::PSMCT32, 32, 0, x, y, 64, 43, true);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT32>(CGSHandler::PSMCT24, 24, 0, x, y, 64, 44, false);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT16>(CGSHandler::PSMCT16, 16, 0, x, y, 64, 44, true);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT16S>(CGSHandler::PSMCT16S, 16, 0, x, y, 64, 44, false);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMT8>(CGSHandler::PSMT8, 8, 0, x * 2, y * 2, 128, 52, true);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMT4>(CGSHandler::PSMT4, 4, 0, x * 2, y * 2, 128, 52, false);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT32>(CGSHandler::PSMT8H, 8, 24, x, y, 64, 44, false);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT32>(CGSHandler::PSMT4HL, 4, 24, x, y, 64, 44, false);
+		CheckTransfer<CGsPixelFormats::STORAGEPSMCT32>(CGSHandler::PSMT4HH, 4, 28, x, y, 64, 44, false);
+	}
+}
+
+template <typename Storage>
+static void MeasureStorageThroughput(const char* name)
+{
+	typedef CGsBlockSwizzler<Storage> Swizzler;
+	static const uint32 iterationCount = 200;
+	static const uint32 width = Storage::PAGEWIDTH * 4;
+	static const uint32 height = Storage::PAGEHEIGHT * 4;
+	static const uint32 areaSize = width * height * Swizzler::BITSPERPIXEL / 8;
+
+	std::vector<uint8> ram(CGSHandler::RAMSIZE, 0);
+	std::vector<uint8> src(areaSize, 0x5A);
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(ram.data(), 0, width / 0x40);
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+	for(uint32 i = 0; i < iterationCount; i++)
+	{
+		for(uint32 y = 0; y < height; y++)
+		{
+			for(uint32 x = 0; x < width; x++)
+			{
+				uint32 pixelIndex = x + (y * width);
+				if(Swizzler::BITSPERPIXEL == 4)
+				{
+					indexor.SetPixel(x, y, (src[pixelIndex / 2] >> ((pixelIndex & 1) * 4)) & 0x0F);
+				}
+				else
+				{
+					indexor.SetPixel(x, y, reinterpret_cast<const typename Storage::Unit*>(src.data())[pixelIndex]);
+				}
+			}
+		}
+	}
+	auto midTime = std::chrono::high_resolution_clock::now();
+	for(uint32 i = 0; i < iterationCount; i++)
+	{
+		for(uint32 blockY = 0; blockY < height; blockY += Storage::BLOCKHEIGHT)
+		{
+			for(uint32 blockX = 0; blockX < width; blockX += Storage::BLOCKWIDTH)
+			{
+				uint32 x = blockX;
+				uint32 y = blockY;
+				uint8* block = ram.data() + indexor.GetColumnAddress(x, y);
+				Swizzler::WriteBlock(block, src.data() + (((blockY * width) + blockX) * Swizzler::BITSPERPIXEL / 8), width);
+			}
+		}
+	}
+	auto endTime = std::chrono::high_resolution_clock::now();
+
+	auto getThroughput =
+	    [](const auto& start, const auto& end) {
+		    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		    double megabytes = static_cast<double>(areaSize) * iterationCount / (1024.0 * 1024.0);
+		    return (duration != 0) ? (megabytes * 1000000.0 / static_cast<double>(duration)) : 0.0;
+	    };
+
+	printf("Swizzle %s: %0.2f MB/s (pixel), %0.2f MB/s (block)\r\n", name,
+	       getThroughput(startTime, midTime), getThroughput(midTime, endTime));
+}
+
+void CGsBlockSwizzlerTest::MeasureThroughput()
+{
+	MeasureStorageThroughput<CGsPixelFormats::STORAGEPSMCT32>("PSMCT32");
+	MeasureStorageThroughput<CGsPixelFormats::STORAGEPSMCT16>("PSMCT16");
+	MeasureStorageThroughput<CGsPixelFormats::STORAGEPSMT8>("PSMT8");
+	MeasureStorageThroughput<CGsPixelFormats::STORAGEPSMT4>("PSMT4");
+}
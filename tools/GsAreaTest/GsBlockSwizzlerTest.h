@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Test.h"
+
+class CGsBlockSwizzlerTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	void CheckBlocks();
+	void CheckTransfers();
+	void MeasureThroughput();
+};
@@ -1,4 +1,6 @@
 #include <functional>
+#include "GifPackedTest.h"
+#include "GsBlockSwizzlerTest.h"
 #include "GsCachedAreaTest.h"
 #include "GsSpriteRegionTest.h"
 #include "GsTransferInvalidationTest.h"
@@ -8,6 +10,8 @@ typedef std::function<CTest*()> TestFactoryFunction;
 // clang-format off
 static const TestFactoryFunction s_factories[] =
 {
+	[]() { return new CGifPackedTest(); },
+	[]() { return new CGsBlockSwizzlerTest(); },
 	[]() { return new CGsCachedAreaTest(); },
 	[]() { return new CGsSpriteRegionTest(); },
 	[]() { return new CGsTransferInvalidationTest(); }
@@ -0,0 +1,208 @@
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "MemStream.h"
+#include "hdd/ApaReader.h"
+#include "hdd/CachedStream.h"
+#include "hdd/HddDefs.h"
+#include "hdd/PfsReader.h"
+#include "Test.h"
+
+//Synthetic image layout (zone size is 8KB, zone numbers are relative to partition start)
+static const uint32 g_zoneSize = 0x2000;
+static const uint32 g_rootInodeZone = 0x280;
+static const uint32 g_rootDirZone = 0x281;
+static const uint32 g_fileInodeZone = 0x282;
+static const uint32 g_fileDataZone = 0x300;
+static const uint32 g_fileSegmentCount = 4;
+static const uint32 g_fileSegmentZoneCount = 0x80;
+static const uint64 g_fileSize = (g_fileSegmentCount * g_fileSegmentZoneCount * g_zoneSize) - 0x1234;
+static const char* g_partitionName = "__test";
+static const char* g_fileName = "DATA.BIN";
+
+//Counts accesses to the underlying image to make sure caching actually avoids them
+class CCountingStream : public Framework::CMemStream
+{
+public:
+	uint64 Read(void* buffer, uint64 size) override
+	{
+		m_readCount++;
+		return Framework::CMemStream::Read(buffer, size);
+	}
+
+	uint64 m_readCount = 0;
+};
+
+static uint8 GetFileByte(uint64 position)
+{
+	return static_cast<uint8>((position * 7) ^ (position >> 13));
+}
+
+static uint32 GetSegmentZone(uint32 segmentIndex)
+{
+	//Store segments out of order to make sure the reader follows the segment table
+	return g_fileDataZone + ((g_fileSegmentCount - 1 - segmentIndex) * g_fileSegmentZoneCount);
+}
+
+static void WriteAt(Framework::CStream& stream, uint64 position, const void* data, uint64 size)
+{
+	stream.Seek(position, Framework::STREAM_SEEK_SET);
+	stream.Write(data, size);
+}
+
+static void CreateImage(Framework::CStream& stream)
+{
+	uint64 imageSize = static_cast<uint64>(GetSegmentZone(0) + g_fileSegmentZoneCount) * g_zoneSize;
+	{
+		std::vector<uint8> blank(imageSize, 0);
+		WriteAt(stream, 0, blank.data(), blank.size());
+	}
+
+	{
+		Hdd::APA_HEADER header = {};
+		header.magic = Hdd::APA_HEADER_MAGIC;
+		strcpy(header.id, g_partitionName);
+		header.start = 0;
+		header.length = imageSize / Hdd::g_sectorSize;
+		header.type = Hdd::APA_HEADER::TYPE_PFS;
+		WriteAt(stream, 0, &header, sizeof(header));
+	}
+
+	{
+		Hdd::PFS_SUPERBLOCK superBlock = {};
+		superBlock.magic = Hdd::PFS_SUPERBLOCK_MAGIC;
+		superBlock.zoneSize = g_zoneSize;
+		superBlock.rootBlock.number = g_rootInodeZone;
+		WriteAt(stream, Hdd::PFS_SUPERBLOCK_LBA * Hdd::g_sectorSize, &superBlock, sizeof(superBlock));
+	}
+
+	{
+		Hdd::PFS_INODE inode = {};
+		inode.magic = Hdd::PFS_INODE_SEGDESC_DIRECT_MAGIC;
+		inode.mode = 0x1000;
+		inode.dataCount = 2;
+		inode.data[1].number = g_rootDirZone;
+		inode.data[1].count = 1;
+		WriteAt(stream, g_rootInodeZone * g_zoneSize, &inode, sizeof(inode));
+	}
+
+	{
+		uint8 dirBlock[Hdd::g_sectorSize << Hdd::PFS_BLOCK_SCALE] = {};
+		auto dirEntry = reinterpret_cast<Hdd::PFS_DIRENTRY*>(dirBlock);
+		dirEntry->inode = g_fileInodeZone;
+		dirEntry->pathLength = strlen(g_fileName);
+		dirEntry->allocatedLength = (sizeof(Hdd::PFS_DIRENTRY) + dirEntry->pathLength + 3) & ~3;
+		memcpy(dirBlock + sizeof(Hdd::PFS_DIRENTRY), g_fileName, dirEntry->pathLength);
+		WriteAt(stream, g_rootDirZone * g_zoneSize, dirBlock, sizeof(dirBlock));
+	}
+
+	{
+		Hdd::PFS_INODE inode = {};
+		inode.magic = Hdd::PFS_INODE_SEGDESC_DIRECT_MAGIC;
+		inode.mode = 0x2000;
+		inode.size = g_fileSize;
+		inode.dataCount = g_fileSegmentCount + 1;
+		for(uint32 i = 0; i < g_fileSegmentCount; i++)
+		{
+			inode.data[i + 1].number = GetSegmentZone(i);
+			inode.data[i + 1].count = g_fileSegmentZoneCount;
+		}
+		WriteAt(stream, g_fileInodeZone * g_zoneSize, &inode, sizeof(inode));
+	}
+
+	{
+		uint64 segmentSize = g_fileSegmentZoneCount * g_zoneSize;
+		std::vector<uint8> segment(segmentSize);
+		for(uint32 i = 0; i < g_fileSegmentCount; i++)
+		{
+			for(uint64 j = 0; j < segmentSize; j++)
+			{
+				segment[j] = GetFileByte((i * segmentSize) + j);
+			}
+			WriteAt(stream, static_cast<uint64>(GetSegmentZone(i)) * g_zoneSize, segment.data(), segment.size());
+		}
+	}
+}
+
+//Reads the whole file in small chunks (as games usually do) and returns elapsed time in seconds
+static double ReadFile(Framework::CStream& imageStream, uint32 readSize)
+{
+	Hdd::APA_HEADER partitionHeader = {};
+	Hdd::CApaReader apaReader(imageStream);
+	TEST_VERIFY(apaReader.TryFindPartition(g_partitionName, partitionHeader));
+
+	Hdd::CPfsReader pfsReader(imageStream, partitionHeader);
+	std::unique_ptr<Framework::CStream> fileStream(pfsReader.GetFileStream("/DATA.BIN"));
+	TEST_VERIFY(fileStream);
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::vector<uint8> buffer(readSize);
+	uint64 position = 0;
+	while(true)
+	{
+		uint64 amountRead = fileStream->Read(buffer.data(), readSize);
+		if(amountRead == 0) break;
+		for(uint64 i = 0; i < amountRead; i++)
+		{
+			TEST_VERIFY(buffer[i] == GetFileByte(position + i));
+		}
+		position += amountRead;
+	}
+	TEST_VERIFY(position == g_fileSize);
+	TEST_VERIFY(fileStream->IsEOF());
+
+	//Random access across segment boundaries
+	uint64 segmentSize = g_fileSegmentZoneCount * g_zoneSize;
+	for(uint32 i = 1; i < g_fileSegmentCount; i++)
+	{
+		uint64 seekPosition = (i * segmentSize) - 0x10;
+		uint8 data[0x20];
+		fileStream->Seek(seekPosition, Framework::STREAM_SEEK_SET);
+		TEST_VERIFY(fileStream->Read(data, sizeof(data)) == sizeof(data));
+		for(uint32 j = 0; j < sizeof(data); j++)
+		{
+			TEST_VERIFY(data[j] == GetFileByte(seekPosition + j));
+		}
+	}
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+int main(int argc, const char** argv)
+{
+	try
+	{
+		static const uint32 readSize = 0x800;
+		static const double fileSizeMb = static_cast<double>(g_fileSize) / (1024 * 1024);
+
+		auto imageStream = std::make_unique<CCountingStream>();
+		CreateImage(*imageStream);
+		auto baseStream = imageStream.get();
+
+		baseStream->m_readCount = 0;
+		double directTime = ReadFile(*baseStream, readSize);
+		uint64 directReadCount = baseStream->m_readCount;
+
+		Hdd::CCachedStream cachedStream(std::move(imageStream));
+		baseStream->m_readCount = 0;
+		double cachedTime = ReadFile(cachedStream, readSize);
+		uint64 cachedReadCount = baseStream->m_readCount;
+
+		printf("Direct: %0.2f MB/s, %llu image reads.\r\n", fileSizeMb / directTime, static_cast<unsigned long long>(directReadCount));
+		printf("Cached: %0.2f MB/s, %llu image reads (%llu hits, %llu misses).\r\n", fileSizeMb / cachedTime, static_cast<unsigned long long>(cachedReadCount),
+		       static_cast<unsigned long long>(cachedStream.GetHitCount()), static_cast<unsigned long long>(cachedStream.GetMissCount()));
+
+		TEST_VERIFY(cachedReadCount < directReadCount);
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Failed: %s\r\n", exception.what());
+		return -1;
+	}
+	return 0;
+}
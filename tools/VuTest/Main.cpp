@@ -16,6 +16,7 @@
 #include "IntBranchDelayTest3.h"
 #include "MinMaxTest.h"
 #include "MinMaxFlagsTest.h"
+#include "ProgramCacheTest.h"
 #include "StallTest.h"
 #include "StallTest2.h"
 #include "StallTest3.h"
@@ -43,6 +44,7 @@ static const TestFactoryFunction s_factories[] =
 	[]() { return new CIntBranchDelayTest3(); },
 	[]() { return new CMinMaxTest(); },
 	[]() { return new CMinMaxFlagsTest(); },
+	[]() { return new CProgramCacheTest(); },
 	[]() { return new CStallTest(); },
 	[]() { return new CStallTest2(); },
 	[]() { return new CStallTest3(); },
@@ -0,0 +1,103 @@
+#include "ProgramCacheTest.h"
+#include <vector>
+#include "VuAssembler.h"
+#include "Ps2Const.h"
+
+static uint32 AssembleProgram(uint32* microMem, uint16 value)
+{
+	CVuAssembler assembler(microMem);
+
+	auto branchLabel = assembler.CreateLabel();
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP(),
+	    CVuAssembler::Lower::IADDIU(CVuAssembler::VI8, CVuAssembler::VI0, value));
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP(),
+	    CVuAssembler::Lower::IBNE(CVuAssembler::VI2, CVuAssembler::VI0, branchLabel));
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP(),
+	    CVuAssembler::Lower::NOP());
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP() | CVuAssembler::Upper::E_BIT,
+	    CVuAssembler::Lower::IADDIU(CVuAssembler::VI9, CVuAssembler::VI0, 2));
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP(),
+	    CVuAssembler::Lower::NOP());
+
+	assembler.MarkLabel(branchLabel);
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP() | CVuAssembler::Upper::E_BIT,
+	    CVuAssembler::Lower::IADDIU(CVuAssembler::VI9, CVuAssembler::VI0, 4));
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP(),
+	    CVuAssembler::Lower::NOP());
+
+	return assembler.GetProgramSize() * CVuAssembler::INSTRUCTION_SIZE;
+}
+
+void CProgramCacheTest::Execute(CTestVm& virtualMachine)
+{
+	virtualMachine.Reset();
+
+	//Build two programs that only differ by one instruction
+	std::vector<uint8> programA(PS2::MICROMEM1SIZE, 0);
+	std::vector<uint8> programB(PS2::MICROMEM1SIZE, 0);
+	uint32 programSize = AssembleProgram(reinterpret_cast<uint32*>(programA.data()), 1);
+	AssembleProgram(reinterpret_cast<uint32*>(programB.data()), 3);
+
+	auto uploadProgram =
+	    [&](const std::vector<uint8>& program) {
+		    virtualMachine.m_executor.ClearActiveBlocksInRange(0, programSize, false);
+		    memcpy(virtualMachine.m_microMem, program.data(), programSize);
+	    };
+
+	auto runProgram =
+	    [&](uint32 branchCondition) {
+		    virtualMachine.m_cpu.m_State.nCOP2VI[2] = branchCondition;
+		    virtualMachine.m_cpu.m_State.nCOP2VI[8] = 0;
+		    virtualMachine.m_cpu.m_State.nCOP2VI[9] = 0;
+		    virtualMachine.ExecuteTest(0);
+	    };
+
+	uploadProgram(programA);
+	runProgram(0);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[8] == 1);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[9] == 2);
+
+	//Both paths were compiled with the first run, taking the branch must not compile anything
+	auto stats = virtualMachine.m_executor.GetProgramCacheStats();
+	TEST_VERIFY(stats.programMisses == 1);
+	uint32 programABlockCompiles = stats.blockCompiles;
+
+	runProgram(1);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[8] == 1);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[9] == 4);
+	stats = virtualMachine.m_executor.GetProgramCacheStats();
+	TEST_VERIFY(stats.programMisses == 1);
+	TEST_VERIFY(stats.blockCompiles == programABlockCompiles);
+
+	uploadProgram(programB);
+	runProgram(0);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[8] == 3);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[9] == 2);
+	stats = virtualMachine.m_executor.GetProgramCacheStats();
+	TEST_VERIFY(stats.programMisses == 2);
+	uint32 programBBlockCompiles = stats.blockCompiles;
+
+	//Uploading program A again must reuse everything that was compiled for it
+	uploadProgram(programA);
+	runProgram(1);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[8] == 1);
+	TEST_VERIFY(virtualMachine.m_cpu.m_State.nCOP2VI[9] == 4);
+	stats = virtualMachine.m_executor.GetProgramCacheStats();
+	TEST_VERIFY(stats.programHits == 1);
+	TEST_VERIFY(stats.programMisses == 2);
+	TEST_VERIFY(stats.blockCompiles == programBBlockCompiles);
+}
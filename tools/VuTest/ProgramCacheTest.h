@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Test.h"
+
+class CProgramCacheTest : public CTest
+{
+public:
+	void Execute(CTestVm&) override;
+};